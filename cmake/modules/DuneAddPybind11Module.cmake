@@ -45,10 +45,64 @@
 #       Example: Write CMAKE_GUARD dune-foo_FOUND if you want your module to only
 #       build when the dune-foo module is present.
 #
+#    .. cmake_param:: PRECOMPILE_HEADERS
+#       :multi:
+#       :argname: header
+#
+#       Headers to precompile for this module, see :code:`target_precompile_headers`.
+#
+#    .. cmake_param:: REUSE_PRECOMPILE_HEADERS_FROM
+#       :single:
+#       :argname: target
+#
+#       Reuse the precompiled headers of another target, e.g. one created by
+#       :ref:`dune_add_pybind11_precompiled_headers`. If neither this nor
+#       :code:`PRECOMPILE_HEADERS` is given, the target stored in the variable
+#       :code:`DUNE_PYBIND11_PRECOMPILE_HEADERS_TARGET` is used if set.
+#
+#    .. cmake_param:: UNITY_BUILD
+#       :option:
+#
+#       Combine the source files of this module into unity translation units.
+#
+# .. cmake_function:: dune_add_pybind11_precompiled_headers
+#
+#    .. cmake_param:: NAME
+#       :required:
+#       :single:
+#
+#       name of the target holding the precompiled headers
+#
+#    .. cmake_param:: HEADERS
+#       :multi:
+#
+#       headers to precompile, defaults to :code:`DUNE_PYBIND11_DEFAULT_PRECOMPILE_HEADERS`,
+#       i.e., config.h, the pybind11 headers and the common dune-python headers.
+#
+#    Create a target that precompiles headers included by many pybind11
+#    modules. The target is compiled with the same flags as modules created by
+#    :ref:`dune_add_pybind11_module`, so that these can reuse the precompiled
+#    headers with :code:`REUSE_PRECOMPILE_HEADERS_FROM`.
+#
 include_guard(GLOBAL)
 
+# headers included by (almost) all generated Python modules
+set(DUNE_PYBIND11_DEFAULT_PRECOMPILE_HEADERS
+  "<config.h>"
+  "<dune/python/pybind11/pybind11.h>"
+  "<dune/python/pybind11/stl.h>"
+  "<dune/python/pybind11/numpy.h>"
+  "<dune/python/common/typeregistry.hh>"
+  "<dune/python/common/fvector.hh>"
+  "<dune/python/common/fmatrix.hh>"
+  "<dune/common/fvector.hh>"
+  "<dune/common/fmatrix.hh>"
+  "<dune/common/dynvector.hh>"
+  "<dune/common/dynmatrix.hh>")
+
 function(dune_add_pybind11_module)
-  cmake_parse_arguments(PYBIND11_MODULE "EXCLUDE_FROM_ALL" "NAME" "SOURCES;COMPILE_DEFINITIONS;CMAKE_GUARD" ${ARGN})
+  cmake_parse_arguments(PYBIND11_MODULE "EXCLUDE_FROM_ALL;UNITY_BUILD" "NAME;REUSE_PRECOMPILE_HEADERS_FROM"
+    "SOURCES;COMPILE_DEFINITIONS;CMAKE_GUARD;PRECOMPILE_HEADERS" ${ARGN})
   if(PYBIND11_MODULE_UNPARSED_ARGUMENTS)
     message(WARNING "dune_add_pybind11_module: extra arguments provided (typos in named arguments?)")
   endif()
@@ -86,12 +140,56 @@ function(dune_add_pybind11_module)
   target_link_libraries(${PYBIND11_MODULE_NAME} PUBLIC Dune::Common Python3::Module)
   dune_target_enable_all_packages(${PYBIND11_MODULE_NAME})
 
+  if(PYBIND11_MODULE_PRECOMPILE_HEADERS)
+    target_precompile_headers(${PYBIND11_MODULE_NAME} PRIVATE ${PYBIND11_MODULE_PRECOMPILE_HEADERS})
+  elseif(PYBIND11_MODULE_REUSE_PRECOMPILE_HEADERS_FROM)
+    target_precompile_headers(${PYBIND11_MODULE_NAME} REUSE_FROM ${PYBIND11_MODULE_REUSE_PRECOMPILE_HEADERS_FROM})
+  elseif(DUNE_PYBIND11_PRECOMPILE_HEADERS_TARGET AND
+         NOT PYBIND11_MODULE_NAME STREQUAL DUNE_PYBIND11_PRECOMPILE_HEADERS_TARGET)
+    target_precompile_headers(${PYBIND11_MODULE_NAME} REUSE_FROM ${DUNE_PYBIND11_PRECOMPILE_HEADERS_TARGET})
+  endif()
+
+  if(PYBIND11_MODULE_UNITY_BUILD)
+    set_property(TARGET ${PYBIND11_MODULE_NAME} PROPERTY UNITY_BUILD ON)
+  endif()
+
   if(PYBIND11_MODULE_EXCLUDE_FROM_ALL)
     set_property(TARGET ${PYBIND11_MODULE_NAME} PROPERTY EXCLUDE_FROM_ALL 1)
   endif()
 endfunction()
 
 
+## add a target holding precompiled headers to be reused by pybind11 modules
+function(dune_add_pybind11_precompiled_headers)
+  cmake_parse_arguments(PYBIND11_PCH "" "NAME" "HEADERS" ${ARGN})
+  if(PYBIND11_PCH_UNPARSED_ARGUMENTS)
+    message(WARNING "dune_add_pybind11_precompiled_headers: extra arguments provided (typos in named arguments?)")
+  endif()
+
+  if(NOT PYBIND11_PCH_NAME)
+    message(FATAL_ERROR "dune_add_pybind11_precompiled_headers: target name not specified")
+  endif()
+
+  if(NOT PYBIND11_PCH_HEADERS)
+    set(PYBIND11_PCH_HEADERS ${DUNE_PYBIND11_DEFAULT_PRECOMPILE_HEADERS})
+  endif()
+
+  # the precompiled headers are built together with an otherwise empty module
+  set(source ${CMAKE_CURRENT_BINARY_DIR}/${PYBIND11_PCH_NAME}.cc)
+  if(NOT EXISTS ${source})
+    file(WRITE ${source} "// precompiled headers for pybind11 modules, see dune_add_pybind11_precompiled_headers\n")
+  endif()
+
+  # use an object library: the <name>_EXPORTS definition of a shared library
+  # would make the precompiled headers incompatible with all other modules
+  add_library(${PYBIND11_PCH_NAME} OBJECT EXCLUDE_FROM_ALL ${source})
+  set_target_properties(${PYBIND11_PCH_NAME} PROPERTIES POSITION_INDEPENDENT_CODE ON)
+  target_link_libraries(${PYBIND11_PCH_NAME} PUBLIC Dune::Common Python3::Module)
+  dune_target_enable_all_packages(${PYBIND11_PCH_NAME})
+  target_precompile_headers(${PYBIND11_PCH_NAME} PRIVATE ${PYBIND11_PCH_HEADERS})
+endfunction()
+
+
 ## add a submodule for a pybind11 module
 function(dune_add_pybind11_submodule)
   cmake_parse_arguments(PYBIND11_SUBMODULE "EXCLUDE_FROM_ALL" "MODULE;NAME" "SOURCES;COMPILE_DEFINITIONS;CMAKE_GUARD" ${ARGN})
@@ -6,11 +6,16 @@
 #ifndef DUNE_COMMON_ARRAYLIST_HH
 #define DUNE_COMMON_ARRAYLIST_HH
 
+#include <algorithm>
 #include <array>
 #include <cassert>
+#include <iterator>
 #include <memory>
+#include <ranges>
+#include <span>
 #include <vector>
 #include "iteratorfacades.hh"
+#include "iteratorrange.hh"
 
 namespace Dune
 {
@@ -56,6 +61,12 @@ namespace Dune
    * but our push_back method leaves all iterators valid.
    * - Additional functionality lets one delete entries before and at an
    * iterator while moving the iterator to the next valid position.
+   *
+   * Each access through an index or an iterator has to look up the chunk
+   * of the element. Loops over many elements should therefore iterate over
+   * the contiguous segments of the list with forEachSegment() or segment(),
+   * and parallel loops can distribute the list with split() into ranges
+   * that start and end at chunk boundaries.
    */
   template<class T, int N=100, class A=std::allocator<T> >
   class ArrayList
@@ -96,6 +107,9 @@ namespace Dune
     /**
      * @brief The number of elements in one chunk of the list.
      * This has to be at least one. The default is 100.
+     *
+     * If the chunk size is a power of two, finding the chunk of an
+     * element needs a shift instead of a division.
      */
     constexpr static int chunkSize_ = (N > 0) ? N : 1;
 
@@ -150,6 +164,115 @@ namespace Dune
      */
     inline void push_back(const_reference entry);
 
+    /**
+     * @brief Append the entries of the range [first,last) to the list.
+     *
+     * The entries are copied chunk by chunk. If the size of the range
+     * can be computed in advance, all chunks needed are allocated first.
+     * @param first Iterator to the first entry to append.
+     * @param last Iterator or sentinel after the last entry to append.
+     */
+    template<class InputIterator, class Sentinel>
+    void append(InputIterator first, Sentinel last);
+
+    /**
+     * @brief Append all entries of a range to the list.
+     * @param range The range of entries, e.g. a std::vector or another ArrayList.
+     */
+    template<std::ranges::input_range Range>
+    void append(const Range& range)
+    {
+      append(std::ranges::begin(range), std::ranges::end(range));
+    }
+
+    /**
+     * @brief Allocate chunks for at least n entries.
+     *
+     * Afterwards n entries can be appended without allocating memory.
+     * @param n The number of entries.
+     */
+    void reserve(size_type n);
+
+    /**
+     * @brief Get the number of contiguous segments of the list.
+     *
+     * The entries of a segment are stored consecutively in memory. Each
+     * segment belongs to a different chunk, only the first and the last
+     * segment may be shorter than the chunk size.
+     */
+    inline size_type segmentCount() const;
+
+    /**
+     * @brief Get the k-th contiguous segment of the list.
+     * @param k The index of the segment, smaller than segmentCount().
+     */
+    inline std::span<MemberType> segment(size_type k);
+
+    /**
+     * @brief Get the k-th contiguous segment of the list.
+     * @param k The index of the segment, smaller than segmentCount().
+     */
+    inline std::span<const MemberType> segment(size_type k) const;
+
+    /**
+     * @brief Call f with every contiguous segment of the list.
+     *
+     * The segments are passed in order as std::span<MemberType>, so
+     * the inner loop over the entries of a segment does not need to look
+     * up the chunk of every entry.
+     * @param f The function called with each segment.
+     */
+    template<class F>
+    void forEachSegment(F&& f);
+
+    /**
+     * @brief Call f with every contiguous segment of the list.
+     * @param f The function called with each segment as std::span<const MemberType>.
+     */
+    template<class F>
+    void forEachSegment(F&& f) const;
+
+    /**
+     * @brief Call f with every contiguous segment of the range [first,last).
+     * @param first Iterator to the first entry of this list to visit.
+     * @param last Iterator after the last entry of this list to visit.
+     * @param f The function called with each segment.
+     */
+    template<class F>
+    void forEachSegment(const iterator& first, const iterator& last, F&& f);
+
+    /**
+     * @brief Call f with every contiguous segment of the range [first,last).
+     * @param first Iterator to the first entry of this list to visit.
+     * @param last Iterator after the last entry of this list to visit.
+     * @param f The function called with each segment as std::span<const MemberType>.
+     */
+    template<class F>
+    void forEachSegment(const const_iterator& first, const const_iterator& last, F&& f) const;
+
+    /**
+     * @brief Get one of several parts of the list for parallel traversal.
+     *
+     * Splits the list into the given number of consecutive ranges of about
+     * equal size. The ranges start and end at chunk boundaries, so that
+     * different threads never work on the same chunk. Together the parts
+     * cover the list, some of them are empty if there are more parts than
+     * chunks.
+     * @param part The index of the part, smaller than parts.
+     * @param parts The number of parts.
+     * @return The range of the part.
+     */
+    IteratorRange<iterator> split(size_type part, size_type parts);
+
+    /**
+     * @brief Get one of several parts of the list for parallel traversal.
+     * @param part The index of the part, smaller than parts.
+     * @param parts The number of parts.
+     * @return The range of the part.
+     * @see split(size_type,size_type)
+     */
+    IteratorRange<const_iterator> split(size_type part, size_type parts) const;
+
     /**
      * @brief Get the element at specific position.
      * @param i The index of the position.
@@ -222,6 +345,21 @@ namespace Dune
     size_type size_;
     /** @brief The index of the first entry. */
     size_type start_;
+
+    /**
+     * @brief Call f with every contiguous segment between the indices begin and end.
+     *
+     * Index 0 refers to the first entry in the list whether it is erased or not.
+     */
+    template<class List, class F>
+    static void forEachSegmentBetween(List& list, size_type begin, size_type end, F&& f);
+
+    /**
+     * @brief Get the index of the first entry of a part in split().
+     *
+     * Index 0 refers to the first entry in the list whether it is erased or not.
+     */
+    size_type splitPoint(size_type part, size_type parts) const;
     /**
      * @brief Get the element at specific position.
      *
@@ -485,6 +623,141 @@ namespace Dune
     ++size_;
   }
 
+  template<class T, int N, class A>
+  template<class InputIterator, class Sentinel>
+  void ArrayList<T,N,A>::append(InputIterator first, Sentinel last)
+  {
+    if constexpr (std::sized_sentinel_for<Sentinel, InputIterator>)
+      reserve(size_ + (last - first));
+
+    while(first != last)
+    {
+      size_t index=start_+size_;
+      if(index==capacity_)
+      {
+        chunks_.push_back(std::make_shared<std::array<MemberType,chunkSize_> >());
+        capacity_ += chunkSize_;
+      }
+      std::array<MemberType,chunkSize_>& chunk = *chunks_[index/chunkSize_];
+      for(size_t i=index%chunkSize_; i<size_t(chunkSize_) && first != last; ++i, ++first, ++size_)
+        chunk[i]=*first;
+    }
+  }
+
+  template<class T, int N, class A>
+  void ArrayList<T,N,A>::reserve(size_type n)
+  {
+    if(start_+n > capacity_)
+    {
+      chunks_.reserve((start_+n+chunkSize_-1)/chunkSize_);
+      while(capacity_ < start_+n)
+      {
+        chunks_.push_back(std::make_shared<std::array<MemberType,chunkSize_> >());
+        capacity_ += chunkSize_;
+      }
+    }
+  }
+
+  template<class T, int N, class A>
+  typename ArrayList<T,N,A>::size_type ArrayList<T,N,A>::segmentCount() const
+  {
+    if(size_==0)
+      return 0;
+    return (start_+size_-1)/chunkSize_ - start_/chunkSize_ + 1;
+  }
+
+  template<class T, int N, class A>
+  std::span<T> ArrayList<T,N,A>::segment(size_type k)
+  {
+    assert(k < segmentCount());
+    const size_t chunk = start_/chunkSize_ + k;
+    const size_t begin = std::max(start_, chunk*chunkSize_);
+    const size_t end = std::min(start_+size_, (chunk+1)*chunkSize_);
+    return std::span<T>(chunks_[chunk]->data() + begin%chunkSize_, end-begin);
+  }
+
+  template<class T, int N, class A>
+  std::span<const T> ArrayList<T,N,A>::segment(size_type k) const
+  {
+    assert(k < segmentCount());
+    const size_t chunk = start_/chunkSize_ + k;
+    const size_t begin = std::max(start_, chunk*chunkSize_);
+    const size_t end = std::min(start_+size_, (chunk+1)*chunkSize_);
+    return std::span<const T>(chunks_[chunk]->data() + begin%chunkSize_, end-begin);
+  }
+
+  template<class T, int N, class A>
+  template<class List, class F>
+  void ArrayList<T,N,A>::forEachSegmentBetween(List& list, size_type begin, size_type end, F&& f)
+  {
+    using Span = std::conditional_t<std::is_const_v<List>, std::span<const T>, std::span<T> >;
+    while(begin < end)
+    {
+      const size_t chunk = begin/chunkSize_;
+      const size_t segmentEnd = std::min(end, (chunk+1)*chunkSize_);
+      f(Span(list.chunks_[chunk]->data() + begin%chunkSize_, segmentEnd-begin));
+      begin = segmentEnd;
+    }
+  }
+
+  template<class T, int N, class A>
+  template<class F>
+  void ArrayList<T,N,A>::forEachSegment(F&& f)
+  {
+    forEachSegmentBetween(*this, start_, start_+size_, f);
+  }
+
+  template<class T, int N, class A>
+  template<class F>
+  void ArrayList<T,N,A>::forEachSegment(F&& f) const
+  {
+    forEachSegmentBetween(*this, start_, start_+size_, f);
+  }
+
+  template<class T, int N, class A>
+  template<class F>
+  void ArrayList<T,N,A>::forEachSegment(const iterator& first, const iterator& last, F&& f)
+  {
+    assert(first.list_==this && last.list_==this);
+    forEachSegmentBetween(*this, first.position_, last.position_, f);
+  }
+
+  template<class T, int N, class A>
+  template<class F>
+  void ArrayList<T,N,A>::forEachSegment(const const_iterator& first, const const_iterator& last, F&& f) const
+  {
+    assert(first.list_==this && last.list_==this);
+    forEachSegmentBetween(*this, first.position_, last.position_, f);
+  }
+
+  template<class T, int N, class A>
+  typename ArrayList<T,N,A>::size_type ArrayList<T,N,A>::splitPoint(size_type part, size_type parts) const
+  {
+    if(part==0)
+      return start_;
+    if(part==parts)
+      return start_+size_;
+    // Round the ideal split point to the nearest chunk boundary. Rounding
+    // preserves the order, so the parts do not overlap.
+    const size_t ideal = start_ + size_*part/parts;
+    const size_t rounded = (ideal + chunkSize_/2)/chunkSize_*chunkSize_;
+    return std::clamp(rounded, start_, start_+size_);
+  }
+
+  template<class T, int N, class A>
+  IteratorRange<ArrayListIterator<T,N,A> > ArrayList<T,N,A>::split(size_type part, size_type parts)
+  {
+    assert(part < parts);
+    return {iterator(*this, splitPoint(part, parts)), iterator(*this, splitPoint(part+1, parts))};
+  }
+
+  template<class T, int N, class A>
+  IteratorRange<ConstArrayListIterator<T,N,A> > ArrayList<T,N,A>::split(size_type part, size_type parts) const
+  {
+    assert(part < parts);
+    return {const_iterator(*this, splitPoint(part, parts)), const_iterator(*this, splitPoint(part+1, parts))};
+  }
+
   template<class T, int N, class A>
   typename ArrayList<T,N,A>::reference ArrayList<T,N,A>::operator[](size_type i)
   {
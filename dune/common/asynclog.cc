@@ -0,0 +1,229 @@
+// -*- tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 2 -*-
+// vi: set et ts=4 sw=2 sts=2:
+// SPDX-FileCopyrightInfo: Copyright © DUNE Project contributors, see file LICENSE.md in module root
+// SPDX-License-Identifier: LicenseRef-GPL-2.0-only-with-DUNE-exception
+
+#include <cstring>
+#include <fstream>
+
+#include <dune/common/asynclog.hh>
+#include <dune/common/exceptions.hh>
+#include <dune/common/stdstreams.hh>
+
+using namespace Dune;
+
+Impl::LogRingBuffer::LogRingBuffer(std::size_t capacity)
+{
+  std::size_t size = 64;
+  while (size < capacity)
+    size *= 2;
+  data_.resize(size);
+  mask_ = size - 1;
+}
+
+void Impl::LogRingBuffer::write(const char* data, std::size_t size, const std::function<void()>& onFull)
+{
+  bool stalled = false;
+  while (size > 0)
+  {
+    const std::size_t head = head_.load(std::memory_order_relaxed);
+    const std::size_t free = data_.size() - (head - tail_.load(std::memory_order_acquire));
+    if (free == 0)
+    {
+      if (!stalled)
+      {
+        stalled = true;
+        stalls_.fetch_add(1, std::memory_order_relaxed);
+      }
+      onFull();
+      std::this_thread::yield();
+      continue;
+    }
+    const std::size_t n = std::min(free, size);
+    const std::size_t begin = head & mask_;
+    const std::size_t first = std::min(n, data_.size() - begin);
+    std::memcpy(data_.data() + begin, data, first);
+    std::memcpy(data_.data(), data + first, n - first);
+    head_.store(head + n, std::memory_order_release);
+    data += n;
+    size -= n;
+  }
+}
+
+void AsyncLog::StreamBuffer::drain()
+{
+  const std::size_t size = pptr() - pbase();
+  if (size > 0 && log_->buffer_)
+  {
+    Impl::LogRingBuffer& buffer = *log_->buffer_;
+    buffer.write(pbase(), size, log_->wake_);
+    // wake the background thread early if the buffer fills up
+    if (buffer.written() - buffer.consumed() > buffer.capacity() / 2)
+      log_->wake_();
+  }
+  setp(local_, local_ + sizeof(local_));
+}
+
+AsyncLog::StreamBuffer::int_type AsyncLog::StreamBuffer::overflow(int_type c)
+{
+  drain();
+  if (!traits_type::eq_int_type(c, traits_type::eof()))
+  {
+    *pptr() = traits_type::to_char_type(c);
+    pbump(1);
+  }
+  return traits_type::not_eof(c);
+}
+
+std::streamsize AsyncLog::StreamBuffer::xsputn(const char* s, std::streamsize n)
+{
+  if (n > epptr() - pptr())
+  {
+    drain();
+    // long output bypasses the local buffer
+    if (n >= std::streamsize(sizeof(local_)))
+    {
+      if (log_->buffer_)
+        log_->buffer_->write(s, n, log_->wake_);
+      return n;
+    }
+  }
+  std::memcpy(pptr(), s, n);
+  pbump(n);
+  return n;
+}
+
+int AsyncLog::StreamBuffer::sync()
+{
+  drain();
+  return 0;
+}
+
+AsyncLog::AsyncLog(int rank, const Options& options)
+  : rank_(rank)
+  , enabled_(options.ranks.empty()
+             || std::find(options.ranks.begin(), options.ranks.end(), rank) != options.ranks.end())
+  , out_(options.out)
+  , streamBuffer_(this)
+  , stream_(&streamBuffer_)
+  , interval_(options.interval)
+{
+  if (!enabled_)
+    return;
+
+  if (!options.file.empty())
+  {
+    std::string name = options.file;
+    for (auto pos = name.find("%r"); pos != std::string::npos; pos = name.find("%r", pos))
+      name.replace(pos, 2, std::to_string(rank));
+    file_ = std::make_unique<std::ofstream>(name);
+    if (!*file_)
+      DUNE_THROW(IOError, "Could not open log file " << name);
+    out_ = file_.get();
+  }
+  else
+  {
+    prefix_ = '[';
+    prefix_ += std::to_string(rank);
+    prefix_ += "] ";
+  }
+
+  buffer_ = std::make_unique<Impl::LogRingBuffer>(options.bufferSize);
+  wake_ = [this] {
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      pending_ = true;
+    }
+    wakeup_.notify_one();
+  };
+  thread_ = std::thread([this] { run(); });
+}
+
+AsyncLog::~AsyncLog()
+{
+  for (auto it = restore_.rbegin(); it != restore_.rend(); ++it)
+    (*it)();
+  stream_.flush();
+  if (thread_.joinable())
+  {
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      stop_ = true;
+    }
+    wakeup_.notify_one();
+    thread_.join();
+  }
+}
+
+void AsyncLog::attachStandardStreams()
+{
+  attach(dvverb);
+  attach(dverb);
+  attach(dinfo);
+  attach(dwarn);
+  attach(dgrave);
+  // errors of ranks that are filtered out are still written directly
+  if (enabled_)
+    attach(derr);
+}
+
+void AsyncLog::flush()
+{
+  stream_.flush();
+  if (!buffer_)
+    return;
+  const std::size_t target = buffer_->written();
+  std::unique_lock<std::mutex> lock(mutex_);
+  pending_ = true;
+  wakeup_.notify_one();
+  written_.wait(lock, [&] { return buffer_->consumed() >= target && !pending_; });
+}
+
+void AsyncLog::writeOut(const char* data, std::size_t size)
+{
+  if (prefix_.empty())
+  {
+    out_->write(data, size);
+    return;
+  }
+  // prefix every line by the rank
+  for (std::size_t i = 0; i < size; ++i)
+  {
+    if (lineStart_)
+      line_ += prefix_;
+    line_ += data[i];
+    lineStart_ = (data[i] == '\n');
+  }
+}
+
+void AsyncLog::run()
+{
+  std::unique_lock<std::mutex> lock(mutex_);
+  while (true)
+  {
+    wakeup_.wait_for(lock, interval_, [&] { return stop_ || pending_; });
+    const bool stop = stop_;
+    pending_ = false;
+    lock.unlock();
+
+    while (buffer_->read([&](const char* data, std::size_t size) { writeOut(data, size); }) > 0)
+      ;
+    if (!prefix_.empty())
+    {
+      // only complete lines are written to the common stream, so that the
+      // lines of different ranks do not interleave
+      const std::size_t end = stop ? line_.size() : line_.rfind('\n') + 1;
+      if (end > 0)
+      {
+        out_->write(line_.data(), end);
+        line_.erase(0, end);
+      }
+    }
+    out_->flush();
+
+    lock.lock();
+    written_.notify_all();
+    if (stop)
+      break;
+  }
+}
@@ -0,0 +1,278 @@
+// -*- tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 2 -*-
+// vi: set et ts=4 sw=2 sts=2:
+// SPDX-FileCopyrightInfo: Copyright © DUNE Project contributors, see file LICENSE.md in module root
+// SPDX-License-Identifier: LicenseRef-GPL-2.0-only-with-DUNE-exception
+#ifndef DUNE_COMMON_ASYNCLOG_HH
+#define DUNE_COMMON_ASYNCLOG_HH
+
+/** \file
+ * \brief Asynchronous output backend for DebugStream
+ */
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <functional>
+#include <iostream>
+#include <memory>
+#include <mutex>
+#include <ostream>
+#include <streambuf>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <dune/common/debugstream.hh>
+
+namespace Dune {
+
+  /**
+     \addtogroup DebugOut
+     \{
+   */
+
+  namespace Impl {
+
+    /** \brief Lock-free ring buffer of characters for one producer and one consumer
+     *
+     * The producer blocks, yielding its time slice, if the buffer is full.
+     */
+    class LogRingBuffer
+    {
+    public:
+      //! Create a buffer of at least `capacity` characters
+      explicit LogRingBuffer (std::size_t capacity);
+
+      /** \brief Append characters, called by the producer
+       *
+       * If the buffer is full, `onFull()` is called before waiting for free space.
+       */
+      void write (const char* data, std::size_t size, const std::function<void()>& onFull);
+
+      //! Number of characters that fit into the buffer
+      std::size_t capacity () const
+      {
+        return data_.size();
+      }
+
+      /** \brief Pass the readable characters to `f(const char*, std::size_t)`, called by the consumer
+       *
+       * \returns the number of characters read
+       */
+      template<class F>
+      std::size_t read (F&& f)
+      {
+        const std::size_t tail = tail_.load(std::memory_order_relaxed);
+        const std::size_t head = head_.load(std::memory_order_acquire);
+        if (head == tail)
+          return 0;
+        // the readable characters may wrap around the end of the buffer
+        const std::size_t begin = tail & mask_;
+        const std::size_t size = head - tail;
+        const std::size_t first = std::min(size, data_.size() - begin);
+        f(data_.data() + begin, first);
+        if (first < size)
+          f(data_.data(), size - first);
+        tail_.store(head, std::memory_order_release);
+        return size;
+      }
+
+      //! Total number of characters written
+      std::size_t written () const
+      {
+        return head_.load(std::memory_order_acquire);
+      }
+
+      //! Total number of characters read
+      std::size_t consumed () const
+      {
+        return tail_.load(std::memory_order_acquire);
+      }
+
+      //! Number of times the producer had to wait for free space
+      std::size_t stalls () const
+      {
+        return stalls_.load(std::memory_order_relaxed);
+      }
+
+    private:
+      std::vector<char> data_;
+      std::size_t mask_;
+      // positions grow monotonically, the index into data_ is position & mask_
+      alignas(64) std::atomic<std::size_t> head_ = 0;
+      alignas(64) std::atomic<std::size_t> tail_ = 0;
+      std::atomic<std::size_t> stalls_ = 0;
+    };
+
+  } // end namespace Impl
+
+
+  /**
+     \brief Asynchronous, buffered output for DebugStream s
+
+     Output written to an AsyncLog is copied into a lock-free ring buffer
+     and written to its destination by a background thread, so the writing
+     thread does not wait for the file system. This avoids serializing many
+     ranks of a parallel program on the output. Each rank either writes its
+     own file or all ranks write complete lines, prefixed by their rank, to
+     a common stream.
+
+     \code
+     Dune::AsyncLog::Options options;
+     options.file = "log-%r.txt";   // one file per rank
+     options.ranks = {0, 1};        // only these ranks produce output
+     Dune::AsyncLog log(mpihelper.rank(), options);
+     log.attachStandardStreams();
+
+     Dune::dinfo << "written asynchronously" << std::endl;
+     \endcode
+
+     The DebugStream s keep their compile-time level filtering. On ranks
+     that are filtered out, the attached streams are deactivated via push(),
+     so their output is not even formatted. The streams are restored when
+     the AsyncLog is destroyed, which writes all remaining output.
+
+     \note Only one thread must write to the streams attached to an AsyncLog.
+     \note std::endl flushes the stream, which only hands the line over to
+           the background thread. Call flush() of the AsyncLog to wait until
+           the output has been written.
+   */
+  class AsyncLog
+  {
+  public:
+    //! Configuration of an AsyncLog
+    struct Options
+    {
+      /** \brief Name of the file of a rank, "%r" is replaced by the rank
+       *
+       * If empty, the output of all ranks goes to `out` with every line
+       * prefixed by the rank.
+       */
+      std::string file = "";
+
+      //! Common output stream if no file is given
+      std::ostream* out = &std::cerr;
+
+      //! Ranks that produce output, all ranks if empty
+      std::vector<int> ranks = {};
+
+      //! Capacity of the ring buffer in characters
+      std::size_t bufferSize = 1 << 20;
+
+      //! Maximal time between writes of the background thread
+      std::chrono::milliseconds interval = std::chrono::milliseconds(50);
+    };
+
+    //! Create the log of `rank` and start the background thread if the rank produces output
+    explicit AsyncLog (int rank, const Options& options);
+
+    //! Create the log of `rank` with the default options
+    explicit AsyncLog (int rank)
+      : AsyncLog(rank, Options{})
+    {}
+
+    //! Restore the attached streams and write the remaining output
+    ~AsyncLog ();
+
+    AsyncLog (const AsyncLog&) = delete;
+    AsyncLog& operator= (const AsyncLog&) = delete;
+
+    //! Whether this rank produces output
+    bool enabled () const
+    {
+      return enabled_;
+    }
+
+    //! The stream to write to, discards the output if this rank is filtered out
+    std::ostream& stream ()
+    {
+      return stream_;
+    }
+
+    /** \brief Redirect a DebugStream into this log
+     *
+     * If this rank is filtered out, the stream is deactivated instead. The
+     * stream must not be tied and must outlive this log.
+     */
+    template <DebugLevel thislevel, DebugLevel dlevel, DebugLevel alevel,
+              template<DebugLevel, DebugLevel> class activator>
+    void attach (DebugStream<thislevel, dlevel, alevel, activator>& debugStream)
+    {
+      if (enabled_)
+      {
+        debugStream.attach(stream_);
+        restore_.push_back([&debugStream]{ debugStream.detach(); });
+      }
+      else
+      {
+        debugStream.push(false);
+        restore_.push_back([&debugStream]{ debugStream.pop(); });
+      }
+    }
+
+    //! Redirect dvverb, dverb, dinfo, dwarn, dgrave and derr into this log
+    void attachStandardStreams ();
+
+    //! Wait until all output has been written to the destination
+    void flush ();
+
+    //! Number of times the writing thread had to wait because the ring buffer was full
+    std::size_t stalls () const
+    {
+      return buffer_ ? buffer_->stalls() : 0;
+    }
+
+  private:
+    class StreamBuffer : public std::streambuf
+    {
+    public:
+      explicit StreamBuffer (AsyncLog* log)
+        : log_(log)
+      {
+        setp(local_, local_ + sizeof(local_));
+      }
+
+    protected:
+      int_type overflow (int_type c) override;
+      std::streamsize xsputn (const char* s, std::streamsize n) override;
+      int sync () override;
+
+    private:
+      void drain ();
+
+      AsyncLog* log_;
+      char local_[256];
+    };
+
+    void run ();
+    void writeOut (const char* data, std::size_t size);
+
+    int rank_;
+    bool enabled_;
+    std::string prefix_;
+    std::unique_ptr<std::ostream> file_;
+    std::ostream* out_;
+    bool lineStart_ = true;
+    std::unique_ptr<Impl::LogRingBuffer> buffer_;
+    StreamBuffer streamBuffer_;
+    std::ostream stream_;
+    std::vector<std::function<void()>> restore_;
+
+    std::chrono::milliseconds interval_;
+    std::mutex mutex_;
+    std::condition_variable wakeup_;
+    std::condition_variable written_;
+    bool stop_ = false;
+    bool pending_ = false;
+    std::function<void()> wake_;
+    std::string line_;
+    std::thread thread_;
+  };
+
+  /** \} */
+
+} // end namespace Dune
+
+#endif // DUNE_COMMON_ASYNCLOG_HH
@@ -0,0 +1,33 @@
+// -*- tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 2 -*-
+// vi: set et ts=4 sw=2 sts=2:
+// SPDX-FileCopyrightInfo: Copyright © DUNE Project contributors, see file LICENSE.md in module root
+// SPDX-License-Identifier: LicenseRef-GPL-2.0-only-with-DUNE-exception
+#ifndef DUNE_COMMON_BENCHMARK_DONOTOPTIMIZE_HH
+#define DUNE_COMMON_BENCHMARK_DONOTOPTIMIZE_HH
+
+#include <atomic>
+
+namespace Dune::Benchmark {
+
+  /**
+   * @brief Keeps the compiler from optimizing away the computation of a value.
+   *
+   * The value is treated as read by the call, so that the benchmarked code
+   * producing it cannot be removed as dead code, without the cost of a store
+   * to a volatile variable.
+   */
+  template <class T>
+  inline void doNotOptimize (const T& value)
+  {
+#if defined(__GNUC__) || defined(__clang__)
+    asm volatile ("" : : "r,m" (value) : "memory");
+#else
+    static const void* volatile sink;
+    sink = &value;
+    std::atomic_signal_fence(std::memory_order_seq_cst);
+#endif
+  }
+
+} // end namespace Dune::Benchmark
+
+#endif // DUNE_COMMON_BENCHMARK_DONOTOPTIMIZE_HH
@@ -0,0 +1,87 @@
+// -*- tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 2 -*-
+// vi: set et ts=4 sw=2 sts=2:
+// SPDX-FileCopyrightInfo: Copyright © DUNE Project contributors, see file LICENSE.md in module root
+// SPDX-License-Identifier: LicenseRef-GPL-2.0-only-with-DUNE-exception
+
+/**
+ * @brief Benchmark for the cost of throwing and catching exceptions.
+ *
+ * Measures a throw/catch round trip of a plain Dune::MathError, of
+ * DUNE_THROW with its eagerly formatted message and of DUNE_THROW_LAZY,
+ * each without and with reading the message, and the inversion of a
+ * singular FieldMatrix, which signals the failure by an FMatrixError.
+ *
+ * Usage: ./exceptionbenchmark [throws]
+ */
+
+#include <cstddef>
+#include <cstdlib>
+#include <cstring>
+#include <iomanip>
+#include <iostream>
+#include <string>
+
+#include <dune/common/exceptions.hh>
+#include <dune/common/fmatrix.hh>
+#include <dune/common/timer.hh>
+
+#include "donotoptimize.hh"
+
+template <class F>
+double benchmark (std::size_t throws, F&& f)
+{
+  Dune::Timer timer;
+  for (std::size_t i = 0; i < throws; ++i)
+    f(i);
+  return 1e9 * timer.elapsed() / throws;
+}
+
+// not inlined, so that the compiler cannot see the catch block
+[[gnu::noinline]] void throwPlain (std::size_t)
+{
+  throw Dune::MathError();
+}
+
+[[gnu::noinline]] void throwEager (std::size_t i)
+{
+  DUNE_THROW(Dune::MathError, "Newton step " << i << " did not converge, defect " << 1.5);
+}
+
+[[gnu::noinline]] void throwLazy (std::size_t i)
+{
+  DUNE_THROW_LAZY(Dune::MathError, "Newton step " << i << " did not converge, defect " << 1.5);
+}
+
+int main (int argc, char** argv)
+{
+  const std::size_t throws = (argc > 1) ? std::atol(argv[1]) : 200000;
+
+  auto print = [](const std::string& name, double time) {
+    std::cout << std::left << std::setw(28) << name
+              << std::right << std::setw(10) << std::setprecision(4) << time << " ns/throw" << std::endl;
+  };
+
+  auto run = [&](const std::string& name, void (*f)(std::size_t)) {
+    print(name, benchmark(throws, [&](std::size_t i) {
+        try { f(i); }
+        catch (Dune::MathError&) { Dune::Benchmark::doNotOptimize(i); }
+      }));
+    print(name + " + what()", benchmark(throws, [&](std::size_t i) {
+        try { f(i); }
+        catch (Dune::MathError& e) { Dune::Benchmark::doNotOptimize(std::strlen(e.what())); }
+      }));
+  };
+
+  std::cout << "throws: " << throws << std::endl;
+  run("throw MathError()", throwPlain);
+  run("DUNE_THROW", throwEager);
+  run("DUNE_THROW_LAZY", throwLazy);
+
+  Dune::FieldMatrix<double, 4, 4> singular(1.0);
+  print("singular FieldMatrix", benchmark(throws, [&](std::size_t i) {
+      try { auto inverse = singular; inverse.invert(); }
+      catch (Dune::FMatrixError&) { Dune::Benchmark::doNotOptimize(i); }
+    }));
+
+  return 0;
+}
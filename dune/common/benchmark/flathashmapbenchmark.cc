@@ -0,0 +1,176 @@
+// -*- tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 2 -*-
+// vi: set et ts=4 sw=2 sts=2:
+// SPDX-FileCopyrightInfo: Copyright © DUNE Project contributors, see file LICENSE.md in module root
+// SPDX-License-Identifier: LicenseRef-GPL-2.0-only-with-DUNE-exception
+
+/**
+ * @brief Benchmark of FlatHashMap against std::unordered_map and a sorted array.
+ *
+ * Builds a map from sparse 64-bit global ids to consecutive local indices,
+ * as used for the lookup of the local index of a global id, and measures
+ * insertion with and without reserving memory, lookups of contained keys
+ * in random order, lookups of keys that are not contained, iteration and
+ * erasing half of the keys. The sorted array is searched by binary search
+ * like the index pairs of a ParallelIndexSet. The memory of the
+ * std::unordered_map is estimated from its buckets and nodes.
+ *
+ * Usage: ./flathashmapbenchmark [keys]
+ */
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include <dune/common/flathashmap.hh>
+#include <dune/common/timer.hh>
+
+#include "donotoptimize.hh"
+
+using Key = std::uint64_t;
+using Value = std::uint32_t;
+
+void print (const std::string& name, const std::string& operation, double seconds, std::size_t count)
+{
+  std::cout << std::left << std::setw(20) << name << std::setw(22) << operation
+            << std::right << std::setw(10) << std::setprecision(3) << 1e9 * seconds / count << " ns/op" << std::endl;
+}
+
+template <class Map>
+std::size_t memoryUsage (const Map& map)
+{
+  if constexpr (requires { map.memoryUsage(); })
+    return map.memoryUsage();
+  else
+    // one pointer per bucket, a node holds the next pointer and the value
+    return sizeof(map) + map.bucket_count() * sizeof(void*)
+      + map.size() * (sizeof(void*) + sizeof(typename Map::value_type));
+}
+
+template <class Map>
+void benchmark (const std::string& name, const std::vector<Key>& keys, const std::vector<Key>& missing)
+{
+  const std::size_t n = keys.size();
+
+  Dune::Timer timer;
+  {
+    Map map;
+    for (std::size_t i = 0; i < n; ++i)
+      map.emplace(keys[i], Value(i));
+    Dune::Benchmark::doNotOptimize(map.size());
+  }
+  print(name, "insert", timer.elapsed(), n);
+
+  timer.reset();
+  Map map;
+  map.reserve(n);
+  for (std::size_t i = 0; i < n; ++i)
+    map.emplace(keys[i], Value(i));
+  print(name, "insert reserved", timer.elapsed(), n);
+
+  std::vector<Key> shuffled = keys;
+  std::shuffle(shuffled.begin(), shuffled.end(), std::mt19937(1));
+  timer.reset();
+  std::size_t sum = 0;
+  for (Key key : shuffled)
+    sum += map.find(key)->second;
+  Dune::Benchmark::doNotOptimize(sum);
+  print(name, "find contained", timer.elapsed(), n);
+
+  timer.reset();
+  std::size_t found = 0;
+  for (Key key : missing)
+    found += map.contains(key);
+  Dune::Benchmark::doNotOptimize(found);
+  print(name, "find missing", timer.elapsed(), n);
+
+  timer.reset();
+  sum = 0;
+  for (const auto& [key, value] : map)
+    sum += value;
+  Dune::Benchmark::doNotOptimize(sum);
+  print(name, "iterate", timer.elapsed(), n);
+
+  const std::size_t memory = memoryUsage(map);
+
+  timer.reset();
+  for (std::size_t i = 0; i < n; i += 2)
+    map.erase(shuffled[i]);
+  print(name, "erase half", timer.elapsed(), n / 2);
+
+  std::cout << std::left << std::setw(20) << name << std::setw(22) << "memory"
+            << std::right << std::setw(10) << std::setprecision(3) << double(memory) / n << " bytes/key" << std::endl;
+}
+
+void benchmarkSortedArray (const std::vector<Key>& keys, const std::vector<Key>& missing)
+{
+  const std::size_t n = keys.size();
+  const std::string name = "sorted array";
+
+  Dune::Timer timer;
+  std::vector<std::pair<Key,Value>> pairs(n);
+  for (std::size_t i = 0; i < n; ++i)
+    pairs[i] = {keys[i], Value(i)};
+  std::sort(pairs.begin(), pairs.end());
+  print(name, "insert and sort", timer.elapsed(), n);
+
+  auto find = [&](Key key) {
+    return std::lower_bound(pairs.begin(), pairs.end(), key,
+                            [](const auto& pair, Key k) { return pair.first < k; });
+  };
+
+  std::vector<Key> shuffled = keys;
+  std::shuffle(shuffled.begin(), shuffled.end(), std::mt19937(1));
+  timer.reset();
+  std::size_t sum = 0;
+  for (Key key : shuffled)
+    sum += find(key)->second;
+  Dune::Benchmark::doNotOptimize(sum);
+  print(name, "find contained", timer.elapsed(), n);
+
+  timer.reset();
+  std::size_t found = 0;
+  for (Key key : missing)
+  {
+    auto it = find(key);
+    found += (it != pairs.end() && it->first == key);
+  }
+  Dune::Benchmark::doNotOptimize(found);
+  print(name, "find missing", timer.elapsed(), n);
+
+  std::cout << std::left << std::setw(20) << name << std::setw(22) << "memory"
+            << std::right << std::setw(10) << std::setprecision(3)
+            << double(pairs.capacity() * sizeof(pairs[0])) / n << " bytes/key" << std::endl;
+}
+
+int main (int argc, char** argv)
+{
+  const std::size_t n = (argc > 1) ? std::atol(argv[1]) : 1000000;
+
+  // sparse global ids, the missing keys are odd and the contained keys even
+  std::mt19937_64 random(42);
+  std::vector<Key> keys(n), missing(n);
+  for (std::size_t i = 0; i < n; ++i)
+  {
+    keys[i] = random() & ~Key(1);
+    missing[i] = random() | Key(1);
+  }
+  std::sort(keys.begin(), keys.end());
+  keys.erase(std::unique(keys.begin(), keys.end()), keys.end());
+  std::shuffle(keys.begin(), keys.end(), random);
+  missing.resize(keys.size());
+
+  std::cout << "keys: " << keys.size() << std::endl;
+  benchmark<std::unordered_map<Key,Value>>("std::unordered_map", keys, missing);
+  benchmark<Dune::FlatHashMap<Key,Value>>("FlatHashMap", keys, missing);
+  benchmarkSortedArray(keys, missing);
+
+  return 0;
+}
@@ -0,0 +1,140 @@
+// -*- tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 2 -*-
+// vi: set et ts=4 sw=2 sts=2:
+// SPDX-FileCopyrightInfo: Copyright © DUNE Project contributors, see file LICENSE.md in module root
+// SPDX-License-Identifier: LicenseRef-GPL-2.0-only-with-DUNE-exception
+
+/**
+ * @brief Benchmark of the hash policies HashCombinePolicy and WyHashPolicy.
+ *
+ * Measures the throughput of hashing ranges of integers of different lengths,
+ * and the quality of the hashes of dense index tuples (i,j,k), like
+ * multi-indices or the indices of the vertices of the elements of a structured
+ * grid: the number of full 64-bit collisions, and the fullest bucket and the
+ * number of empty buckets if the low bits of the hash select one of as many
+ * buckets as there are tuples. For a random function, about 37% of the buckets
+ * stay empty. Finally, the tuples are inserted into and looked up in a
+ * FlatHashMap, which uses the low bits of the hash.
+ *
+ * Usage: ./hashbenchmark [tuples per direction]
+ */
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <numeric>
+#include <string>
+#include <vector>
+
+#include <dune/common/flathashmap.hh>
+#include <dune/common/hash.hh>
+#include <dune/common/timer.hh>
+
+#include "donotoptimize.hh"
+
+using Index = std::array<int,3>;
+
+template <class Policy>
+void throughput (const std::string& name)
+{
+  std::cout << name << std::endl;
+  for (std::size_t length : {2, 4, 8, 32, 256, 4096})
+  {
+    std::vector<int> range(length);
+    std::iota(range.begin(), range.end(), 0);
+    const std::size_t repetitions = (std::size_t(1) << 26) / length;
+    Dune::range_hash<Policy> hash;
+
+    Dune::Timer timer;
+    std::size_t sum = 0;
+    for (std::size_t i = 0; i < repetitions; ++i)
+    {
+      range[0] = int(i);
+      sum += hash(range);
+    }
+    Dune::Benchmark::doNotOptimize(sum);
+    const double seconds = timer.elapsed();
+    std::cout << "  " << std::left << std::setw(12) << (std::to_string(length) + " ints") << std::right
+              << std::setw(10) << std::setprecision(3) << 1e9 * seconds / repetitions << " ns/hash"
+              << std::setw(10) << std::setprecision(3) << 1e-9 * repetitions * length * sizeof(int) / seconds << " GB/s"
+              << std::endl;
+  }
+}
+
+template <class Policy>
+void quality (const std::string& name, const std::vector<Index>& tuples)
+{
+  Dune::range_hash<Policy> hash;
+  const std::size_t n = tuples.size();
+  std::size_t buckets = 1;
+  while (buckets < n)
+    buckets *= 2;
+
+  std::vector<std::size_t> hashes(n);
+  std::vector<int> load(buckets, 0);
+  for (std::size_t i = 0; i < n; ++i)
+  {
+    hashes[i] = hash(tuples[i]);
+    ++load[hashes[i] & (buckets - 1)];
+  }
+  std::sort(hashes.begin(), hashes.end());
+  const std::size_t collisions = n - (std::unique(hashes.begin(), hashes.end()) - hashes.begin());
+  const std::size_t empty = std::count(load.begin(), load.end(), 0);
+
+  std::cout << "  " << std::left << std::setw(20) << name << std::right
+            << std::setw(12) << collisions
+            << std::setw(16) << *std::max_element(load.begin(), load.end())
+            << std::setw(13) << std::setprecision(3) << 100.0 * empty / buckets << " %" << std::endl;
+}
+
+template <class Policy>
+void map (const std::string& name, const std::vector<Index>& tuples)
+{
+  Dune::Timer timer;
+  Dune::FlatHashMap<Index, int, Dune::range_hash<Policy>> map;
+  for (std::size_t i = 0; i < tuples.size(); ++i)
+    map.emplace(tuples[i], int(i));
+  const double insert = timer.elapsed();
+
+  timer.reset();
+  std::size_t sum = 0;
+  for (const Index& index : tuples)
+    sum += map.find(index)->second;
+  Dune::Benchmark::doNotOptimize(sum);
+  const double find = timer.elapsed();
+
+  std::cout << "  " << std::left << std::setw(20) << name << std::right
+            << std::setw(10) << std::setprecision(3) << 1e9 * insert / tuples.size() << " ns/insert"
+            << std::setw(10) << std::setprecision(3) << 1e9 * find / tuples.size() << " ns/find" << std::endl;
+}
+
+int main (int argc, char** argv)
+{
+  const int n = (argc > 1) ? std::atoi(argv[1]) : 100;
+
+  throughput<Dune::HashCombinePolicy>("HashCombinePolicy");
+  throughput<Dune::WyHashPolicy>("WyHashPolicy");
+
+  std::vector<Index> tuples;
+  tuples.reserve(std::size_t(n) * n * n);
+  for (int i = 0; i < n; ++i)
+    for (int j = 0; j < n; ++j)
+      for (int k = 0; k < n; ++k)
+        tuples.push_back({i, j, k});
+
+  std::cout << std::endl << "tuples: " << tuples.size() << std::endl;
+  std::cout << "  " << std::left << std::setw(20) << "policy" << std::right
+            << std::setw(12) << "collisions" << std::setw(16) << "fullest bucket"
+            << std::setw(15) << "empty buckets" << std::endl;
+  quality<Dune::HashCombinePolicy>("HashCombinePolicy", tuples);
+  quality<Dune::WyHashPolicy>("WyHashPolicy", tuples);
+
+  std::cout << std::endl << "FlatHashMap<std::array<int,3>,int>" << std::endl;
+  map<Dune::HashCombinePolicy>("HashCombinePolicy", tuples);
+  map<Dune::WyHashPolicy>("WyHashPolicy", tuples);
+
+  return 0;
+}
@@ -0,0 +1,111 @@
+// -*- tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 2 -*-
+// vi: set et ts=4 sw=2 sts=2:
+// SPDX-FileCopyrightInfo: Copyright © DUNE Project contributors, see file LICENSE.md in module root
+// SPDX-License-Identifier: LicenseRef-GPL-2.0-only-with-DUNE-exception
+
+/**
+ * @brief Benchmark for parameter queries inside time loops.
+ *
+ * Repeatedly queries scalar and vector valued parameters with dotted keys
+ * from a `ParameterTree`. As a reference, the same queries are performed the
+ * way `ParameterTree::get` used to work: looking up the key twice by walking
+ * the substructures with copies of the key parts and parsing the value with
+ * a `std::istringstream` on every call.
+ *
+ * Usage: ./parametertreebenchmark [queries]
+ */
+
+#include <cstddef>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <locale>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include <dune/common/parametertree.hh>
+#include <dune/common/timer.hh>
+
+// lookup and parsing as done by ParameterTree::get before hashed storage and caching
+const std::string& referenceLookup (const Dune::ParameterTree& tree, const std::string& key)
+{
+  std::string::size_type dot = key.find(".");
+  if (dot != std::string::npos)
+    return referenceLookup(tree.sub(key.substr(0,dot)), key.substr(dot+1));
+  return tree[key];
+}
+
+template <class T>
+T referenceParse (const std::string& str)
+{
+  T val;
+  std::istringstream s(str);
+  s.imbue(std::locale::classic());
+  s >> val;
+  return val;
+}
+
+template <class T>
+std::vector<T> referenceParseVector (const std::string& str)
+{
+  std::vector<T> vec;
+  std::istringstream s(str);
+  s.imbue(std::locale::classic());
+  T val;
+  while (s >> val)
+    vec.push_back(val);
+  return vec;
+}
+
+template <class F>
+void benchmark (const std::string& name, std::size_t queries, F&& query)
+{
+  double checksum = 0.0;
+  Dune::Timer timer;
+  for (std::size_t i = 0; i < queries; ++i)
+    checksum += query();
+  const double time = timer.elapsed();
+  std::cout << std::left << std::setw(32) << name
+            << std::right << std::setw(12) << std::setprecision(4) << 1e9 * time / queries << " ns/query"
+            << "   (checksum " << checksum << ")" << std::endl;
+}
+
+int main (int argc, char** argv)
+{
+  const std::size_t queries = (argc > 1) ? std::atol(argv[1]) : 1000000;
+
+  Dune::ParameterTree tree;
+  for (int i = 0; i < 20; ++i)
+    tree["solver.linear.option" + std::to_string(i)] = std::to_string(i);
+  tree["solver.linear.tolerance"] = "1e-8";
+  tree["solver.linear.maxit"] = "500";
+  tree["model.material.layer.coefficients"] = "1.0 2.5 3.0 4.5 0.5 0.25";
+  const Dune::ParameterTree& ctree = tree;
+
+  std::cout << "queries: " << queries << std::endl;
+
+  benchmark("double (reference)", queries, [&] {
+      const std::string& key = "solver.linear.tolerance";
+      return (ctree.hasKey(key) ? referenceParse<double>(referenceLookup(ctree, key)) : 0.0);
+    });
+  benchmark("double", queries, [&] { return ctree.get<double>("solver.linear.tolerance"); });
+
+  benchmark("int (reference)", queries, [&] {
+      const std::string& key = "solver.linear.maxit";
+      return double(ctree.hasKey(key) ? referenceParse<int>(referenceLookup(ctree, key)) : 0);
+    });
+  benchmark("int", queries, [&] { return double(ctree.get<int>("solver.linear.maxit")); });
+
+  benchmark("vector<double> (reference)", queries, [&] {
+      const std::string& key = "model.material.layer.coefficients";
+      return referenceParseVector<double>(referenceLookup(ctree, key))[2];
+    });
+  benchmark("vector<double>", queries, [&] {
+      return ctree.get<std::vector<double>>("model.material.layer.coefficients")[2];
+    });
+
+  benchmark("default value", queries, [&] { return ctree.get("solver.nonlinear.tolerance", 1e-6); });
+
+  return 0;
+}
@@ -0,0 +1,72 @@
+// -*- tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 2 -*-
+// vi: set et ts=4 sw=2 sts=2:
+// SPDX-FileCopyrightInfo: Copyright © DUNE Project contributors, see file LICENSE.md in module root
+// SPDX-License-Identifier: LicenseRef-GPL-2.0-only-with-DUNE-exception
+
+/**
+ * @brief Benchmark for the overhead of profiled regions.
+ *
+ * Measures the time needed to enter and leave an empty region, a region
+ * nested in another region and a region with tracing enabled, compared to
+ * an empty loop. The time per region includes two readings of the profiler
+ * clock, which is the time stamp counter on x86.
+ *
+ * Usage: ./profilerbenchmark [regions]
+ */
+
+#include <cstddef>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <string>
+
+#include <dune/common/profiler.hh>
+#include <dune/common/timer.hh>
+
+#include "donotoptimize.hh"
+
+template <class F>
+double benchmark (std::size_t regions, F&& region)
+{
+  Dune::Timer timer;
+  for (std::size_t i = 0; i < regions; ++i)
+    region(i);
+  return 1e9 * timer.elapsed() / regions;
+}
+
+int main (int argc, char** argv)
+{
+  const std::size_t regions = (argc > 1) ? std::atol(argv[1]) : 10000000;
+
+  auto print = [](const std::string& name, double time, double reference) {
+    std::cout << std::left << std::setw(24) << name
+              << std::right << std::setw(10) << std::setprecision(3) << time - reference << " ns/region" << std::endl;
+  };
+
+  std::cout << "regions: " << regions << std::endl;
+  const double empty = benchmark(regions, [&](std::size_t i) { Dune::Benchmark::doNotOptimize(i); });
+
+  print("region", benchmark(regions, [&](std::size_t i) {
+      Dune::ProfileRegion region("region");
+      Dune::Benchmark::doNotOptimize(i);
+    }), empty);
+
+  {
+    Dune::ProfileRegion outer("outer");
+    print("nested region", benchmark(regions, [&](std::size_t i) {
+        Dune::ProfileRegion region("nested");
+        Dune::Benchmark::doNotOptimize(i);
+      }), empty);
+  }
+
+  Dune::Profiler::instance().enableTracing(regions);
+  print("traced region", benchmark(regions, [&](std::size_t i) {
+      Dune::ProfileRegion region("traced");
+      Dune::Benchmark::doNotOptimize(i);
+    }), empty);
+  Dune::Profiler::instance().disableTracing();
+
+  std::cout << std::endl;
+  Dune::Profiler::instance().report(std::cout);
+  return 0;
+}
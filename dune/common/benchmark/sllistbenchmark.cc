@@ -0,0 +1,147 @@
+// -*- tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 2 -*-
+// vi: set et ts=4 sw=2 sts=2:
+// SPDX-FileCopyrightInfo: Copyright © DUNE Project contributors, see file LICENSE.md in module root
+// SPDX-License-Identifier: LicenseRef-GPL-2.0-only-with-DUNE-exception
+
+/**
+ * @brief Benchmark of SLList building remote index lists.
+ *
+ * Mimics RemoteIndices::rebuild(): for every neighbour process a send and a
+ * receive list are allocated and filled in turns with entries of the size of
+ * a RemoteIndex (a pointer to the local index pair and an attribute). The lists
+ * are traversed twice and deleted again, as on every repartitioning. The same
+ * is done with std::forward_list, which allocates every node separately, and
+ * with std::vector as a reference for contiguous storage. Finally, all lists
+ * are collected into one list with SLList::splice_back().
+ *
+ * Usage: ./sllistbenchmark [neighbours] [indices per neighbour] [rebuilds]
+ */
+
+#include <cstddef>
+#include <cstdlib>
+#include <forward_list>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include <dune/common/sllist.hh>
+#include <dune/common/timer.hh>
+
+#include "donotoptimize.hh"
+
+// same layout as Dune::RemoteIndex
+struct RemoteEntry
+{
+  const std::size_t* localIndex;
+  char attribute;
+};
+
+template<class T>
+void append (Dune::SLList<T>& list, const T& entry)
+{
+  list.push_back(entry);
+}
+
+template<class T>
+void append (std::vector<T>& list, const T& entry)
+{
+  list.push_back(entry);
+}
+
+template<class T>
+void append (std::forward_list<T>& list, const T& entry)
+{
+  // std::forward_list has no push_back, the order of the entries does not matter here
+  list.push_front(entry);
+}
+
+void print (const std::string& name, const std::string& operation, double seconds, std::size_t count)
+{
+  std::cout << std::left << std::setw(20) << name << std::setw(12) << operation
+            << std::right << std::setw(10) << std::setprecision(3) << 1e9 * seconds / count << " ns/entry" << std::endl;
+}
+
+template<class List>
+void benchmark (const std::string& name, const std::vector<std::size_t>& locals,
+                std::size_t neighbours, std::size_t rebuilds)
+{
+  const std::size_t entries = 2 * neighbours * locals.size() * rebuilds;
+  double build = 0, traverse = 0, destroy = 0;
+
+  for (std::size_t r = 0; r < rebuilds; ++r)
+  {
+    Dune::Timer timer;
+    std::vector<std::unique_ptr<List> > send, receive;
+    for (std::size_t p = 0; p < neighbours; ++p)
+    {
+      send.push_back(std::make_unique<List>());
+      receive.push_back(std::make_unique<List>());
+      for (std::size_t i = 0; i < locals.size(); ++i)
+      {
+        append(*send.back(), RemoteEntry{&locals[i], char(i % 3)});
+        append(*receive.back(), RemoteEntry{&locals[i], char(i % 5)});
+      }
+    }
+    build += timer.elapsed();
+
+    timer.reset();
+    std::size_t sum = 0;
+    for (int pass = 0; pass < 2; ++pass)
+      for (std::size_t p = 0; p < neighbours; ++p)
+      {
+        for (const RemoteEntry& entry : *send[p])
+          sum += *entry.localIndex + entry.attribute;
+        for (const RemoteEntry& entry : *receive[p])
+          sum += *entry.localIndex + entry.attribute;
+      }
+    Dune::Benchmark::doNotOptimize(sum);
+    traverse += timer.elapsed() / 2;
+
+    timer.reset();
+    send.clear();
+    receive.clear();
+    destroy += timer.elapsed();
+  }
+
+  print(name, "build", build, entries);
+  print(name, "traverse", traverse, entries);
+  print(name, "destroy", destroy, entries);
+}
+
+void benchmarkSplice (const std::vector<std::size_t>& locals, std::size_t neighbours)
+{
+  std::vector<Dune::SLList<RemoteEntry> > lists(neighbours);
+  for (std::size_t p = 0; p < neighbours; ++p)
+    for (std::size_t i = 0; i < locals.size(); ++i)
+      lists[p].push_back(RemoteEntry{&locals[i], char(i % 3)});
+
+  Dune::Timer timer;
+  Dune::SLList<RemoteEntry> all;
+  for (auto& list : lists)
+    all.splice_back(list);
+  const double seconds = timer.elapsed();
+  std::cout << std::left << std::setw(20) << "SLList" << std::setw(12) << "splice"
+            << std::right << std::setw(10) << std::setprecision(3) << 1e9 * seconds / neighbours << " ns/list" << std::endl;
+}
+
+int main (int argc, char** argv)
+{
+  const std::size_t neighbours = (argc > 1) ? std::atol(argv[1]) : 32;
+  const std::size_t indices = (argc > 2) ? std::atol(argv[2]) : 20000;
+  const std::size_t rebuilds = (argc > 3) ? std::atol(argv[3]) : 10;
+
+  std::vector<std::size_t> locals(indices);
+  for (std::size_t i = 0; i < indices; ++i)
+    locals[i] = i;
+
+  std::cout << "neighbours: " << neighbours << ", indices per neighbour: " << indices
+            << ", rebuilds: " << rebuilds << std::endl;
+  benchmark<std::forward_list<RemoteEntry> >("std::forward_list", locals, neighbours, rebuilds);
+  benchmark<Dune::SLList<RemoteEntry> >("SLList", locals, neighbours, rebuilds);
+  benchmark<std::vector<RemoteEntry> >("std::vector", locals, neighbours, rebuilds);
+  benchmarkSplice(locals, neighbours);
+
+  return 0;
+}
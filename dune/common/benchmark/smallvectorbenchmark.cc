@@ -0,0 +1,86 @@
+// -*- tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 2 -*-
+// vi: set et ts=4 sw=2 sts=2:
+// SPDX-FileCopyrightInfo: Copyright © DUNE Project contributors, see file LICENSE.md in module root
+// SPDX-License-Identifier: LicenseRef-GPL-2.0-only-with-DUNE-exception
+
+/**
+ * @brief Benchmark of SmallVector against ReservedVector and std::vector.
+ *
+ * Mimics a list of neighbors or degrees of freedom that is built for every
+ * element of a grid: most lists have 4 to 8 entries, every 32nd list has 40
+ * entries. Measures building the lists with push_back and summing them up,
+ * and storing a copy of every list in a std::vector. The ReservedVector
+ * needs the worst-case capacity of 40 entries.
+ *
+ * Usage: ./smallvectorbenchmark [lists]
+ */
+
+#include <cstddef>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include <dune/common/reservedvector.hh>
+#include <dune/common/smallvector.hh>
+#include <dune/common/timer.hh>
+
+#include "donotoptimize.hh"
+
+std::size_t listSize (std::size_t i)
+{
+  return (i % 32 == 31) ? 40 : 4 + (i % 5);
+}
+
+template <class Container>
+void benchmark (const std::string& name, std::size_t lists)
+{
+  Dune::Timer timer;
+  std::size_t sum = 0;
+  for (std::size_t i = 0; i < lists; ++i)
+  {
+    Container list;
+    for (std::size_t j = 0; j < listSize(i); ++j)
+      list.push_back(int(i + j));
+    for (int value : list)
+      sum += value;
+  }
+  Dune::Benchmark::doNotOptimize(sum);
+  const double build = 1e9 * timer.elapsed() / lists;
+
+  timer.reset();
+  {
+    std::vector<Container> stored;
+    stored.reserve(lists);
+    Container list;
+    for (std::size_t i = 0; i < lists; ++i)
+    {
+      list.clear();
+      for (std::size_t j = 0; j < listSize(i); ++j)
+        list.push_back(int(j));
+      stored.push_back(list);
+    }
+    Dune::Benchmark::doNotOptimize(stored.back().size());
+  }
+  const double store = 1e9 * timer.elapsed() / lists;
+
+  std::cout << std::left << std::setw(26) << name << std::right
+            << std::setw(10) << std::setprecision(3) << build << " ns/list"
+            << std::setw(10) << std::setprecision(3) << store << " ns/list"
+            << std::setw(8) << sizeof(Container) << " bytes" << std::endl;
+}
+
+int main (int argc, char** argv)
+{
+  const std::size_t lists = (argc > 1) ? std::atol(argv[1]) : 2000000;
+
+  std::cout << "lists: " << lists << std::endl;
+  std::cout << std::left << std::setw(26) << "container" << std::right
+            << std::setw(18) << "build and sum" << std::setw(18) << "store copy" << std::setw(14) << "size" << std::endl;
+  benchmark<std::vector<int>>("std::vector<int>", lists);
+  benchmark<Dune::ReservedVector<int,40>>("ReservedVector<int,40>", lists);
+  benchmark<Dune::SmallVector<int,8>>("SmallVector<int,8>", lists);
+
+  return 0;
+}
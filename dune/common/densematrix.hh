@@ -913,7 +913,7 @@ namespace Dune
       nonsingularLanes = nonsingularLanes && (pivmax != real_type(0));
       if (throwEarly) {
         if(!Simd::allTrue(nonsingularLanes))
-          DUNE_THROW(FMatrixError, "matrix is singular");
+          DUNE_THROW_LAZY(FMatrixError, "matrix is singular");
       }
       else { // !throwEarly
         if(!Simd::anyTrue(nonsingularLanes))
@@ -948,7 +948,7 @@ namespace Dune
 #ifdef DUNE_FMatrix_WITH_CHECKING
       if (Simd::anyTrue(fvmeta::absreal((*this)[0][0])
                         < FMatrixPrecision<>::absolute_limit()))
-        DUNE_THROW(FMatrixError,"matrix is singular");
+        DUNE_THROW_LAZY(FMatrixError, "matrix is singular");
 #endif
       x[0] = b[0]/(*this)[0][0];
 
@@ -959,7 +959,7 @@ namespace Dune
 #ifdef DUNE_FMatrix_WITH_CHECKING
       if (Simd::anyTrue(fvmeta::absreal(detinv)
                         < FMatrixPrecision<>::absolute_limit()))
-        DUNE_THROW(FMatrixError,"matrix is singular");
+        DUNE_THROW_LAZY(FMatrixError, "matrix is singular");
 #endif
       detinv = real_type(1.0)/detinv;
 
@@ -973,7 +973,7 @@ namespace Dune
 #ifdef DUNE_FMatrix_WITH_CHECKING
       if (Simd::anyTrue(fvmeta::absreal(d)
                         < FMatrixPrecision<>::absolute_limit()))
-        DUNE_THROW(FMatrixError,"matrix is singular");
+        DUNE_THROW_LAZY(FMatrixError, "matrix is singular");
 #endif
 
       x[0] = (b[0]*(*this)[1][1]*(*this)[2][2] - b[0]*(*this)[2][1]*(*this)[1][2]
@@ -1024,7 +1024,7 @@ namespace Dune
 #ifdef DUNE_FMatrix_WITH_CHECKING
       if (Simd::anyTrue(fvmeta::absreal((*this)[0][0])
                         < FMatrixPrecision<>::absolute_limit()))
-        DUNE_THROW(FMatrixError,"matrix is singular");
+        DUNE_THROW_LAZY(FMatrixError, "matrix is singular");
 #endif
       (*this)[0][0] = real_type( 1 ) / (*this)[0][0];
 
@@ -1035,7 +1035,7 @@ namespace Dune
 #ifdef DUNE_FMatrix_WITH_CHECKING
       if (Simd::anyTrue(fvmeta::absreal(detinv)
                         < FMatrixPrecision<>::absolute_limit()))
-        DUNE_THROW(FMatrixError,"matrix is singular");
+        DUNE_THROW_LAZY(FMatrixError, "matrix is singular");
 #endif
       detinv = real_type( 1 ) / detinv;
 
@@ -2,6 +2,8 @@
 // vi: set et ts=4 sw=2 sts=2:
 // SPDX-FileCopyrightInfo: Copyright © DUNE Project contributors, see file LICENSE.md in module root
 // SPDX-License-Identifier: LicenseRef-GPL-2.0-only-with-DUNE-exception
+#include <thread>
+
 #include <dune/common/exceptions.hh>
 
 namespace Dune {
@@ -32,11 +34,45 @@ namespace Dune {
   void Exception::message(const std::string & msg)
   {
     _message = msg;
+    _lazyMessage.reset();
+  }
+
+  void Exception::message(std::shared_ptr<const Impl::LazyExceptionMessageBase> msg)
+  {
+    _message.clear();
+    _lazyMessage = std::move(msg);
   }
 
   const char* Exception::what() const noexcept
   {
+    if (_lazyMessage)
+      return _lazyMessage->what();
     return _message.data();
   }
 
+  /*
+     Implementation of Dune::Impl::LazyExceptionMessageBase
+   */
+  const char* Impl::LazyExceptionMessageBase::what() const noexcept
+  {
+    int state = 0;
+    if (state_.compare_exchange_strong(state, 1, std::memory_order_acquire))
+    {
+      try {
+        std::ostringstream stream;
+        format(stream);
+        message_ = stream.str();
+      }
+      catch (...) {
+        // the message stays empty if formatting fails
+      }
+      state_.store(2, std::memory_order_release);
+    }
+    else
+      // another thread is formatting the message
+      while (state_.load(std::memory_order_acquire) != 2)
+        std::this_thread::yield();
+    return message_.data();
+  }
+
 }
@@ -6,9 +6,15 @@
 #ifndef DUNE_EXCEPTIONS_HH
 #define DUNE_EXCEPTIONS_HH
 
+#include <atomic>
+#include <concepts>
+#include <cstddef>
 #include <exception>
+#include <memory>
 #include <string>
+#include <string_view>
 #include <sstream>
+#include <tuple>
 #include <type_traits>
 #include <utility>
 
@@ -76,6 +82,33 @@ namespace Dune {
   class Exception;
   struct ExceptionHook;
 
+  namespace Impl {
+
+    /** \brief Message of an exception that is formatted on the first call of what()
+     *
+     * Formatting happens at most once, also if what() is called concurrently
+     * on copies of the exception.
+     */
+    class LazyExceptionMessageBase
+    {
+    public:
+      virtual ~LazyExceptionMessageBase () = default;
+
+      //! The formatted message
+      const char* what () const noexcept;
+
+    protected:
+      //! Write the message to the stream
+      virtual void format (std::ostream& stream) const = 0;
+
+    private:
+      // 0: not formatted, 1: formatting, 2: formatted
+      mutable std::atomic<int> state_ = 0;
+      mutable std::string message_;
+    };
+
+  } // end namespace Impl
+
   /*! \class Exception
      \brief Base class for Dune-Exceptions
 
@@ -99,11 +132,13 @@ namespace Dune {
   public:
     Exception ();
     void message(const std::string &msg); //!< store string in internal message buffer
+    void message(std::shared_ptr<const Impl::LazyExceptionMessageBase> msg); //!< store a message that is formatted on the first call of what()
     const char* what() const noexcept override; //!< output internal message buffer
     static void registerHook (ExceptionHook * hook); //!< add a functor which is called before a Dune::Exception is emitted (see Dune::ExceptionHook) \see Dune::ExceptionHook
     static void clearHook ();                  //!< remove all hooks
   private:
     std::string _message;
+    std::shared_ptr<const Impl::LazyExceptionMessageBase> _lazyMessage;
     static ExceptionHook * _hook;
   };
 
@@ -278,6 +313,197 @@ namespace Dune {
   };
 
 
+  namespace Impl {
+
+    /**
+     * \brief Storage type of a value streamed into DUNE_THROW_LAZY
+     *
+     * The values are copied, since the exception may outlive them. Constant
+     * character arrays are assumed to be string literals and only their
+     * address is stored. Other strings are copied into a std::string, and
+     * values that cannot be copied are formatted immediately.
+     */
+    template<class T>
+    using LazyExceptionArgument_t =
+      std::conditional_t<std::is_array_v<std::remove_reference_t<T>>
+                         and std::is_same_v<std::remove_extent_t<std::remove_reference_t<T>>, const char>,
+        const char*,
+        std::conditional_t<std::is_convertible_v<T, std::string_view>
+                           or not std::copy_constructible<std::decay_t<T>>,
+          std::string,
+          std::decay_t<T>>>;
+
+    /**
+     * \brief Source location and streamed values of an exception thrown by DUNE_THROW_LAZY
+     *
+     * The operator<< returns a new object with the value appended.
+     */
+    template<class... Args>
+    class LazyExceptionArguments
+    {
+      template<class...> friend class LazyExceptionArguments;
+
+    public:
+      LazyExceptionArguments (const char* type, const char* func, const char* file, int line,
+                              std::tuple<Args...>&& args = {})
+        : type_(type), func_(func), file_(file), line_(line)
+        , args_(std::move(args))
+      {}
+
+      //! Append a value, called for all values that are not integral
+      template<class T>
+        requires
+          (requires(std::ostringstream& oss, const T& t) { oss << t; }
+          and not std::is_integral_v<std::remove_cvref_t<T>>)
+      friend auto operator<< (LazyExceptionArguments&& a, T&& t)
+      {
+        using S = LazyExceptionArgument_t<T>;
+        if constexpr (std::is_same_v<S, std::string>
+                      and not std::is_convertible_v<T, std::string_view>)
+        {
+          std::ostringstream oss;
+          oss << t;
+          return std::move(a).append(oss.str());
+        }
+        else
+          return std::move(a).append(S(t));
+      }
+
+      //! Append an integral value, taken by value to support `static const` members without definition
+      template<class T>
+        requires std::is_integral_v<T>
+      friend auto operator<< (LazyExceptionArguments&& a, T t)
+      {
+        return std::move(a).append(t);
+      }
+
+      //! Append an io manipulator
+      friend auto operator<< (LazyExceptionArguments&& a, std::ostream& (*t)(std::ostream&))
+      {
+        return std::move(a).append(t);
+      }
+
+      //! Write the message to the stream
+      void format (std::ostream& stream) const
+      {
+        stream << type_ << " [" << func_ << ":" << file_ << ":" << line_ << "]: ";
+        std::apply([&](const auto&... args) { ((stream << args), ...); }, args_);
+      }
+
+    private:
+      template<class S>
+      LazyExceptionArguments<Args..., S> append (S s) &&
+      {
+        return LazyExceptionArguments<Args..., S>(type_, func_, file_, line_,
+          std::tuple_cat(std::move(args_), std::tuple<S>(std::move(s))));
+      }
+
+      const char* type_;
+      const char* func_;
+      const char* file_;
+      int line_;
+      std::tuple<Args...> args_;
+    };
+
+    //! The message of an exception thrown by DUNE_THROW_LAZY
+    template<class... Args>
+    class LazyExceptionMessage final
+      : public LazyExceptionMessageBase
+    {
+    public:
+      explicit LazyExceptionMessage (LazyExceptionArguments<Args...>&& args)
+        : args_(std::move(args))
+      {}
+
+      //! Move the arguments out, only valid as long as the message is not shared
+      LazyExceptionArguments<Args...>&& release ()
+      {
+        return std::move(args_);
+      }
+
+    protected:
+      void format (std::ostream& stream) const override
+      {
+        args_.format(stream);
+      }
+
+    private:
+      LazyExceptionArguments<Args...> args_;
+    };
+
+  } // end namespace Impl
+
+
+  /**
+   * \brief Exception that formats its message only when it is requested
+   *
+   * \tparam E Exception base class, should be derived from Dune::Exception.
+   *
+   * The streamed values are stored together with the source location in a
+   * single allocation and formatted on the first call of what(). Copies of
+   * the exception, also those sliced to E, share the message. Additional
+   * values can be streamed into an rvalue LazyExceptionStream, which
+   * changes its type. Use the macro DUNE_THROW_LAZY() to create it.
+   */
+  template<class E, class... Args>
+  class LazyExceptionStream
+    : public E
+  {
+    template<class, class...> friend class LazyExceptionStream;
+
+  public:
+    explicit LazyExceptionStream (Impl::LazyExceptionArguments<Args...>&& args)
+      : message_(std::make_shared<Impl::LazyExceptionMessage<Args...>>(std::move(args)))
+    {
+      static_cast<Exception&>(*this).message(message_);
+    }
+
+    //! Stream operator for values that are not integral
+    template<class T>
+      requires
+        (requires(Impl::LazyExceptionArguments<Args...>&& a, T&& t) { std::move(a) << std::forward<T>(t); }
+        and not std::is_integral_v<std::remove_cvref_t<T>>)
+    friend auto operator<< (LazyExceptionStream&& es, T&& t)
+    {
+      return makeStream(es.message_->release() << std::forward<T>(t));
+    }
+
+    //! Stream operator for integral values
+    template<class T>
+      requires std::is_integral_v<T>
+    friend auto operator<< (LazyExceptionStream&& es, T t)
+    {
+      return makeStream(es.message_->release() << t);
+    }
+
+    //! Stream operator for io manipulators
+    friend auto operator<< (LazyExceptionStream&& es, std::ostream& (*t)(std::ostream&))
+    {
+      return makeStream(es.message_->release() << t);
+    }
+
+  private:
+    template<class... A>
+    static LazyExceptionStream<E, A...> makeStream (Impl::LazyExceptionArguments<A...>&& args)
+    {
+      return LazyExceptionStream<E, A...>(std::move(args));
+    }
+
+    std::shared_ptr<Impl::LazyExceptionMessage<Args...>> message_;
+  };
+
+  namespace Impl {
+
+    //! Create the LazyExceptionStream thrown by DUNE_THROW_LAZY
+    template<class E, class... Args>
+    LazyExceptionStream<E, Args...> makeLazyExceptionStream (LazyExceptionArguments<Args...>&& args)
+    {
+      return LazyExceptionStream<E, Args...>(std::move(args));
+    }
+
+  } // end namespace Impl
+
+
 
 #ifndef DOXYGEN
   // the "format" the exception-type gets printed.  __FILE__ and
@@ -310,8 +536,41 @@ namespace Dune {
      e.g. to add additional information to the exception,
      or to invoke a debugger during parallel debugging. (see Dune::ExceptionHook)
 
+     \note
+     If `DUNE_LAZY_EXCEPTION_MESSAGES` is defined to a nonzero value,
+     DUNE_THROW is the same as DUNE_THROW_LAZY().
+
    */
+#if DUNE_LAZY_EXCEPTION_MESSAGES
+#define DUNE_THROW(E, ...) DUNE_THROW_LAZY(E __VA_OPT__(,) __VA_ARGS__)
+#else
 #define DUNE_THROW(E, ...) throw Dune::ExceptionStream(E()) << THROWSPEC(E) __VA_OPT__(<<) __VA_ARGS__
+#endif
+
+  /*! Macro to throw an exception whose message is formatted on demand
+
+     \code
+     #include <dune/common/exceptions.hh>
+     \endcode
+
+     \param E exception class derived from Dune::Exception
+     \param m reason for this exception in ostream-notation
+
+     Behaves like DUNE_THROW(), but the streamed values are only copied at
+     the throw site and formatted on the first call of what(). This avoids
+     the construction of a std::ostringstream and makes throwing cheap if
+     the exception is caught without looking at its message, e.g. if
+     exceptions signal a failed Newton step or a singular matrix.
+
+     The values are stored as described in Impl::LazyExceptionArgument_t.
+     Values that refer to other objects, e.g. expression templates or
+     pointers to local character arrays, must not be streamed, as these
+     objects are destroyed before the message is formatted.
+
+   */
+#define DUNE_THROW_LAZY(E, ...) \
+  throw Dune::Impl::makeLazyExceptionStream<E>( \
+    Dune::Impl::LazyExceptionArguments<>(# E, __func__, __FILE__, __LINE__) __VA_OPT__(<<) __VA_ARGS__)
 
   /*! \brief Default exception class for I/O errors
 
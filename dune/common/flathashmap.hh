@@ -0,0 +1,129 @@
+// -*- tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 2 -*-
+// vi: set et ts=4 sw=2 sts=2:
+// SPDX-FileCopyrightInfo: Copyright © DUNE Project contributors, see file LICENSE.md in module root
+// SPDX-License-Identifier: LicenseRef-GPL-2.0-only-with-DUNE-exception
+#ifndef DUNE_COMMON_FLATHASHMAP_HH
+#define DUNE_COMMON_FLATHASHMAP_HH
+
+/** \file
+ * \brief A hash map storing its elements in a flat array
+ */
+
+#include <functional>
+#include <stdexcept>
+#include <tuple>
+#include <utility>
+
+#include <dune/common/flathashtable.hh>
+#include <dune/common/hash.hh>
+
+namespace Dune
+{
+  /**
+     \brief A hash map with open addressing that stores its elements in a flat array
+
+     FlatHashMap has the interface of std::unordered_map, except for the
+     bucket interface. The elements are stored in one array and found by
+     probing an array of one control byte per element, which holds seven bits
+     of the hash of the key. The control bytes of 16 consecutive slots are
+     compared at once with SSE2 instructions, or of 8 slots with integer
+     arithmetic on other architectures. A lookup therefore touches very few
+     cache lines, which makes FlatHashMap much faster and smaller than the
+     node-based std::unordered_map for large maps, e.g. maps from global ids
+     to local indices.
+
+     The table grows if more than 7/8 of the slots are used. reserve()
+     allocates memory for a number of elements in advance, and memoryUsage()
+     reports the memory used.
+
+     \note In contrast to std::unordered_map, inserting elements invalidates
+           iterators, pointers and references to elements if the table grows,
+           and elements are moved when the table grows.
+
+     \tparam Key       The type of the keys.
+     \tparam T         The type of the mapped values.
+     \tparam Hash      The hash function of the keys, the bits of its result are mixed again.
+     \tparam KeyEqual  The equality comparison of the keys.
+   */
+  template<class Key, class T, class Hash = Dune::hash<Key>, class KeyEqual = std::equal_to<Key>>
+  class FlatHashMap
+    : public Impl::FlatHashTable<Impl::FlatHashMapPolicy<Key,T>, Hash, KeyEqual>
+  {
+    using Base = Impl::FlatHashTable<Impl::FlatHashMapPolicy<Key,T>, Hash, KeyEqual>;
+
+  public:
+    //! The type of the mapped values
+    using mapped_type = T;
+
+    using typename Base::key_type;
+    using typename Base::value_type;
+    using typename Base::iterator;
+    using typename Base::const_iterator;
+
+    using Base::Base;
+    using Base::insert;
+
+    //! Constructs the mapped value from the arguments if the key is not contained yet
+    template<class... Args>
+    std::pair<iterator,bool> try_emplace (const key_type& key, Args&&... args)
+    {
+      return this->findOrInsert(key, [&](value_type* p) {
+          std::construct_at(p, std::piecewise_construct, std::forward_as_tuple(key),
+                            std::forward_as_tuple(std::forward<Args>(args)...));
+        });
+    }
+
+    //! Constructs the mapped value from the arguments if the key is not contained yet
+    template<class... Args>
+    std::pair<iterator,bool> try_emplace (key_type&& key, Args&&... args)
+    {
+      return this->findOrInsert(key, [&](value_type* p) {
+          std::construct_at(p, std::piecewise_construct, std::forward_as_tuple(std::move(key)),
+                            std::forward_as_tuple(std::forward<Args>(args)...));
+        });
+    }
+
+    //! Inserts the value or assigns it to the mapped value if the key is contained
+    template<class M>
+    std::pair<iterator,bool> insert_or_assign (const key_type& key, M&& value)
+    {
+      auto result = try_emplace(key, std::forward<M>(value));
+      if (!result.second)
+        result.first->second = std::forward<M>(value);
+      return result;
+    }
+
+    //! Returns the mapped value of the key, inserting a value-initialized one if the key is not contained
+    mapped_type& operator[] (const key_type& key)
+    {
+      return try_emplace(key).first->second;
+    }
+
+    //! Returns the mapped value of the key, inserting a value-initialized one if the key is not contained
+    mapped_type& operator[] (key_type&& key)
+    {
+      return try_emplace(std::move(key)).first->second;
+    }
+
+    //! Returns the mapped value of the key, throws std::out_of_range if the key is not contained
+    mapped_type& at (const key_type& key)
+    {
+      auto it = this->find(key);
+      if (it == this->end())
+        throw std::out_of_range("Key not contained in FlatHashMap");
+      return it->second;
+    }
+
+    //! Returns the mapped value of the key, throws std::out_of_range if the key is not contained
+    const mapped_type& at (const key_type& key) const
+    {
+      auto it = this->find(key);
+      if (it == this->end())
+        throw std::out_of_range("Key not contained in FlatHashMap");
+      return it->second;
+    }
+  };
+
+}
+
+#endif // DUNE_COMMON_FLATHASHMAP_HH
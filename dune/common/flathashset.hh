@@ -0,0 +1,44 @@
+// -*- tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 2 -*-
+// vi: set et ts=4 sw=2 sts=2:
+// SPDX-FileCopyrightInfo: Copyright © DUNE Project contributors, see file LICENSE.md in module root
+// SPDX-License-Identifier: LicenseRef-GPL-2.0-only-with-DUNE-exception
+#ifndef DUNE_COMMON_FLATHASHSET_HH
+#define DUNE_COMMON_FLATHASHSET_HH
+
+/** \file
+ * \brief A hash set storing its elements in a flat array
+ */
+
+#include <functional>
+
+#include <dune/common/flathashtable.hh>
+#include <dune/common/hash.hh>
+
+namespace Dune
+{
+  /**
+     \brief A hash set with open addressing that stores its elements in a flat array
+
+     FlatHashSet has the interface of std::unordered_set, except for the
+     bucket interface, and is implemented like FlatHashMap.
+
+     \note Inserting elements invalidates iterators, pointers and references
+           to elements if the table grows.
+
+     \tparam Key       The type of the elements.
+     \tparam Hash      The hash function of the elements, the bits of its result are mixed again.
+     \tparam KeyEqual  The equality comparison of the elements.
+   */
+  template<class Key, class Hash = Dune::hash<Key>, class KeyEqual = std::equal_to<Key>>
+  class FlatHashSet
+    : public Impl::FlatHashTable<Impl::FlatHashSetPolicy<Key>, Hash, KeyEqual>
+  {
+    using Base = Impl::FlatHashTable<Impl::FlatHashSetPolicy<Key>, Hash, KeyEqual>;
+
+  public:
+    using Base::Base;
+  };
+
+}
+
+#endif // DUNE_COMMON_FLATHASHSET_HH
@@ -0,0 +1,933 @@
+// -*- tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 2 -*-
+// vi: set et ts=4 sw=2 sts=2:
+// SPDX-FileCopyrightInfo: Copyright © DUNE Project contributors, see file LICENSE.md in module root
+// SPDX-License-Identifier: LicenseRef-GPL-2.0-only-with-DUNE-exception
+#ifndef DUNE_COMMON_FLATHASHTABLE_HH
+#define DUNE_COMMON_FLATHASHTABLE_HH
+
+/** \file
+ * \brief Implementation of the open-addressing hash table behind FlatHashMap and FlatHashSet
+ */
+
+#include <algorithm>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <initializer_list>
+#include <iterator>
+#include <memory>
+#include <type_traits>
+#include <utility>
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+#include <dune/common/hash.hh>
+
+namespace Dune::Impl {
+
+  /* The table stores the elements in an array of slots and one control byte
+   * per slot. A control byte is either empty, deleted, or stores the lowest
+   * seven bits of the hash of the element in the slot. Lookups compare the
+   * control bytes of a group of consecutive slots at once and only compare
+   * the keys of slots whose control byte matches. The first group width
+   * control bytes are mirrored at the end of the control array, so that a
+   * group can be loaded at every position without wrapping around.
+   */
+
+  //! Control byte of a slot that was never used
+  inline constexpr std::int8_t flatHashEmpty = -128;
+
+  //! Control byte of a slot whose element was erased
+  inline constexpr std::int8_t flatHashDeleted = -2;
+
+  //! Whether a control byte belongs to a slot with an element
+  inline constexpr bool flatHashIsFull (std::int8_t ctrl) noexcept
+  {
+    return ctrl >= 0;
+  }
+
+  /** \brief Mix the bits of a hash value
+   *
+   * Hashes of integers are often the identity. The table uses the lowest
+   * seven bits and the upper bits of the hash, so all bits have to depend
+   * on all bits of the key. This is the finalizer of MurmurHash3.
+   */
+  inline constexpr std::size_t flatHashMix (std::size_t h) noexcept
+  {
+    if constexpr (sizeof(std::size_t) >= 8)
+    {
+      std::uint64_t x = h;
+      x ^= x >> 33;
+      x *= 0xff51afd7ed558ccdULL;
+      x ^= x >> 33;
+      x *= 0xc4ceb9fe1a85ec53ULL;
+      x ^= x >> 33;
+      return std::size_t(x);
+    }
+    else
+    {
+      std::uint32_t x = h;
+      x ^= x >> 16;
+      x *= 0x85ebca6bU;
+      x ^= x >> 13;
+      x *= 0xc2b2ae35U;
+      x ^= x >> 16;
+      return std::size_t(x);
+    }
+  }
+
+  /** \brief Set of positions in a group, iterable in increasing order
+   *
+   * \tparam T      unsigned integer holding the mask
+   * \tparam shift  log2 of the number of bits per position
+   * \tparam width  number of positions in a group
+   */
+  template<class T, int shift, int width>
+  class FlatHashBitMask
+  {
+  public:
+    explicit FlatHashBitMask (T mask) noexcept
+      : mask_(mask)
+    {}
+
+    explicit operator bool () const noexcept
+    {
+      return mask_ != 0;
+    }
+
+    //! The lowest position in the set
+    int lowest () const noexcept
+    {
+      return std::countr_zero(mask_) >> shift;
+    }
+
+    //! Number of positions below the lowest position in the set
+    int trailingZeros () const noexcept
+    {
+      return std::countr_zero(mask_) >> shift;
+    }
+
+    //! Number of positions above the highest position in the set
+    int leadingZeros () const noexcept
+    {
+      constexpr int unused = int(sizeof(T) * 8) - (width << shift);
+      return (std::countl_zero(mask_) - unused) >> shift;
+    }
+
+    // iteration over the positions
+    FlatHashBitMask begin () const noexcept { return *this; }
+    FlatHashBitMask end () const noexcept { return FlatHashBitMask(0); }
+    int operator* () const noexcept { return lowest(); }
+    FlatHashBitMask& operator++ () noexcept { mask_ &= mask_ - 1; return *this; }
+    bool operator!= (const FlatHashBitMask& other) const noexcept { return mask_ != other.mask_; }
+
+  private:
+    T mask_;
+  };
+
+  //! Group of 8 control bytes compared with integer arithmetic
+  class FlatHashGroupPortable
+  {
+    static constexpr std::uint64_t lsbs = 0x0101010101010101ULL;
+    static constexpr std::uint64_t msbs = 0x8080808080808080ULL;
+
+  public:
+    static constexpr std::size_t width = 8;
+    using BitMask = FlatHashBitMask<std::uint64_t, 3, 8>;
+
+    explicit FlatHashGroupPortable (const std::int8_t* ctrl) noexcept
+      : ctrl_(0)
+    {
+      // byte i of the group is stored in bits 8i to 8i+7, independent of the byte order
+      for (std::size_t i = 0; i < width; ++i)
+        ctrl_ |= std::uint64_t(std::uint8_t(ctrl[i])) << (8 * i);
+    }
+
+    /** \brief Positions whose control byte equals h2
+     *
+     * May contain false positives, which are always full slots.
+     */
+    BitMask match (std::int8_t h2) const noexcept
+    {
+      const std::uint64_t x = ctrl_ ^ (lsbs * std::uint8_t(h2));
+      return BitMask((x - lsbs) & ~x & msbs);
+    }
+
+    //! Positions of empty slots
+    BitMask maskEmpty () const noexcept
+    {
+      return BitMask(ctrl_ & (~ctrl_ << 6) & msbs);
+    }
+
+    //! Positions of empty and deleted slots
+    BitMask maskEmptyOrDeleted () const noexcept
+    {
+      return BitMask(ctrl_ & (~ctrl_ << 7) & msbs);
+    }
+
+    //! Positions of full slots
+    BitMask maskFull () const noexcept
+    {
+      return BitMask(~ctrl_ & msbs);
+    }
+
+  private:
+    std::uint64_t ctrl_;
+  };
+
+#if defined(__SSE2__)
+  //! Group of 16 control bytes compared with SSE2 instructions
+  class FlatHashGroupSSE2
+  {
+  public:
+    static constexpr std::size_t width = 16;
+    using BitMask = FlatHashBitMask<std::uint32_t, 0, 16>;
+
+    explicit FlatHashGroupSSE2 (const std::int8_t* ctrl) noexcept
+      : ctrl_(_mm_loadu_si128(reinterpret_cast<const __m128i*>(ctrl)))
+    {}
+
+    //! Positions whose control byte equals h2
+    BitMask match (std::int8_t h2) const noexcept
+    {
+      return BitMask(_mm_movemask_epi8(_mm_cmpeq_epi8(_mm_set1_epi8(h2), ctrl_)));
+    }
+
+    //! Positions of empty slots
+    BitMask maskEmpty () const noexcept
+    {
+      return BitMask(_mm_movemask_epi8(_mm_cmpeq_epi8(_mm_set1_epi8(flatHashEmpty), ctrl_)));
+    }
+
+    //! Positions of empty and deleted slots
+    BitMask maskEmptyOrDeleted () const noexcept
+    {
+      return BitMask(_mm_movemask_epi8(_mm_cmpgt_epi8(_mm_set1_epi8(-1), ctrl_)));
+    }
+
+    //! Positions of full slots
+    BitMask maskFull () const noexcept
+    {
+      return BitMask(_mm_movemask_epi8(ctrl_) ^ 0xffff);
+    }
+
+  private:
+    __m128i ctrl_;
+  };
+
+  using FlatHashGroup = FlatHashGroupSSE2;
+#else
+  using FlatHashGroup = FlatHashGroupPortable;
+#endif
+
+  //! Element access of the table behind FlatHashMap
+  template<class K, class V>
+  struct FlatHashMapPolicy
+  {
+    using key_type = K;
+    using value_type = std::pair<const K, V>;
+    static constexpr bool constantIterator = false;
+
+    static const K& key (const value_type& value) noexcept
+    {
+      return value.first;
+    }
+  };
+
+  //! Element access of the table behind FlatHashSet
+  template<class K>
+  struct FlatHashSetPolicy
+  {
+    using key_type = K;
+    using value_type = K;
+    static constexpr bool constantIterator = true;
+
+    static const K& key (const value_type& value) noexcept
+    {
+      return value;
+    }
+  };
+
+  /** \brief Open-addressing hash table with control bytes probed group-wise
+   *
+   * \tparam Policy    Defines key_type, value_type and the key of a value.
+   * \tparam Hash      Hash function of the keys.
+   * \tparam KeyEqual  Equality comparison of the keys.
+   */
+  template<class Policy, class Hash, class KeyEqual>
+  class FlatHashTable
+  {
+    using Group = FlatHashGroup;
+    static constexpr std::size_t width = Group::width;
+
+  public:
+    using key_type = typename Policy::key_type;
+    using value_type = typename Policy::value_type;
+    using size_type = std::size_t;
+    using difference_type = std::ptrdiff_t;
+    using hasher = Hash;
+    using key_equal = KeyEqual;
+    using reference = value_type&;
+    using const_reference = const value_type&;
+    using pointer = value_type*;
+    using const_pointer = const value_type*;
+
+  private:
+    using allocator_type = std::allocator<value_type>;
+    using allocator_traits = std::allocator_traits<allocator_type>;
+    using ctrl_allocator_type = std::allocator<std::int8_t>;
+
+    template<bool isConst>
+    class Iterator
+    {
+      friend class FlatHashTable;
+      friend class Iterator<!isConst>;
+
+    public:
+      using iterator_category = std::forward_iterator_tag;
+      using value_type = typename FlatHashTable::value_type;
+      using difference_type = std::ptrdiff_t;
+      using pointer = std::conditional_t<isConst, const value_type*, value_type*>;
+      using reference = std::conditional_t<isConst, const value_type&, value_type&>;
+
+      Iterator () = default;
+
+      //! Conversion of a mutable into a constant iterator
+      template<bool c = isConst>
+        requires c
+      Iterator (const Iterator<false>& other) noexcept
+        : ctrl_(other.ctrl_), end_(other.end_), slot_(other.slot_)
+      {}
+
+      reference operator* () const noexcept
+      {
+        return *slot_;
+      }
+
+      pointer operator-> () const noexcept
+      {
+        return slot_;
+      }
+
+      Iterator& operator++ () noexcept
+      {
+        ++ctrl_;
+        ++slot_;
+        skipFree();
+        return *this;
+      }
+
+      Iterator operator++ (int) noexcept
+      {
+        Iterator tmp = *this;
+        ++*this;
+        return tmp;
+      }
+
+      friend bool operator== (const Iterator& a, const Iterator& b) noexcept
+      {
+        return a.ctrl_ == b.ctrl_;
+      }
+
+    private:
+      Iterator (const std::int8_t* ctrl, const std::int8_t* end, pointer slot) noexcept
+        : ctrl_(ctrl), end_(end), slot_(slot)
+      {}
+
+      // advance to the next full slot or the end
+      void skipFree () noexcept
+      {
+        while (ctrl_ < end_ && !flatHashIsFull(*ctrl_))
+        {
+          const auto full = Group(ctrl_).maskFull();
+          const std::size_t shift = std::min<std::size_t>(full ? full.lowest() : width, end_ - ctrl_);
+          ctrl_ += shift;
+          slot_ += shift;
+        }
+      }
+
+      const std::int8_t* ctrl_ = nullptr;
+      const std::int8_t* end_ = nullptr;
+      pointer slot_ = nullptr;
+    };
+
+  public:
+    using iterator = Iterator<Policy::constantIterator>;
+    using const_iterator = Iterator<true>;
+
+    /** @{ Constructors */
+
+    //! Constructs an empty table without allocating memory
+    FlatHashTable () = default;
+
+    //! Constructs an empty table with at least `bucketCount` slots
+    explicit FlatHashTable (size_type bucketCount, const Hash& hash = Hash(), const KeyEqual& equal = KeyEqual())
+      : hash_(hash), equal_(equal)
+    {
+      rehash(bucketCount);
+    }
+
+    //! Constructs the table from the values in the iterator range `[first,last)`
+    template<std::input_iterator InputIt>
+    FlatHashTable (InputIt first, InputIt last, size_type bucketCount = 0,
+                   const Hash& hash = Hash(), const KeyEqual& equal = KeyEqual())
+      : FlatHashTable(bucketCount, hash, equal)
+    {
+      insert(first, last);
+    }
+
+    //! Constructs the table from the values in an initializer list
+    FlatHashTable (std::initializer_list<value_type> l, size_type bucketCount = 0,
+                   const Hash& hash = Hash(), const KeyEqual& equal = KeyEqual())
+      : FlatHashTable(l.begin(), l.end(), bucketCount, hash, equal)
+    {}
+
+    FlatHashTable (const FlatHashTable& other)
+      : hash_(other.hash_), equal_(other.equal_)
+    {
+      reserve(other.size_);
+      for (const value_type& value : other)
+      {
+        const size_type hash = hashOf(Policy::key(value));
+        const size_type i = findFirstNonFull(hash);
+        std::construct_at(slots_ + i, value);
+        setInserted(i, hash);
+      }
+    }
+
+    FlatHashTable (FlatHashTable&& other) noexcept
+      : ctrl_(std::exchange(other.ctrl_, nullptr))
+      , slots_(std::exchange(other.slots_, nullptr))
+      , capacity_(std::exchange(other.capacity_, 0))
+      , size_(std::exchange(other.size_, 0))
+      , growthLeft_(std::exchange(other.growthLeft_, 0))
+      , hash_(other.hash_), equal_(other.equal_)
+    {}
+
+    ~FlatHashTable ()
+    {
+      destroySlots();
+      deallocate();
+    }
+
+    FlatHashTable& operator= (const FlatHashTable& other)
+    {
+      if (this != &other)
+      {
+        FlatHashTable tmp(other);
+        swap(tmp);
+      }
+      return *this;
+    }
+
+    FlatHashTable& operator= (FlatHashTable&& other) noexcept
+    {
+      if (this != &other)
+      {
+        FlatHashTable tmp(std::move(other));
+        swap(tmp);
+      }
+      return *this;
+    }
+
+    FlatHashTable& operator= (std::initializer_list<value_type> l)
+    {
+      clear();
+      insert(l);
+      return *this;
+    }
+
+    /** @} */
+
+    /** @{ Iterators */
+
+    iterator begin () noexcept
+    {
+      iterator it = iteratorAt(0);
+      it.skipFree();
+      return it;
+    }
+
+    const_iterator begin () const noexcept
+    {
+      const_iterator it = iteratorAt(0);
+      it.skipFree();
+      return it;
+    }
+
+    const_iterator cbegin () const noexcept
+    {
+      return begin();
+    }
+
+    iterator end () noexcept
+    {
+      return iteratorAt(capacity_);
+    }
+
+    const_iterator end () const noexcept
+    {
+      return iteratorAt(capacity_);
+    }
+
+    const_iterator cend () const noexcept
+    {
+      return end();
+    }
+
+    /** @} */
+
+    /** @{ Capacity */
+
+    //! Whether the table has no elements
+    bool empty () const noexcept
+    {
+      return size_ == 0;
+    }
+
+    //! Number of elements
+    size_type size () const noexcept
+    {
+      return size_;
+    }
+
+    //! Maximal number of elements
+    size_type max_size () const noexcept
+    {
+      return allocator_traits::max_size(allocator_type()) / 2;
+    }
+
+    //! Number of slots
+    size_type bucket_count () const noexcept
+    {
+      return capacity_;
+    }
+
+    //! Ratio of the number of elements and slots
+    float load_factor () const noexcept
+    {
+      return capacity_ > 0 ? float(size_) / float(capacity_) : 0.0f;
+    }
+
+    //! The table grows if it would be filled by more than this ratio, including erased slots
+    static constexpr float max_load_factor () noexcept
+    {
+      return 0.875f;
+    }
+
+    //! Bytes of memory used by the table, including the memory on the heap
+    size_type memoryUsage () const noexcept
+    {
+      return sizeof(*this) + (capacity_ > 0 ? capacity_ * sizeof(value_type) + capacity_ + width : 0);
+    }
+
+    //! Allocates memory for at least `count` elements
+    void reserve (size_type count)
+    {
+      if (count > size_ + growthLeft_)
+        resize(capacityFor(count));
+    }
+
+    /** \brief Sets the number of slots to at least `count` and at least the number needed by the elements
+     *
+     * `rehash(0)` releases the memory of an empty table and removes erased slots.
+     */
+    void rehash (size_type count)
+    {
+      size_type newCapacity = capacityFor(size_);
+      if (count > newCapacity)
+        newCapacity = std::bit_ceil(std::max(count, width));
+      if (newCapacity != capacity_ || size_ + growthLeft_ < maxLoad(capacity_))
+        resize(newCapacity);
+    }
+
+    /** @} */
+
+    /** @{ Modifiers */
+
+    //! Erases all elements, the number of slots is unchanged
+    void clear () noexcept
+    {
+      destroySlots();
+      if (capacity_ > 0)
+        std::fill_n(ctrl_, capacity_ + width, flatHashEmpty);
+      size_ = 0;
+      growthLeft_ = maxLoad(capacity_);
+    }
+
+    //! Inserts a copy of `value` if its key is not contained yet
+    std::pair<iterator,bool> insert (const value_type& value)
+    {
+      return findOrInsert(Policy::key(value), [&](pointer p) { std::construct_at(p, value); });
+    }
+
+    //! Inserts `value` by moving it if its key is not contained yet
+    std::pair<iterator,bool> insert (value_type&& value)
+    {
+      return findOrInsert(Policy::key(value), [&](pointer p) { std::construct_at(p, std::move(value)); });
+    }
+
+    //! Inserts the values of the iterator range `[first,last)` whose keys are not contained yet
+    template<std::input_iterator InputIt>
+    void insert (InputIt first, InputIt last)
+    {
+      if constexpr (std::forward_iterator<InputIt>)
+        reserve(size_ + std::distance(first, last));
+      for (; first != last; ++first)
+        emplace(*first);
+    }
+
+    //! Inserts the values of an initializer list whose keys are not contained yet
+    void insert (std::initializer_list<value_type> l)
+    {
+      insert(l.begin(), l.end());
+    }
+
+    //! Constructs a value from the arguments and inserts it if its key is not contained yet
+    template<class... Args>
+    std::pair<iterator,bool> emplace (Args&&... args)
+    {
+      value_type value(std::forward<Args>(args)...);
+      return insert(std::move(value));
+    }
+
+    //! Erases the element at `pos` and returns an iterator to the next element
+    iterator erase (const_iterator pos)
+    {
+      const size_type i = pos.ctrl_ - ctrl_;
+      eraseAt(i);
+      iterator next = iteratorAt(i);
+      next.skipFree();
+      return next;
+    }
+
+    //! Erases the elements in the range `[first,last)`
+    iterator erase (const_iterator first, const_iterator last)
+    {
+      for (; first != last; ++first)
+        eraseAt(first.ctrl_ - ctrl_);
+      return iteratorAt(last.ctrl_ - ctrl_);
+    }
+
+    //! Erases the element with the given key and returns the number of erased elements
+    size_type erase (const key_type& key)
+    {
+      const size_type i = findIndex(key);
+      if (i == capacity_)
+        return 0;
+      eraseAt(i);
+      return 1;
+    }
+
+    void swap (FlatHashTable& other) noexcept
+    {
+      using std::swap;
+      swap(ctrl_, other.ctrl_);
+      swap(slots_, other.slots_);
+      swap(capacity_, other.capacity_);
+      swap(size_, other.size_);
+      swap(growthLeft_, other.growthLeft_);
+      swap(hash_, other.hash_);
+      swap(equal_, other.equal_);
+    }
+
+    friend void swap (FlatHashTable& a, FlatHashTable& b) noexcept
+    {
+      a.swap(b);
+    }
+
+    /** @} */
+
+    /** @{ Lookup */
+
+    //! Returns an iterator to the element with the given key or end()
+    iterator find (const key_type& key)
+    {
+      return iteratorAt(findIndex(key));
+    }
+
+    //! Returns an iterator to the element with the given key or end()
+    const_iterator find (const key_type& key) const
+    {
+      return iteratorAt(findIndex(key));
+    }
+
+    //! Whether an element with the given key is contained
+    bool contains (const key_type& key) const
+    {
+      return findIndex(key) != capacity_;
+    }
+
+    //! Number of elements with the given key, 0 or 1
+    size_type count (const key_type& key) const
+    {
+      return contains(key) ? 1 : 0;
+    }
+
+    /** @} */
+
+    hasher hash_function () const
+    {
+      return hash_;
+    }
+
+    key_equal key_eq () const
+    {
+      return equal_;
+    }
+
+    //! Whether both tables contain the same values
+    friend bool operator== (const FlatHashTable& a, const FlatHashTable& b)
+    {
+      if (a.size() != b.size())
+        return false;
+      for (const value_type& value : a)
+      {
+        auto it = b.find(Policy::key(value));
+        if (it == b.end() || !(*it == value))
+          return false;
+      }
+      return true;
+    }
+
+  protected:
+    /** \brief Returns the element with the key or inserts a new one
+     *
+     * If the key is not contained, `construct(p)` must construct a value
+     * with this key at `p`. The arguments of `construct` must not refer to
+     * elements of the table, which may be moved before the construction.
+     */
+    template<class Construct>
+    std::pair<iterator,bool> findOrInsert (const key_type& key, Construct&& construct)
+    {
+      const size_type hash = hashOf(key);
+      const size_type found = findIndex(key, hash);
+      if (found != capacity_)
+        return {iteratorAt(found), false};
+      const size_type i = prepareInsert(hash);
+      construct(slots_ + i);
+      setInserted(i, hash);
+      return {iteratorAt(i), true};
+    }
+
+  private:
+    static constexpr std::int8_t h2 (size_type hash) noexcept
+    {
+      return std::int8_t(hash & 0x7f);
+    }
+
+    static constexpr size_type h1 (size_type hash) noexcept
+    {
+      return hash >> 7;
+    }
+
+    // number of elements that fit into `capacity` slots
+    static constexpr size_type maxLoad (size_type capacity) noexcept
+    {
+      return capacity - capacity / 8;
+    }
+
+    // number of slots needed for `count` elements
+    static size_type capacityFor (size_type count) noexcept
+    {
+      if (count == 0)
+        return 0;
+      size_type capacity = width;
+      while (maxLoad(capacity) < count)
+        capacity *= 2;
+      return capacity;
+    }
+
+    size_type hashOf (const key_type& key) const
+    {
+      return flatHashMix(hash_(key));
+    }
+
+    iterator iteratorAt (size_type i) noexcept
+    {
+      return iterator(ctrl_ + i, ctrl_ + capacity_, slots_ + i);
+    }
+
+    const_iterator iteratorAt (size_type i) const noexcept
+    {
+      return const_iterator(ctrl_ + i, ctrl_ + capacity_, slots_ + i);
+    }
+
+    // sets the control byte of slot i and its mirror
+    void setCtrl (size_type i, std::int8_t ctrl) noexcept
+    {
+      ctrl_[i] = ctrl;
+      if (i < width)
+        ctrl_[capacity_ + i] = ctrl;
+    }
+
+    // returns the slot of the key or capacity_
+    size_type findIndex (const key_type& key) const
+    {
+      if (size_ == 0)
+        return capacity_;
+      return findIndex(key, hashOf(key));
+    }
+
+    size_type findIndex (const key_type& key, size_type hash) const
+    {
+      if (size_ == 0)
+        return capacity_;
+      const size_type mask = capacity_ - 1;
+      size_type pos = h1(hash) & mask;
+      // triangular probing visits every group once if the capacity is a power of two
+      for (size_type step = width; ; pos = (pos + step) & mask, step += width)
+      {
+        const Group group(ctrl_ + pos);
+        for (int j : group.match(h2(hash)))
+        {
+          const size_type i = (pos + j) & mask;
+          if (equal_(Policy::key(slots_[i]), key))
+            return i;
+        }
+        if (group.maskEmpty())
+          return capacity_;
+      }
+    }
+
+    // the first empty or deleted slot in the probe sequence of the hash
+    size_type findFirstNonFull (size_type hash) const noexcept
+    {
+      const size_type mask = capacity_ - 1;
+      size_type pos = h1(hash) & mask;
+      for (size_type step = width; ; pos = (pos + step) & mask, step += width)
+      {
+        const auto free = Group(ctrl_ + pos).maskEmptyOrDeleted();
+        if (free)
+          return (pos + free.lowest()) & mask;
+      }
+    }
+
+    // find the slot for a new element, growing the table if necessary
+    size_type prepareInsert (size_type hash)
+    {
+      if (capacity_ > 0)
+      {
+        const size_type i = findFirstNonFull(hash);
+        if (growthLeft_ > 0 || ctrl_[i] == flatHashDeleted)
+          return i;
+      }
+      if (capacity_ == 0)
+        resize(width);
+      else if (size_ <= maxLoad(capacity_) / 2)
+        // many erased slots, clean up without growing
+        resize(capacity_);
+      else
+        resize(2 * capacity_);
+      return findFirstNonFull(hash);
+    }
+
+    void setInserted (size_type i, size_type hash) noexcept
+    {
+      if (ctrl_[i] == flatHashEmpty)
+        --growthLeft_;
+      setCtrl(i, h2(hash));
+      ++size_;
+    }
+
+    void eraseAt (size_type i)
+    {
+      std::destroy_at(slots_ + i);
+      --size_;
+      // the slot can be marked empty if no probe sequence has passed a full group around it
+      const size_type before = (i - width) & (capacity_ - 1);
+      const auto emptyBefore = Group(ctrl_ + before).maskEmpty();
+      const auto emptyAfter = Group(ctrl_ + i).maskEmpty();
+      if (emptyBefore && emptyAfter
+          && std::size_t(emptyAfter.trailingZeros() + emptyBefore.leadingZeros()) < width)
+      {
+        setCtrl(i, flatHashEmpty);
+        ++growthLeft_;
+      }
+      else
+        setCtrl(i, flatHashDeleted);
+    }
+
+    // move all elements into a new array of `capacity` slots
+    void resize (size_type capacity)
+    {
+      std::int8_t* oldCtrl = ctrl_;
+      pointer oldSlots = slots_;
+      const size_type oldCapacity = capacity_;
+
+      if (capacity > 0)
+      {
+        ctrl_allocator_type ctrlAllocator;
+        allocator_type allocator;
+        ctrl_ = ctrlAllocator.allocate(capacity + width);
+        try {
+          slots_ = allocator_traits::allocate(allocator, capacity);
+        }
+        catch (...) {
+          ctrlAllocator.deallocate(ctrl_, capacity + width);
+          ctrl_ = oldCtrl;
+          throw;
+        }
+        std::fill_n(ctrl_, capacity + width, flatHashEmpty);
+      }
+      else
+      {
+        ctrl_ = nullptr;
+        slots_ = nullptr;
+      }
+      capacity_ = capacity;
+      growthLeft_ = maxLoad(capacity) - size_;
+
+      for (size_type i = 0; i < oldCapacity; ++i)
+        if (flatHashIsFull(oldCtrl[i]))
+        {
+          const size_type hash = hashOf(Policy::key(oldSlots[i]));
+          const size_type j = findFirstNonFull(hash);
+          setCtrl(j, h2(hash));
+          std::construct_at(slots_ + j, std::move(oldSlots[i]));
+          std::destroy_at(oldSlots + i);
+        }
+
+      deallocate(oldCtrl, oldSlots, oldCapacity);
+    }
+
+    void destroySlots () noexcept
+    {
+      if constexpr (!std::is_trivially_destructible_v<value_type>)
+        for (size_type i = 0; i < capacity_; ++i)
+          if (flatHashIsFull(ctrl_[i]))
+            std::destroy_at(slots_ + i);
+    }
+
+    static void deallocate (std::int8_t* ctrl, pointer slots, size_type capacity) noexcept
+    {
+      if (capacity > 0)
+      {
+        ctrl_allocator_type ctrlAllocator;
+        allocator_type allocator;
+        ctrlAllocator.deallocate(ctrl, capacity + width);
+        allocator_traits::deallocate(allocator, slots, capacity);
+      }
+    }
+
+    void deallocate () noexcept
+    {
+      deallocate(ctrl_, slots_, capacity_);
+    }
+
+    std::int8_t* ctrl_ = nullptr;
+    pointer slots_ = nullptr;
+    size_type capacity_ = 0;
+    size_type size_ = 0;
+    // number of empty slots that can be filled before the table grows
+    size_type growthLeft_ = 0;
+    [[no_unique_address]] Hash hash_ = {};
+    [[no_unique_address]] KeyEqual equal_ = {};
+  };
+
+} // end namespace Dune::Impl
+
+#endif // DUNE_COMMON_FLATHASHTABLE_HH
@@ -5,7 +5,15 @@
 #ifndef DUNE_COMMON_HASH_HH
 #define DUNE_COMMON_HASH_HH
 
+#include <cstdint>
+#include <cstring>
 #include <functional>
+#include <iterator>
+#include <memory>
+#include <ranges>
+#include <tuple>
+#include <type_traits>
+#include <utility>
 
 #include <dune/common/typetraits.hh>
 
@@ -346,6 +354,248 @@ namespace Dune {
     }
   }
 
+
+  // ********************************************************************************
+  // High-throughput hashing of byte sequences, ranges and tuples.
+  // ********************************************************************************
+
+#ifndef DOXYGEN
+
+  namespace Impl {
+
+    // The following functions implement the hash function wyhash (final version 4.2) by
+    // Wang Yi (https://github.com/wangyi-fudan/wyhash, released into the public domain). It
+    // reads the input in words of 8 bytes and mixes them by a 64x64->128 bit multiplication.
+    // Inputs longer than 48 bytes are processed in three independent lanes, which keeps
+    // several multiplications in flight at the same time.
+
+    inline constexpr std::uint64_t wyhashSecret[4] = {
+      0x2d358dccaa6c78a5ull, 0x8bb84b93962eacc9ull, 0x4b33a62ed433d4a3ull, 0x4d5a2da51de1aa47ull
+    };
+
+    // multiply a and b and store the low bits of the product in a and the high bits in b
+    inline void wyhashMultiply (std::uint64_t& a, std::uint64_t& b)
+    {
+#ifdef __SIZEOF_INT128__
+      __uint128_t r = a;
+      r *= b;
+      a = std::uint64_t(r);
+      b = std::uint64_t(r >> 64);
+#else
+      const std::uint64_t ha = a >> 32, hb = b >> 32, la = std::uint32_t(a), lb = std::uint32_t(b);
+      const std::uint64_t rh = ha * hb, rm0 = ha * lb, rm1 = hb * la, rl = la * lb;
+      const std::uint64_t t = rl + (rm0 << 32);
+      std::uint64_t c = t < rl;
+      const std::uint64_t lo = t + (rm1 << 32);
+      c += lo < t;
+      a = lo;
+      b = rh + (rm0 >> 32) + (rm1 >> 32) + c;
+#endif
+    }
+
+    inline std::uint64_t wyhashMix (std::uint64_t a, std::uint64_t b)
+    {
+      wyhashMultiply(a, b);
+      return a ^ b;
+    }
+
+    inline std::uint64_t wyhashRead8 (const unsigned char* p)
+    {
+      std::uint64_t v;
+      std::memcpy(&v, p, 8);
+      return v;
+    }
+
+    inline std::uint64_t wyhashRead4 (const unsigned char* p)
+    {
+      std::uint32_t v;
+      std::memcpy(&v, p, 4);
+      return v;
+    }
+
+    // read 1 to 3 bytes
+    inline std::uint64_t wyhashRead3 (const unsigned char* p, std::size_t k)
+    {
+      return (std::uint64_t(p[0]) << 16) | (std::uint64_t(p[k >> 1]) << 8) | p[k - 1];
+    }
+
+    // integral values and enumerations enter the hash of tuples and non-contiguous ranges
+    // directly, all other values through their Dune::hash
+    template<class T>
+    std::uint64_t wyhashValue (const T& value)
+    {
+      if constexpr (std::is_integral_v<T>)
+        return std::uint64_t(value);
+      else if constexpr (std::is_enum_v<T>)
+        return std::uint64_t(std::underlying_type_t<T>(value));
+      else
+        return std::uint64_t(Dune::hash<T>()(value));
+    }
+
+    template<class T>
+    concept TupleLike = requires { std::tuple_size<std::remove_cvref_t<T>>::value; };
+
+  } // end namespace Impl
+
+#endif // DOXYGEN
+
+  //! Calculates a hash value of the bytes [data,data+len) with the hash function wyhash.
+  /**
+   * The hash depends on the byte order of the platform, so it must not be stored or
+   * communicated between different architectures.
+   *
+   * \param data  Pointer to the first byte to hash.
+   * \param len   Number of bytes to hash.
+   * \param seed  Start value, different seeds result in independent hash functions.
+   */
+  inline std::uint64_t hash_bytes (const void* data, std::size_t len, std::uint64_t seed = 0)
+  {
+    using namespace Impl;
+    const auto* p = static_cast<const unsigned char*>(data);
+    const auto& secret = wyhashSecret;
+    seed ^= wyhashMix(seed ^ secret[0], secret[1]);
+    std::uint64_t a, b;
+    if (len <= 16)
+    {
+      if (len >= 4)
+      {
+        a = (wyhashRead4(p) << 32) | wyhashRead4(p + ((len >> 3) << 2));
+        b = (wyhashRead4(p + len - 4) << 32) | wyhashRead4(p + len - 4 - ((len >> 3) << 2));
+      }
+      else if (len > 0)
+      {
+        a = wyhashRead3(p, len);
+        b = 0;
+      }
+      else
+        a = b = 0;
+    }
+    else
+    {
+      std::size_t i = len;
+      if (i > 48)
+      {
+        std::uint64_t see1 = seed, see2 = seed;
+        do {
+          seed = wyhashMix(wyhashRead8(p) ^ secret[1], wyhashRead8(p + 8) ^ seed);
+          see1 = wyhashMix(wyhashRead8(p + 16) ^ secret[2], wyhashRead8(p + 24) ^ see1);
+          see2 = wyhashMix(wyhashRead8(p + 32) ^ secret[3], wyhashRead8(p + 40) ^ see2);
+          p += 48;
+          i -= 48;
+        } while (i > 48);
+        seed ^= see1 ^ see2;
+      }
+      while (i > 16)
+      {
+        seed = wyhashMix(wyhashRead8(p) ^ secret[1], wyhashRead8(p + 8) ^ seed);
+        i -= 16;
+        p += 16;
+      }
+      a = wyhashRead8(p + i - 16);
+      b = wyhashRead8(p + i - 8);
+    }
+    a ^= secret[1];
+    b ^= seed;
+    wyhashMultiply(a, b);
+    return wyhashMix(a ^ secret[0] ^ len, b ^ secret[1]);
+  }
+
+  //! Hash policy that combines the hashes of all elements with hash_combine().
+  /**
+   * This is the algorithm of hash_range(). It is cheap for very short ranges, but
+   * processes one element after the other.
+   */
+  struct HashCombinePolicy
+  {
+    template<typename It>
+    static std::size_t hashRange (It first, It last)
+    {
+      return hash_range(first, last);
+    }
+
+    template<typename Tuple>
+    static std::size_t hashTuple (const Tuple& tuple)
+    {
+      std::size_t seed = 0;
+      std::apply([&](const auto&... args) { (hash_combine(seed, args), ...); }, tuple);
+      return seed;
+    }
+  };
+
+  //! Hash policy based on the hash function wyhash.
+  /**
+   * Contiguous ranges of objects whose value is determined by their bytes, i.e., of
+   * types with `std::has_unique_object_representations`, like integers and arrays or
+   * trivial structs of integers without padding, are hashed as one byte sequence with
+   * hash_bytes(). The elements of other ranges and of tuples are mixed one at a time with
+   * a full 64x64->128 bit multiplication, which distributes dense integer values like
+   * entity indices or multi-indices evenly over all bits of the hash.
+   */
+  struct WyHashPolicy
+  {
+    template<typename It>
+    static std::size_t hashRange (It first, It last)
+    {
+      using T = std::iter_value_t<It>;
+      if constexpr (std::contiguous_iterator<It> && std::has_unique_object_representations_v<T>)
+        return std::size_t(hash_bytes(std::to_address(first), std::size_t(last - first) * sizeof(T)));
+      else
+      {
+        std::uint64_t h = Impl::wyhashSecret[0];
+        std::uint64_t n = 0;
+        for (; first != last; ++first, ++n)
+          h = Impl::wyhashMix(h ^ Impl::wyhashSecret[1], Impl::wyhashValue(*first) ^ Impl::wyhashSecret[2]);
+        return std::size_t(Impl::wyhashMix(h ^ n, Impl::wyhashSecret[3]));
+      }
+    }
+
+    template<typename Tuple>
+    static std::size_t hashTuple (const Tuple& tuple)
+    {
+      std::uint64_t h = Impl::wyhashSecret[0];
+      std::apply([&](const auto&... args) {
+        ((h = Impl::wyhashMix(h ^ Impl::wyhashSecret[1], Impl::wyhashValue(args) ^ Impl::wyhashSecret[2])), ...);
+      }, tuple);
+      return std::size_t(Impl::wyhashMix(h ^ std::tuple_size_v<Tuple>, Impl::wyhashSecret[3]));
+    }
+  };
+
+  //! Hashes all elements in the range [first,last) with the given hash policy.
+  /**
+   * \tparam Policy  HashCombinePolicy or WyHashPolicy.
+   */
+  template<typename Policy, typename It>
+  inline std::size_t hash_range(It first, It last)
+  {
+    return Policy::hashRange(first, last);
+  }
+
+  //! Functor for hashing ranges and tuples with a selectable hash policy.
+  /**
+   * Ranges, like `std::vector<int>` or `Dune::ReservedVector`, are hashed with
+   * `Policy::hashRange()`. Tuple-like types, like `std::pair`, `std::tuple` and
+   * `std::array`, are hashed with `Policy::hashTuple()` if they are not ranges. The
+   * functor can be used as the hash function of associative containers, e.g.
+   * \code
+   * Dune::FlatHashMap<std::array<int,3>, double, Dune::range_hash<>> map;
+   * \endcode
+   *
+   * \tparam Policy  HashCombinePolicy or WyHashPolicy.
+   */
+  template<typename Policy = WyHashPolicy>
+  struct range_hash
+  {
+    template<typename T>
+      requires std::ranges::range<const T&> || Impl::TupleLike<T>
+    std::size_t operator()(const T& arg) const
+    {
+      if constexpr (std::ranges::range<const T&>)
+        return Policy::hashRange(std::ranges::begin(arg), std::ranges::end(arg));
+      else
+        return Policy::hashTuple(arg);
+    }
+  };
+
 } // end namespace Dune
 
 #endif // DUNE_COMMON_HASH_HH
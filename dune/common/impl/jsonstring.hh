@@ -0,0 +1,38 @@
+// -*- tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 2 -*-
+// vi: set et ts=4 sw=2 sts=2:
+// SPDX-FileCopyrightInfo: Copyright © DUNE Project contributors, see file LICENSE.md in module root
+// SPDX-License-Identifier: LicenseRef-GPL-2.0-only-with-DUNE-exception
+#ifndef DUNE_COMMON_IMPL_JSONSTRING_HH
+#define DUNE_COMMON_IMPL_JSONSTRING_HH
+
+#include <ostream>
+#include <string_view>
+
+namespace Dune::Impl {
+
+  //! Write `s` as a quoted JSON string, escaping quotes, backslashes and control characters
+  inline void writeJSONString (std::ostream& stream, std::string_view s)
+  {
+    static const char* hex = "0123456789abcdef";
+    stream << '"';
+    for (char c : s)
+    {
+      switch (c) {
+      case '"' : stream << "\\\""; break;
+      case '\\' : stream << "\\\\"; break;
+      case '\n' : stream << "\\n"; break;
+      case '\t' : stream << "\\t"; break;
+      case '\r' : stream << "\\r"; break;
+      default :
+        if (static_cast<unsigned char>(c) < 0x20)
+          stream << "\\u00" << hex[(c >> 4) & 0xf] << hex[c & 0xf];
+        else
+          stream << c;
+      }
+    }
+    stream << '"';
+  }
+
+} // end namespace Dune::Impl
+
+#endif // DUNE_COMMON_IMPL_JSONSTRING_HH
@@ -18,6 +18,7 @@
 
 #include <dune/common/exceptions.hh>
 #include <dune/common/parallel/interface.hh>
+#include <dune/common/parallel/mpitracer.hh>
 #include <dune/common/parallel/remoteindices.hh>
 #include <dune/common/stdstreams.hh>
 
@@ -1062,6 +1063,9 @@ namespace Dune
   void DatatypeCommunicator<T>::sendRecv(MPI_Request* requests)
   {
     int noMessages = messageTypes.size();
+    MPITracer& tracer = MPITracer::instance();
+    const bool tracing = tracer.enabled();
+    const double post = tracing ? MPITracer::now() : 0.0;
     // Start the receive calls first
     MPI_Startall(noMessages, requests);
     // Now the send calls
@@ -1072,9 +1076,24 @@ namespace Dune
     for(int i=0; i<2*noMessages; i++)
       status[i].MPI_ERROR=MPI_SUCCESS;
 
+    const double startWait = tracing ? MPITracer::now() : 0.0;
     int send = MPI_Waitall(noMessages, requests+noMessages, status+noMessages);
     int receive = MPI_Waitall(noMessages, requests, status);
 
+    if(tracing) {
+      // the messages complete together, so every message is attributed the whole waiting time
+      const double complete = MPITracer::now();
+      const bool forward = (requests == requests_[1]);
+      const char* operation = forward ? "DatatypeCommunicator::forward" : "DatatypeCommunicator::backward";
+      for(const auto& process : messageTypes) {
+        int sendSize, recvSize;
+        MPI_Type_size(forward ? process.second.first : process.second.second, &sendSize);
+        MPI_Type_size(forward ? process.second.second : process.second.first, &recvSize);
+        tracer.record(operation, this->remoteIndices_->communicator(), process.first,
+                      sendSize, recvSize, post, complete, complete - startWait);
+      }
+    }
+
     // Error checks
     int success=1, globalSuccess=0;
     if(send==MPI_ERR_IN_STATUS) {
@@ -1407,8 +1426,13 @@ namespace Dune
     }
     typedef typename CommPolicy<Data>::IndexedTypeFlag Flag;
 
+    MPITracer& tracer = MPITracer::instance();
+    const bool tracing = tracer.enabled();
+    const char* operation = FORWARD ? "BufferedCommunicator::forward" : "BufferedCommunicator::backward";
+
     MessageGatherer<Data,GatherScatter,FORWARD,Flag>() (interfaces_, source, sendBuffer, sendBufferSize);
 
+    const double post = tracing ? MPITracer::now() : 0.0;
     MPI_Request* sendRequests = new MPI_Request[messageInformation_.size()];
     MPI_Request* recvRequests = new MPI_Request[messageInformation_.size()];
     /* Number of recvRequests that are not MPI_REQUEST_NULL */
@@ -1485,8 +1509,10 @@ namespace Dune
 
     for(i=0; i< numberOfRealRecvRequests; i++) {
       status.MPI_ERROR=MPI_SUCCESS;
+      const double startWait = tracing ? MPITracer::now() : 0.0;
       MPI_Waitany(messageInformation_.size(), recvRequests, &finished, &status);
       assert(finished != MPI_UNDEFINED);
+      const double received = tracing ? MPITracer::now() : 0.0;
 
       if(status.MPI_ERROR==MPI_SUCCESS) {
         int& proc = processMap[finished];
@@ -1496,6 +1522,9 @@ namespace Dune
         MessageInformation info = (FORWARD) ? infoIter->second.second : infoIter->second.first;
         assert(info.start_+info.size_ <= recvBufferSize);
 
+        if(tracing)
+          tracer.record(operation, communicator_, proc, 0, info.size_, post, received, received - startWait);
+
         MessageScatterer<Data,GatherScatter,FORWARD,Flag>() (interfaces_, dest, recvBuffer+info.start_, proc);
       }else{
         std::cerr<<rank<<": MPI_Error occurred while receiving message from "<<processMap[finished]<<std::endl;
@@ -1506,11 +1535,19 @@ namespace Dune
     MPI_Status recvStatus;
 
     // Wait for completion of sends
-    for(i=0; i< messageInformation_.size(); i++)
+    i=0;
+    for(const_iterator info = messageInformation_.begin(); info != end; ++info, ++i) {
+      const double startWait = tracing ? MPITracer::now() : 0.0;
       if(MPI_SUCCESS!=MPI_Wait(sendRequests+i, &recvStatus)) {
         std::cerr<<rank<<": MPI_Error occurred while sending message to "<<processMap[finished]<<std::endl;
         //success=0;
       }
+      const std::size_t sent = (FORWARD) ? info->second.first.size_ : info->second.second.size_;
+      if(tracing && sent > 0) {
+        const double complete = MPITracer::now();
+        tracer.record(operation, communicator_, info->first, sent, 0, post, complete, complete - startWait);
+      }
+    }
     /*
        int globalSuccess;
        MPI_Allreduce(&success, &globalSuccess, 1, MPI_INT, MPI_MIN, interface_->communicator());
@@ -843,6 +843,7 @@ namespace Dune
     else if(newIndices_.size()>0 || deletedEntries_)
     {
       ArrayList<IndexPair,N> tempPairs;
+      tempPairs.reserve(localIndices_.size()+newIndices_.size());
 
       auto old = localIndices_.begin();
       auto added = newIndices_.begin();
@@ -879,11 +880,8 @@ namespace Dune
         old.eraseToHere();
       }
 
-      while(added!= endadded)
-      {
-        tempPairs.push_back(*added);
-        added.eraseToHere();
-      }
+      tempPairs.append(added, endadded);
+      newIndices_.clear();
       localIndices_ = tempPairs;
     }
   }
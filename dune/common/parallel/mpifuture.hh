@@ -7,11 +7,15 @@
 
 #if HAVE_MPI
 
+#include <algorithm>
+#include <cstddef>
 #include <functional>
+#include <iterator>
 #include <memory>
 #include <optional>
 #include <type_traits>
 #include <utility>
+#include <vector>
 
 #include <mpi.h>
 
@@ -23,6 +27,14 @@
 namespace Dune{
 
   namespace Impl{
+    // Grants access to the MPI_Request of MPIFuture and MPIContinuation
+    struct MPIFutureAccess{
+      template<class F>
+      static MPI_Request& request(F& f){
+        return f.request();
+      }
+    };
+
     template<class T>
     struct Buffer{
       Buffer(bool valid){
@@ -89,6 +101,9 @@ namespace Dune{
     the object that will be received and might contain also a sending object,
     which must be hold (keep alive) until the communication has been completed.
    */
+  template<class Future, class F>
+  class MPIContinuation;
+
   template<class R, class S = void>
   class MPIFuture{
     mutable MPI_Request req_;
@@ -96,6 +111,11 @@ namespace Dune{
     Impl::Buffer<R> data_;
     Impl::Buffer<S> send_data_;
     friend class Communication<MPI_Comm>;
+    friend struct Impl::MPIFutureAccess;
+
+    MPI_Request& request(){
+      return req_;
+    }
   public:
     MPIFuture(bool valid = false)
       : req_(MPI_REQUEST_NULL)
@@ -177,8 +197,221 @@ namespace Dune{
     auto get_send_mpidata(){
       return getMPIData(*send_data_);
     }
+
+    /*! \brief Attach a continuation that is invoked with the result of this
+      future once the communication has been completed.
+
+      The continuation is run at the latest in `wait()` or `get()` of the
+      returned future, but already in `ready()` if the communication has
+      completed, e.g. when it is driven by waitSome(), testSome() or an
+      MPIProgressEngine. The returned future owns this future, hence it has
+      to be called on an rvalue:
+      \code
+      auto f = comm.iallreduce<std::plus<double>>(x).then([](double sum){ return std::sqrt(sum); });
+      \endcode
+     */
+    template<class F>
+    MPIContinuation<MPIFuture, std::decay_t<F>> then(F&& f) &&{
+      return MPIContinuation<MPIFuture, std::decay_t<F>>(std::move(*this), std::forward<F>(f));
+    }
   };
 
+  /*! \brief A future-like object that applies a continuation to the result of
+    another MPIFuture or MPIContinuation.
+
+    \tparam Future The type of the underlying future.
+    \tparam F The type of the continuation. It is invoked with the result of
+             the underlying future or without arguments if that is `void`.
+   */
+  template<class Future, class F>
+  class MPIContinuation{
+    using Input = decltype(std::declval<Future&>().get());
+
+    template<class In, bool = std::is_void<In>::value>
+    struct ResultOf{
+      using type = std::invoke_result_t<F&, In>;
+    };
+    template<class In>
+    struct ResultOf<In, true>{
+      using type = std::invoke_result_t<F&>;
+    };
+
+  public:
+    //! The type returned by get()
+    using Result = std::decay_t<typename ResultOf<Input>::type>;
+
+  private:
+    struct Empty{};
+    using Storage = std::conditional_t<std::is_void<Result>::value, Empty, Result>;
+
+    mutable Future future_;
+    mutable F continuation_;
+    mutable std::optional<Storage> result_;
+    bool consumed_ = false;
+    friend struct Impl::MPIFutureAccess;
+
+    MPI_Request& request(){
+      return Impl::MPIFutureAccess::request(future_);
+    }
+
+    // run the continuation after the underlying communication has completed
+    void complete() const{
+      if(result_)
+        return;
+      if constexpr (std::is_void<Input>::value){
+        future_.get();
+        if constexpr (std::is_void<Result>::value){
+          continuation_();
+          result_.emplace();
+        }else
+          result_.emplace(continuation_());
+      }else{
+        if constexpr (std::is_void<Result>::value){
+          continuation_(future_.get());
+          result_.emplace();
+        }else
+          result_.emplace(continuation_(future_.get()));
+      }
+    }
+
+  public:
+    MPIContinuation(Future&& future, F continuation)
+      : future_(std::move(future))
+      , continuation_(std::move(continuation))
+    {}
+
+    MPIContinuation(const MPIContinuation&) = delete;
+    MPIContinuation(MPIContinuation&&) = default;
+    MPIContinuation& operator=(MPIContinuation&&) = default;
+
+    bool valid() const{
+      return !consumed_ && (result_ || future_.valid());
+    }
+
+    void wait(){
+      if(!valid())
+        DUNE_THROW(InvalidFutureException, "The MPIContinuation is not valid!");
+      if(!result_){
+        future_.wait();
+        complete();
+      }
+    }
+
+    bool ready() const{
+      if(result_)
+        return true;
+      if(!future_.ready())
+        return false;
+      complete();
+      return true;
+    }
+
+    Result get(){
+      wait();
+      consumed_ = true;
+      if constexpr (!std::is_void<Result>::value)
+        return std::move(*result_);
+    }
+
+    //! Attach a further continuation, see MPIFuture::then()
+    template<class G>
+    MPIContinuation<MPIContinuation, std::decay_t<G>> then(G&& g) &&{
+      return MPIContinuation<MPIContinuation, std::decay_t<G>>(std::move(*this), std::forward<G>(g));
+    }
+  };
+
+  namespace Impl{
+    // Collect the requests of a range of futures, call the MPI function and
+    // write back the requests. Returns the indices of the completed futures.
+    template<class Range, class MPIFunction>
+    std::vector<std::size_t> completeSome(Range& futures, MPIFunction&& mpiFunction){
+      std::vector<MPI_Request> requests;
+      for(auto& f : futures)
+        requests.push_back(MPIFutureAccess::request(f));
+      std::vector<int> indices(requests.size());
+      int count = 0;
+      if(!requests.empty())
+        mpiFunction(int(requests.size()), requests.data(), &count, indices.data());
+      std::size_t i = 0;
+      for(auto& f : futures)
+        MPIFutureAccess::request(f) = requests[i++];
+      if(count == MPI_UNDEFINED)
+        count = 0;
+      std::vector<std::size_t> completed(indices.begin(), indices.begin()+count);
+      // MPI does not specify the order of the indices, the range may only
+      // be traversed forward
+      std::sort(completed.begin(), completed.end());
+      // trigger continuations of the completed futures
+      i = 0;
+      auto it = futures.begin();
+      for(std::size_t index : completed){
+        std::advance(it, index - i);
+        i = index;
+        it->ready();
+      }
+      return completed;
+    }
+  }
+
+  /*! \brief Wait until at least one of the futures in the range has completed.
+
+    All outstanding requests are handled by a single call of `MPI_Waitsome`.
+    Continuations of the completed futures are run.
+    \returns the indices of the completed futures in the range in ascending
+             order. The result is empty if there are no active requests.
+   */
+  template<class Range>
+  std::vector<std::size_t> waitSome(Range& futures){
+    return Impl::completeSome(futures, [](int n, MPI_Request* r, int* count, int* indices){
+      MPI_Waitsome(n, r, count, indices, MPI_STATUSES_IGNORE);
+    });
+  }
+
+  /*! \brief Test which of the futures in the range have completed without blocking.
+
+    All outstanding requests are handled by a single call of `MPI_Testsome`.
+    Continuations of the completed futures are run.
+    \returns the indices of the completed futures in the range in ascending order.
+   */
+  template<class Range>
+  std::vector<std::size_t> testSome(Range& futures){
+    return Impl::completeSome(futures, [](int n, MPI_Request* r, int* count, int* indices){
+      MPI_Testsome(n, r, count, indices, MPI_STATUSES_IGNORE);
+    });
+  }
+
+  /*! \brief Wait until any of the futures in the range has completed.
+
+    \returns the index of a completed future or the size of the range if there
+             are no active requests.
+   */
+  template<class Range>
+  std::size_t waitAny(Range& futures){
+    auto completed = Impl::completeSome(futures, [](int n, MPI_Request* r, int* count, int* indices){
+      MPI_Waitany(n, r, indices, MPI_STATUS_IGNORE);
+      *count = (*indices == MPI_UNDEFINED) ? 0 : 1;
+    });
+    return completed.empty() ? std::size_t(std::distance(futures.begin(), futures.end())) : completed.front();
+  }
+
+  /*! \brief Wait until all futures in the range have completed.
+
+    All outstanding requests are handled by a single call of `MPI_Waitall`.
+    Continuations of all futures are run.
+   */
+  template<class Range>
+  void waitAll(Range& futures){
+    std::vector<MPI_Request> requests;
+    for(auto& f : futures)
+      requests.push_back(Impl::MPIFutureAccess::request(f));
+    MPI_Waitall(int(requests.size()), requests.data(), MPI_STATUSES_IGNORE);
+    std::size_t i = 0;
+    for(auto& f : futures){
+      Impl::MPIFutureAccess::request(f) = requests[i++];
+      f.ready();
+    }
+  }
+
 }
 #endif // HAVE_MPI
 #endif // DUNE_COMMON_PARALLEL_MPIFUTURE_HH
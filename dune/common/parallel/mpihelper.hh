@@ -6,7 +6,14 @@
 #define DUNE_COMMON_PARALLEL_MPIHELPER_HH
 
 #include <cassert>
+#include <cstddef>
+#include <cstdlib>
 #include <mutex>
+#include <thread>
+
+#if defined(__linux__)
+#include <sched.h>
+#endif
 
 #if HAVE_MPI
 #include <mpi.h>
@@ -19,10 +26,50 @@
 
 #if HAVE_MPI
 #include <dune/common/stdstreams.hh>
+#include <dune/common/parallel/mpitracer.hh>
 #endif
 
 namespace Dune
 {
+  /**
+   * @brief Level of thread support of the MPI library.
+   * @ingroup ParallelCommunication
+   *
+   * The enumerators are ordered like the corresponding `MPI_THREAD_*`
+   * constants, i.e., a larger level provides a superset of the guarantees
+   * of a smaller level.
+   */
+  enum class MPIThreadLevel
+  {
+    single,     //!< only one thread will execute (`MPI_THREAD_SINGLE`)
+    funneled,   //!< only the main thread makes MPI calls (`MPI_THREAD_FUNNELED`)
+    serialized, //!< MPI calls are never made concurrently (`MPI_THREAD_SERIALIZED`)
+    multiple    //!< multiple threads may call MPI concurrently (`MPI_THREAD_MULTIPLE`)
+  };
+
+  namespace Impl
+  {
+    /**
+     * @brief Number of cores the calling process is bound to.
+     *
+     * On Linux this is the size of the affinity mask of the process, i.e. it
+     * respects the core binding set up by the MPI launcher or by `taskset`.
+     * Otherwise the number of hardware threads of the machine is returned.
+     */
+    inline std::size_t boundCores ()
+    {
+#if defined(__linux__) && defined(CPU_COUNT)
+      cpu_set_t cpuSet;
+      CPU_ZERO(&cpuSet);
+      if (sched_getaffinity(0, sizeof(cpu_set_t), &cpuSet) == 0)
+        return CPU_COUNT(&cpuSet);
+#endif
+      const std::size_t n = std::thread::hardware_concurrency();
+      return n > 0 ? n : 1;
+    }
+
+  } // end namespace Impl
+
   /**
    * @file
    * @brief Helpers for dealing with MPI.
@@ -110,6 +157,15 @@ namespace Dune
     }
 
 
+    /** \brief get a communicator of all processes on the same node
+     *
+     *  \returns a fake communicator
+     */
+    static MPICommunicator getNodeCommunicator ()
+    {
+      return getCommunicator();
+    }
+
     static Communication<MPICommunicator>
     getCommunication()
     {
@@ -130,9 +186,11 @@ namespace Dune
      * \endcode
      * @param argc The number of arguments provided to main.
      * @param argv The arguments provided to main.
+     * @param required The requested level of thread support (ignored).
      */
     DUNE_EXPORT static FakeMPIHelper& instance([[maybe_unused]] int argc,
-                                               [[maybe_unused]] char** argv)
+                                               [[maybe_unused]] char** argv,
+                                               [[maybe_unused]] MPIThreadLevel required = MPIThreadLevel::single)
     {
       return instance();
     }
@@ -152,8 +210,34 @@ namespace Dune
      */
     int size () const { return 1; }
 
+    /**
+     * @brief return the provided level of thread support, i.e. MPIThreadLevel::multiple
+     *
+     * Without MPI there is no restriction on the use of threads.
+     */
+    MPIThreadLevel threadLevel () const { return MPIThreadLevel::multiple; }
+
+    /**
+     * @brief return rank of process within its node, i.e. zero
+     */
+    int nodeRank () const { return 0; }
+
+    /**
+     * @brief return number of processes on the node of this process, i.e. one
+     */
+    int nodeSize () const { return 1; }
+
+    /**
+     * @brief return the number of cores this process is bound to
+     */
+    std::size_t boundCores () const { return boundCores_; }
+
   private:
-    FakeMPIHelper() {}
+    std::size_t boundCores_;
+
+    FakeMPIHelper()
+    : boundCores_(Impl::boundCores())
+    {}
     FakeMPIHelper(const FakeMPIHelper&);
     FakeMPIHelper& operator=(const FakeMPIHelper);
   };
@@ -201,6 +285,21 @@ namespace Dune
       return MPI_COMM_SELF;
     }
 
+    /** \brief get a communicator of all processes on the same node
+     *
+     *  Returns a communicator containing all processes that can create
+     *  shared memory regions with this process, i.e., the result of
+     *  `MPI_Comm_split_type(MPI_COMM_WORLD, MPI_COMM_TYPE_SHARED, ...)`.
+     *  The communicator is created once during initialization of the
+     *  helper and freed on its destruction.
+     *
+     *  \returns the node-local communicator
+     */
+    static MPICommunicator getNodeCommunicator ()
+    {
+      return instance().nodeComm_;
+    }
+
     static Communication<MPICommunicator>
     getCommunication()
     {
@@ -224,10 +323,15 @@ namespace Dune
      *
      * @param argc The number of arguments provided to main.
      * @param argv The arguments provided to main.
+     * @param required The requested level of thread support. If it is
+     *                 larger than MPIThreadLevel::single, MPI is initialized
+     *                 with `MPI_Init_thread`. Check threadLevel() for the
+     *                 level actually provided by the MPI library.
      */
-    DUNE_EXPORT static MPIHelper& instance(int& argc, char**& argv)
+    DUNE_EXPORT static MPIHelper& instance(int& argc, char**& argv,
+                                           MPIThreadLevel required = MPIThreadLevel::single)
     {
-      return instance(&argc, &argv);
+      return instance(&argc, &argv, required);
     }
 
     /**
@@ -256,11 +360,13 @@ namespace Dune
      *
      * @param argc The number of arguments provided to main.
      * @param argv The arguments provided to main.
+     * @param required The requested level of thread support.
      */
-    DUNE_EXPORT static MPIHelper& instance(int* argc = nullptr, char*** argv = nullptr)
+    DUNE_EXPORT static MPIHelper& instance(int* argc = nullptr, char*** argv = nullptr,
+                                           MPIThreadLevel required = MPIThreadLevel::single)
     {
       assert((argc == nullptr) == (argv == nullptr));
-      static MPIHelper instance{argc, argv};
+      static MPIHelper instance{argc, argv, required};
       return instance;
     }
 
@@ -273,11 +379,40 @@ namespace Dune
      */
     int size () const { return size_; }
 
-    //! \brief calls MPI_Finalize
+    /**
+     * @brief return the level of thread support provided by the MPI library
+     *
+     * This might be smaller than the level requested in instance().
+     */
+    MPIThreadLevel threadLevel () const { return threadLevel_; }
+
+    /**
+     * @brief return rank of process within the node communicator
+     */
+    int nodeRank () const { return nodeRank_; }
+
+    /**
+     * @brief return number of processes on the node of this process
+     */
+    int nodeSize () const { return nodeSize_; }
+
+    /**
+     * @brief return the number of cores this process is bound to
+     *
+     * Together with nodeSize() this can be used to size thread pools
+     * of hybrid MPI and threading codes.
+     */
+    std::size_t boundCores () const { return boundCores_; }
+
+    //! \brief writes the results of the MPITracer and calls MPI_Finalize
     ~MPIHelper()
     {
       int wasFinalized = -1;
       MPI_Finalized( &wasFinalized );
+      if(!wasFinalized)
+        MPITracer::instance().finalize();
+      if(!wasFinalized && nodeComm_ != MPI_COMM_NULL)
+        MPI_Comm_free(&nodeComm_);
       if(!wasFinalized && initializedHere_)
       {
         MPI_Finalize();
@@ -290,11 +425,39 @@ namespace Dune
     int rank_;
     int size_;
     bool initializedHere_;
+    MPIThreadLevel threadLevel_;
+    MPI_Comm nodeComm_;
+    int nodeRank_;
+    int nodeSize_;
+    std::size_t boundCores_;
     void prevent_warning(int){}
 
-    //! \brief calls MPI_Init with argc and argv as parameters
-    MPIHelper(int* argc, char*** argv)
+    static int toMPI (MPIThreadLevel level)
+    {
+      switch (level) {
+        case MPIThreadLevel::funneled:   return MPI_THREAD_FUNNELED;
+        case MPIThreadLevel::serialized: return MPI_THREAD_SERIALIZED;
+        case MPIThreadLevel::multiple:   return MPI_THREAD_MULTIPLE;
+        default:                         return MPI_THREAD_SINGLE;
+      }
+    }
+
+    static MPIThreadLevel fromMPI (int level)
+    {
+      if (level >= MPI_THREAD_MULTIPLE)
+        return MPIThreadLevel::multiple;
+      else if (level >= MPI_THREAD_SERIALIZED)
+        return MPIThreadLevel::serialized;
+      else if (level >= MPI_THREAD_FUNNELED)
+        return MPIThreadLevel::funneled;
+      return MPIThreadLevel::single;
+    }
+
+    //! \brief calls MPI_Init (or MPI_Init_thread) with argc and argv as parameters
+    MPIHelper(int* argc, char*** argv, MPIThreadLevel required)
     : initializedHere_(false)
+    , nodeComm_(MPI_COMM_NULL)
+    , boundCores_(Impl::boundCores())
     {
       int wasInitialized = -1;
       MPI_Initialized( &wasInitialized );
@@ -302,17 +465,37 @@ namespace Dune
       {
         rank_ = -1;
         size_ = -1;
-        static int is_initialized = MPI_Init(argc, argv);
-        prevent_warning(is_initialized);
+        if (required == MPIThreadLevel::single) {
+          static int is_initialized = MPI_Init(argc, argv);
+          prevent_warning(is_initialized);
+        }
+        else {
+          int provided = MPI_THREAD_SINGLE;
+          static int is_initialized = MPI_Init_thread(argc, argv, toMPI(required), &provided);
+          prevent_warning(is_initialized);
+        }
         initializedHere_ = true;
       }
 
+      int provided = MPI_THREAD_SINGLE;
+      MPI_Query_thread(&provided);
+      threadLevel_ = fromMPI(provided);
+
       MPI_Comm_rank(MPI_COMM_WORLD,&rank_);
       MPI_Comm_size(MPI_COMM_WORLD,&size_);
 
       assert( rank_ >= 0 );
       assert( size_ >= 1 );
 
+      MPI_Comm_split_type(MPI_COMM_WORLD, MPI_COMM_TYPE_SHARED, rank_, MPI_INFO_NULL, &nodeComm_);
+      MPI_Comm_rank(nodeComm_,&nodeRank_);
+      MPI_Comm_size(nodeComm_,&nodeSize_);
+
+      // constructed here to outlive this helper, which finalizes the tracer
+      MPITracer& tracer = MPITracer::instance();
+      if (const char* prefix = std::getenv("DUNE_MPI_TRACE"))
+        tracer.enable(prefix);
+
       dverb << "Called  MPI_Init on p=" << rank_ << "!" << std::endl;
     }
 
@@ -0,0 +1,177 @@
+// -*- tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 2 -*-
+// vi: set et ts=4 sw=2 sts=2:
+// SPDX-FileCopyrightInfo: Copyright © DUNE Project contributors, see file LICENSE.md in module root
+// SPDX-License-Identifier: LicenseRef-GPL-2.0-only-with-DUNE-exception
+#ifndef DUNE_COMMON_PARALLEL_MPIPROGRESSENGINE_HH
+#define DUNE_COMMON_PARALLEL_MPIPROGRESSENGINE_HH
+
+#if HAVE_MPI
+
+#include <cstddef>
+#include <memory>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include <mpi.h>
+
+#include <dune/common/parallel/mpifuture.hh>
+
+namespace Dune{
+
+  /*! \brief Manages many in-flight MPI communications without blocking.
+
+    Futures are handed over to the engine together with a callback that is
+    invoked with the result once the communication has completed. The
+    application calls progress() periodically, e.g. once per iteration of a
+    time loop, which tests all outstanding requests with a single call of
+    `MPI_Testsome` and runs the callbacks of the completed ones:
+    \code
+    MPIProgressEngine engine;
+    engine.add(comm.iallreduce<std::plus<double>>(residual),
+               [&](double r){ globalResidual = r; });
+    while(computing){
+      doWork();
+      engine.progress();
+    }
+    engine.waitAll();
+    \endcode
+    Callbacks may add new futures to the engine.
+   */
+  class MPIProgressEngine{
+    struct TaskBase{
+      virtual ~TaskBase() = default;
+      virtual MPI_Request& request() = 0;
+      virtual void complete() = 0;
+    };
+
+    template<class Future, class Callback>
+    struct Task : TaskBase{
+      Future future_;
+      Callback callback_;
+
+      Task(Future&& future, Callback&& callback)
+        : future_(std::move(future))
+        , callback_(std::move(callback))
+      {}
+
+      MPI_Request& request() override{
+        return Impl::MPIFutureAccess::request(future_);
+      }
+
+      void complete() override{
+        if constexpr (std::is_void<decltype(future_.get())>::value){
+          future_.get();
+          callback_();
+        }else
+          callback_(future_.get());
+      }
+    };
+
+    struct Ignore{
+      template<class... T>
+      void operator()(T&&...) const {}
+    };
+
+    std::vector<std::unique_ptr<TaskBase>> tasks_;
+
+    // call the MPI function on all outstanding requests and run the callbacks
+    template<class MPIFunction>
+    std::size_t complete(MPIFunction&& mpiFunction){
+      if(tasks_.empty())
+        return 0;
+      std::vector<MPI_Request> requests;
+      requests.reserve(tasks_.size());
+      for(auto& task : tasks_)
+        requests.push_back(task->request());
+      std::vector<int> indices(tasks_.size());
+      int count = 0;
+      mpiFunction(int(requests.size()), requests.data(), &count, indices.data());
+      if(count == 0)
+        return 0;
+
+      // MPI_UNDEFINED signals that none of the requests is active any more
+      std::vector<bool> isCompleted(tasks_.size(), count == MPI_UNDEFINED);
+      for(int i = 0; i < count; ++i)
+        isCompleted[indices[i]] = true;
+      if(count == MPI_UNDEFINED)
+        count = tasks_.size();
+
+      std::vector<std::unique_ptr<TaskBase>> completed;
+      std::vector<std::unique_ptr<TaskBase>> remaining;
+      remaining.reserve(tasks_.size() - count);
+      for(std::size_t i = 0; i < tasks_.size(); ++i){
+        tasks_[i]->request() = requests[i];
+        if(isCompleted[i])
+          completed.push_back(std::move(tasks_[i]));
+        else
+          remaining.push_back(std::move(tasks_[i]));
+      }
+      tasks_ = std::move(remaining);
+
+      // callbacks run after the bookkeeping, so they can add new tasks
+      for(auto& task : completed)
+        task->complete();
+      return completed.size();
+    }
+
+  public:
+    /*! \brief Hand over a future to the engine.
+
+      \param future An MPIFuture or MPIContinuation, moved into the engine.
+      \param callback Invoked with the result of the future once it has
+                      completed, or without arguments for `void` futures.
+     */
+    template<class Future, class Callback>
+    void add(Future&& future, Callback&& callback){
+      static_assert(!std::is_lvalue_reference<Future>::value,
+                    "The future must be moved into the MPIProgressEngine");
+      tasks_.push_back(std::make_unique<Task<Future, std::decay_t<Callback>>>(
+                         std::move(future), std::decay_t<Callback>(std::forward<Callback>(callback))));
+    }
+
+    //! \brief Hand over a future whose result is not needed, e.g. an isend.
+    template<class Future>
+    void add(Future&& future){
+      add(std::move(future), Ignore{});
+    }
+
+    /*! \brief Test all outstanding communications without blocking.
+      \returns the number of completed communications
+     */
+    std::size_t progress(){
+      return complete([](int n, MPI_Request* r, int* count, int* indices){
+        MPI_Testsome(n, r, count, indices, MPI_STATUSES_IGNORE);
+      });
+    }
+
+    /*! \brief Block until at least one outstanding communication has completed.
+      \returns the number of completed communications
+     */
+    std::size_t waitSome(){
+      return complete([](int n, MPI_Request* r, int* count, int* indices){
+        MPI_Waitsome(n, r, count, indices, MPI_STATUSES_IGNORE);
+      });
+    }
+
+    //! \brief Block until all communications, including those added by callbacks, have completed.
+    void waitAll(){
+      while(!tasks_.empty())
+        waitSome();
+    }
+
+    //! \brief The number of outstanding communications
+    std::size_t size() const{
+      return tasks_.size();
+    }
+
+    //! \brief Whether there are no outstanding communications
+    bool empty() const{
+      return tasks_.empty();
+    }
+  };
+
+}
+
+#endif // HAVE_MPI
+#endif // DUNE_COMMON_PARALLEL_MPIPROGRESSENGINE_HH
@@ -0,0 +1,233 @@
+// -*- tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 2 -*-
+// vi: set et ts=4 sw=2 sts=2:
+// SPDX-FileCopyrightInfo: Copyright © DUNE Project contributors, see file LICENSE.md in module root
+// SPDX-License-Identifier: LicenseRef-GPL-2.0-only-with-DUNE-exception
+#ifndef DUNE_COMMON_PARALLEL_MPISHAREDMEMORY_HH
+#define DUNE_COMMON_PARALLEL_MPISHAREDMEMORY_HH
+
+/*!
+   \file
+   \brief Node-local shared memory regions based on MPI-3 shared memory windows.
+
+   \ingroup ParallelCommunication
+ */
+
+#if HAVE_MPI
+
+#include <cstddef>
+#include <type_traits>
+#include <utility>
+
+#include <mpi.h>
+
+#include <dune/common/exceptions.hh>
+#include <dune/common/parallel/mpihelper.hh>
+#include <dune/common/std/extents.hh>
+#include <dune/common/std/mdspan.hh>
+#include <dune/common/std/span.hh>
+
+namespace Dune
+{
+
+  /**
+   * \brief A region of memory shared by all processes of a node.
+   * \ingroup ParallelCommunication
+   *
+   * The memory is allocated with `MPI_Win_allocate_shared` on the root process
+   * of a communicator whose processes can all access the same physical memory,
+   * e.g. the communicator returned by MPIHelper::getNodeCommunicator(). All
+   * other processes obtain a pointer into that region, so that large read-only
+   * data has to be stored only once per node:
+   * \code
+   * SharedMemoryWindow<double> table(n);
+   * if (table.isRoot())
+   *   readTable(table.span());
+   * table.barrier();
+   * // all processes of the node can now read table.span()
+   * \endcode
+   *
+   * The window is kept in a passive target access epoch (`MPI_Win_lock_all`)
+   * for its whole lifetime, so processes access the memory by plain loads and
+   * stores. Use barrier() to synchronize writes and reads of different processes.
+   *
+   * \tparam T  Element type. Must be trivially copyable, since no constructors
+   *            or destructors are run on the shared memory.
+   */
+  template<class T>
+  class SharedMemoryWindow
+  {
+    static_assert(std::is_trivially_copyable_v<T>,
+      "SharedMemoryWindow can only store trivially copyable types");
+
+  public:
+    using value_type = T;
+    using size_type = std::size_t;
+
+    /**
+     * \brief Allocate a shared region of `size` elements. Collective on `comm`.
+     *
+     * \param size  Number of elements, must be the same on all processes.
+     * \param comm  A communicator of processes sharing memory.
+     * \param root  The process the memory is allocated on.
+     */
+    explicit SharedMemoryWindow (size_type size,
+                                 MPI_Comm comm = MPIHelper::getNodeCommunicator(),
+                                 int root = 0)
+      : comm_(comm)
+      , size_(size)
+    {
+      MPI_Comm_rank(comm_, &rank_);
+      isRoot_ = (rank_ == root);
+
+      T* base = nullptr;
+      const MPI_Aint bytes = isRoot_ ? MPI_Aint(size * sizeof(T)) : 0;
+      if (MPI_Win_allocate_shared(bytes, sizeof(T), MPI_INFO_NULL, comm_, &base, &win_) != MPI_SUCCESS)
+        DUNE_THROW(ParallelError, "MPI_Win_allocate_shared failed");
+
+      try {
+        // query the address of the region in the address space of this process
+        MPI_Aint querySize = 0;
+        int dispUnit = 0;
+        if (MPI_Win_shared_query(win_, root, &querySize, &dispUnit, &data_) != MPI_SUCCESS)
+          DUNE_THROW(ParallelError, "MPI_Win_shared_query failed");
+        if (size_type(querySize) < size * sizeof(T))
+          DUNE_THROW(ParallelError, "Shared memory region is smaller than requested");
+      }
+      catch (...) {
+        // the destructor is not called if the constructor throws; the size of
+        // the region is the same on all processes, so all of them free the window
+        MPI_Win_free(&win_);
+        throw;
+      }
+
+      MPI_Win_lock_all(MPI_MODE_NOCHECK, win_);
+    }
+
+    SharedMemoryWindow (const SharedMemoryWindow&) = delete;
+    SharedMemoryWindow& operator= (const SharedMemoryWindow&) = delete;
+
+    SharedMemoryWindow (SharedMemoryWindow&& other) noexcept
+      : comm_(other.comm_)
+      , win_(std::exchange(other.win_, MPI_WIN_NULL))
+      , data_(std::exchange(other.data_, nullptr))
+      , size_(std::exchange(other.size_, 0))
+      , rank_(other.rank_)
+      , isRoot_(other.isRoot_)
+    {}
+
+    SharedMemoryWindow& operator= (SharedMemoryWindow&& other) noexcept
+    {
+      if (this != &other) {
+        free();
+        comm_ = other.comm_;
+        win_ = std::exchange(other.win_, MPI_WIN_NULL);
+        data_ = std::exchange(other.data_, nullptr);
+        size_ = std::exchange(other.size_, 0);
+        rank_ = other.rank_;
+        isRoot_ = other.isRoot_;
+      }
+      return *this;
+    }
+
+    //! Free the window. Collective on the communicator.
+    ~SharedMemoryWindow ()
+    {
+      free();
+    }
+
+    //! Number of elements in the shared region
+    size_type size () const { return size_; }
+
+    //! Pointer to the first element of the shared region
+    T* data () const { return data_; }
+
+    //! Whether this process owns the memory of the region
+    bool isRoot () const { return isRoot_; }
+
+    //! The communicator of all processes sharing the region
+    MPI_Comm communicator () const { return comm_; }
+
+    //! The underlying MPI window
+    MPI_Win window () const { return win_; }
+
+    //! View on the whole shared region
+    Std::span<T> span () const
+    {
+      return Std::span<T>(data_, size_);
+    }
+
+    /**
+     * \brief Multi-dimensional view on the shared region.
+     *
+     * The view uses `Std::layout_right`, i.e. the last index is contiguous.
+     * The product of the extents must not exceed size().
+     */
+    template<class Extents>
+    Std::mdspan<T, Extents> mdspan (const Extents& extents) const
+    {
+      size_type required = 1;
+      for (typename Extents::rank_type r = 0; r < Extents::rank(); ++r)
+        required *= extents.extent(r);
+      if (required > size_)
+        DUNE_THROW(RangeError, "Extents exceed the size of the shared memory region");
+      return Std::mdspan<T, Extents>(data_, extents);
+    }
+
+    //! Multi-dimensional view with dynamic extents, e.g. `win.mdspan(n,m)`
+    template<class... IndexTypes,
+      std::enable_if_t<(sizeof...(IndexTypes) > 0) && (std::is_integral_v<IndexTypes> && ...), int> = 0>
+    auto mdspan (IndexTypes... exts) const
+    {
+      return mdspan(Std::dextents<std::size_t, sizeof...(IndexTypes)>(exts...));
+    }
+
+    /**
+     * \brief Synchronize the public and private copy of the window (`MPI_Win_sync`).
+     *
+     * This is a memory fence that is local to the calling process.
+     */
+    void sync () const
+    {
+      MPI_Win_sync(win_);
+    }
+
+    /**
+     * \brief Make all writes before the barrier visible to all processes after it.
+     *
+     * Collective on the communicator.
+     */
+    void barrier () const
+    {
+      MPI_Win_sync(win_);
+      MPI_Barrier(comm_);
+      MPI_Win_sync(win_);
+    }
+
+  private:
+    void free ()
+    {
+      if (win_ == MPI_WIN_NULL)
+        return;
+      int finalized = 0;
+      MPI_Finalized(&finalized);
+      if (!finalized) {
+        MPI_Win_unlock_all(win_);
+        MPI_Win_free(&win_);
+      }
+      win_ = MPI_WIN_NULL;
+      data_ = nullptr;
+    }
+
+    MPI_Comm comm_;
+    MPI_Win win_ = MPI_WIN_NULL;
+    T* data_ = nullptr;
+    size_type size_ = 0;
+    int rank_ = 0;
+    bool isRoot_ = false;
+  };
+
+} // end namespace Dune
+
+#endif // HAVE_MPI
+
+#endif // DUNE_COMMON_PARALLEL_MPISHAREDMEMORY_HH
@@ -0,0 +1,805 @@
+// -*- tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 2 -*-
+// vi: set et ts=4 sw=2 sts=2:
+// SPDX-FileCopyrightInfo: Copyright © DUNE Project contributors, see file LICENSE.md in module root
+// SPDX-License-Identifier: LicenseRef-GPL-2.0-only-with-DUNE-exception
+#ifndef DUNE_COMMON_PARALLEL_MPITRACER_HH
+#define DUNE_COMMON_PARALLEL_MPITRACER_HH
+
+/*!
+   \file
+   \brief Tracing of the MPI communication of a process
+
+   \ingroup ParallelCommunication
+ */
+
+#if HAVE_MPI
+
+#include <atomic>
+#include <cstddef>
+#include <fstream>
+#include <iomanip>
+#include <locale>
+#include <map>
+#include <mutex>
+#include <ostream>
+#include <sstream>
+#include <string>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include <mpi.h>
+
+#include <dune/common/exceptions.hh>
+#include <dune/common/parallel/mpicommunication.hh>
+#include <dune/common/parallel/mpidata.hh>
+#include <dune/common/parallel/mpifuture.hh>
+#include <dune/common/parallel/mpitraits.hh>
+
+namespace Dune
+{
+
+  /*! \brief Records the MPI communication of this process
+
+     The tracer collects, for every traced call, the number of bytes, the
+     peer rank, the time from posting the communication until its completion
+     was observed and the time the process was blocked waiting for it. It
+     does not intercept MPI itself, calls are reported by the
+     `TracingCommunication` decorator, by `MPITracedFuture` and by the
+     communicators in `dune/common/parallel/`, which check `enabled()`.
+
+     Tracing is switched on by `enable()` or by setting the environment
+     variable `DUNE_MPI_TRACE` to a file name prefix before `MPIHelper` is
+     instantiated. If a prefix is given, `MPIHelper` calls `finalize()`
+     before `MPI_Finalize`, which writes
+
+     - `<prefix>-matrix.txt`: the number of messages and bytes sent between
+       every pair of ranks of `MPI_COMM_WORLD` and a summary per operation
+       (written by rank 0),
+     - `<prefix>-<rank>.json`: the timeline of the rank in the Chrome trace
+       event format, which can be viewed with `chrome://tracing` or Perfetto.
+
+     Peer ranks are translated into ranks of `MPI_COMM_WORLD`, collectives
+     are recorded with peer -1 and the bytes contributed by this process.
+
+     \note `enable()` and `finalize()` are collective over `MPI_COMM_WORLD`
+           in the sense that either all or no ranks must trace.
+   */
+  class MPITracer
+  {
+  public:
+    //! A traced call
+    struct Event
+    {
+      //! Name of the operation, with static storage duration
+      const char* operation;
+      //! Rank of the peer in `MPI_COMM_WORLD`, -1 for collectives
+      int peer;
+      std::size_t sentBytes;
+      std::size_t receivedBytes;
+      //! Time of posting, relative to `enable()`
+      double post;
+      //! Time when completion was observed, relative to `enable()`
+      double complete;
+      //! Time spent blocked in waiting for completion
+      double wait;
+    };
+
+    //! Aggregated calls of an operation
+    struct Summary
+    {
+      std::size_t calls = 0;
+      std::size_t sentBytes = 0;
+      std::size_t receivedBytes = 0;
+      //! Sum of the times from posting to completion
+      double time = 0.0;
+      //! Sum of the times blocked in waiting
+      double wait = 0.0;
+    };
+
+    //! The tracer of the process
+    static MPITracer& instance ()
+    {
+      static MPITracer tracer;
+      return tracer;
+    }
+
+    /** \brief Start tracing
+     *
+     * \param prefix     If not empty, `finalize()` writes the results to files
+     *                   starting with this prefix.
+     * \param maxEvents  Maximal number of events kept for the timeline, later
+     *                   calls are only aggregated.
+     */
+    void enable (const std::string& prefix = "", std::size_t maxEvents = 1000000)
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      prefix_ = prefix;
+      maxEvents_ = maxEvents;
+      start_ = MPI_Wtime();
+      enabled_ = true;
+    }
+
+    //! Stop tracing, already recorded calls are kept
+    void disable ()
+    {
+      enabled_ = false;
+    }
+
+    //! Whether calls are traced
+    bool enabled () const
+    {
+      return enabled_;
+    }
+
+    //! Current time as used for the events
+    static double now ()
+    {
+      return MPI_Wtime();
+    }
+
+    /** \brief Record a call
+     *
+     * \param comm      The communicator that `peer` refers to
+     * \param peer      The rank of the peer in `comm`, negative for collectives
+     * \param post      Time of posting as returned by `now()`
+     * \param complete  Time of completion as returned by `now()`
+     * \param wait      Time blocked in waiting for completion
+     */
+    void record (const char* operation, MPI_Comm comm, int peer,
+                 std::size_t sentBytes, std::size_t receivedBytes,
+                 double post, double complete, double wait)
+    {
+      if (!enabled_)
+        return;
+      const int worldPeer = worldRank(comm, peer);
+      std::lock_guard<std::mutex> lock(mutex_);
+      Summary& summary = summaries_[operation];
+      ++summary.calls;
+      summary.sentBytes += sentBytes;
+      summary.receivedBytes += receivedBytes;
+      summary.time += complete - post;
+      summary.wait += wait;
+      if (worldPeer >= 0 && sentBytes > 0)
+      {
+        auto& sent = sent_[worldPeer];
+        ++sent.first;
+        sent.second += sentBytes;
+      }
+      if (events_.size() < maxEvents_)
+        events_.push_back(Event{operation, worldPeer, sentBytes, receivedBytes,
+                                post - start_, complete - start_, wait});
+    }
+
+    //! Record a blocking call, i.e., one that waits from posting until completion
+    void record (const char* operation, MPI_Comm comm, int peer,
+                 std::size_t sentBytes, std::size_t receivedBytes, double post)
+    {
+      const double complete = now();
+      record(operation, comm, peer, sentBytes, receivedBytes, post, complete, complete - post);
+    }
+
+    //! Discard all recorded calls
+    void reset ()
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      events_.clear();
+      summaries_.clear();
+      sent_.clear();
+      start_ = MPI_Wtime();
+    }
+
+    //! The recorded calls kept for the timeline
+    std::vector<Event> events () const
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      return events_;
+    }
+
+    //! The recorded calls aggregated per operation
+    std::map<std::string, Summary> summary () const
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      std::map<std::string, Summary> result;
+      for (const auto& entry : summaries_)
+      {
+        Summary& s = result[entry.first];
+        s.calls += entry.second.calls;
+        s.sentBytes += entry.second.sentBytes;
+        s.receivedBytes += entry.second.receivedBytes;
+        s.time += entry.second.time;
+        s.wait += entry.second.wait;
+      }
+      return result;
+    }
+
+    /** \brief The number of messages and bytes sent from every rank to every rank
+     *
+     * Returns the row-major matrices of size `P*P` for the `P` ranks of
+     * `MPI_COMM_WORLD` on all ranks. This is a collective operation.
+     */
+    std::pair<std::vector<std::size_t>, std::vector<std::size_t>> matrix () const
+    {
+      int rank, size;
+      MPI_Comm_rank(MPI_COMM_WORLD, &rank);
+      MPI_Comm_size(MPI_COMM_WORLD, &size);
+      std::vector<unsigned long long> row(2*size, 0);
+      {
+        std::lock_guard<std::mutex> lock(mutex_);
+        for (const auto& entry : sent_)
+        {
+          row[entry.first] = entry.second.first;
+          row[size + entry.first] = entry.second.second;
+        }
+      }
+      std::vector<unsigned long long> rows(2*size*size);
+      MPI_Allgather(row.data(), 2*size, MPI_UNSIGNED_LONG_LONG,
+                    rows.data(), 2*size, MPI_UNSIGNED_LONG_LONG, MPI_COMM_WORLD);
+      std::pair<std::vector<std::size_t>, std::vector<std::size_t>> result;
+      result.first.resize(size*size);
+      result.second.resize(size*size);
+      for (int i = 0; i < size; ++i)
+        for (int j = 0; j < size; ++j)
+        {
+          result.first[i*size+j] = rows[2*size*i + j];
+          result.second[i*size+j] = rows[2*size*i + size + j];
+        }
+      return result;
+    }
+
+    /** \brief Write the communication matrix and the summary over all ranks
+     *
+     * This is a collective operation, the output is written on rank 0.
+     */
+    void writeMatrix (std::ostream& out) const
+    {
+      int rank, size;
+      MPI_Comm_rank(MPI_COMM_WORLD, &rank);
+      MPI_Comm_size(MPI_COMM_WORLD, &size);
+      const auto counts = matrix();
+
+      // sum the summaries over the ranks, operations are identified by name
+      std::string names;
+      for (const auto& entry : summary())
+        names += entry.first + '\n';
+      int length = names.size();
+      std::vector<int> lengths(size), offsets(size, 0);
+      MPI_Allgather(&length, 1, MPI_INT, lengths.data(), 1, MPI_INT, MPI_COMM_WORLD);
+      for (int i = 1; i < size; ++i)
+        offsets[i] = offsets[i-1] + lengths[i-1];
+      std::string allNames(offsets.back() + lengths.back(), '\0');
+      MPI_Allgatherv(names.data(), length, MPI_CHAR, allNames.data(), lengths.data(),
+                     offsets.data(), MPI_CHAR, MPI_COMM_WORLD);
+      std::map<std::string, Summary> local = summary();
+      std::map<std::string, Summary> total;
+      std::istringstream stream(allNames);
+      for (std::string name; std::getline(stream, name);)
+        total[name];
+      std::vector<double> values, maxWait;
+      for (const auto& entry : total)
+      {
+        const Summary& s = local[entry.first];
+        values.insert(values.end(), {double(s.calls), double(s.sentBytes), double(s.receivedBytes), s.time, s.wait});
+        maxWait.push_back(s.wait);
+      }
+      MPI_Allreduce(MPI_IN_PLACE, values.data(), values.size(), MPI_DOUBLE, MPI_SUM, MPI_COMM_WORLD);
+      MPI_Allreduce(MPI_IN_PLACE, maxWait.data(), maxWait.size(), MPI_DOUBLE, MPI_MAX, MPI_COMM_WORLD);
+      if (rank != 0)
+        return;
+
+      std::ostringstream s;
+      s.imbue(std::locale::classic());
+      s << "# messages sent from rank (row) to rank (column)\n";
+      writeTable(s, counts.first, size);
+      s << "\n# bytes sent from rank (row) to rank (column)\n";
+      writeTable(s, counts.second, size);
+      s << "\n# operations summed over all ranks\n"
+        << std::left << std::setw(36) << "operation" << std::right
+        << std::setw(12) << "calls" << std::setw(16) << "bytes sent" << std::setw(16) << "bytes recv."
+        << std::setw(12) << "time [s]" << std::setw(12) << "wait [s]" << std::setw(12) << "max wait" << "\n"
+        << std::setprecision(4);
+      std::size_t i = 0;
+      for (const auto& entry : total)
+      {
+        s << std::left << std::setw(36) << entry.first << std::right << std::setprecision(16)
+          << std::setw(12) << values[5*i] << std::setw(16) << values[5*i+1] << std::setw(16) << values[5*i+2]
+          << std::setprecision(4)
+          << std::setw(12) << values[5*i+3] << std::setw(12) << values[5*i+4] << std::setw(12) << maxWait[i] << "\n";
+        ++i;
+      }
+      out << s.str();
+    }
+
+    /** \brief Write the recorded calls of this rank in the Chrome trace event format
+     *
+     * The rank in `MPI_COMM_WORLD` is used as process id, so the traces of
+     * several ranks can be merged by concatenating their `traceEvents`.
+     */
+    void writeTimeline (std::ostream& out) const
+    {
+      int rank;
+      MPI_Comm_rank(MPI_COMM_WORLD, &rank);
+      std::ostringstream s;
+      s.imbue(std::locale::classic());
+      s << std::setprecision(12) << "{\"traceEvents\": [";
+      bool first = true;
+      for (const Event& event : events())
+      {
+        s << (first ? "\n" : ",\n") << "{\"name\": \"" << event.operation
+          << "\", \"cat\": \"mpi\", \"ph\": \"X\", \"pid\": " << rank << ", \"tid\": 0"
+          << ", \"ts\": " << 1e6 * event.post << ", \"dur\": " << 1e6 * (event.complete - event.post)
+          << ", \"args\": {\"peer\": " << event.peer << ", \"sent\": " << event.sentBytes
+          << ", \"received\": " << event.receivedBytes << ", \"wait\": " << 1e6 * event.wait << "}}";
+        first = false;
+      }
+      s << "\n],\n\"displayTimeUnit\": \"ms\"}\n";
+      out << s.str();
+    }
+
+    /** \brief Write the results to the files given by the prefix of `enable()` and stop tracing
+     *
+     * Does nothing if tracing is not enabled or no prefix was given. This
+     * is called by `MPIHelper` before `MPI_Finalize` and is a collective
+     * operation.
+     */
+    void finalize ()
+    {
+      if (!enabled_ || prefix_.empty())
+        return;
+      int rank;
+      MPI_Comm_rank(MPI_COMM_WORLD, &rank);
+      std::ostringstream matrix;
+      writeMatrix(matrix);
+      if (rank == 0)
+        std::ofstream(prefix_ + "-matrix.txt") << matrix.str();
+      std::ofstream(prefix_ + "-" + std::to_string(rank) + ".json") << timeline();
+      disable();
+    }
+
+  private:
+    MPITracer () = default;
+
+    std::string timeline () const
+    {
+      std::ostringstream s;
+      writeTimeline(s);
+      return s.str();
+    }
+
+    static int worldRank (MPI_Comm comm, int peer)
+    {
+      if (peer < 0 || comm == MPI_COMM_WORLD)
+        return peer;
+      MPI_Group group, world;
+      MPI_Comm_group(comm, &group);
+      MPI_Comm_group(MPI_COMM_WORLD, &world);
+      int result = -1;
+      MPI_Group_translate_ranks(group, 1, &peer, world, &result);
+      MPI_Group_free(&group);
+      MPI_Group_free(&world);
+      return result == MPI_UNDEFINED ? -1 : result;
+    }
+
+    static void writeTable (std::ostream& out, const std::vector<std::size_t>& values, int size)
+    {
+      for (int i = 0; i < size; ++i)
+      {
+        for (int j = 0; j < size; ++j)
+          out << (j == 0 ? "" : " ") << values[i*size+j];
+        out << "\n";
+      }
+    }
+
+    mutable std::mutex mutex_;
+    std::atomic<bool> enabled_ = false;
+    std::string prefix_;
+    std::size_t maxEvents_ = 0;
+    double start_ = 0.0;
+    std::vector<Event> events_;
+    std::map<const char*, Summary> summaries_;
+    // messages and bytes sent per world rank
+    std::map<int, std::pair<std::size_t, std::size_t>> sent_;
+  };
+
+
+  /*! \brief A future that reports its communication to the `MPITracer`
+
+     Wraps an `MPIFuture` or `MPIContinuation`. The call is recorded once its
+     completion is observed by `wait()`, `get()` or `ready()`, e.g., through
+     `waitSome()`, `waitAll()` or an `MPIProgressEngine`. Only the time spent
+     in `wait()` and `get()` counts as waiting.
+   */
+  template<class Future>
+  class MPITracedFuture
+  {
+    Future future_;
+    const char* operation_;
+    MPI_Comm comm_;
+    int peer_;
+    std::size_t sentBytes_;
+    std::size_t receivedBytes_;
+    double post_;
+    double wait_ = 0.0;
+    mutable bool recorded_ = false;
+    friend struct Impl::MPIFutureAccess;
+
+    MPI_Request& request ()
+    {
+      return Impl::MPIFutureAccess::request(future_);
+    }
+
+    void complete () const
+    {
+      if (recorded_)
+        return;
+      recorded_ = true;
+      MPITracer::instance().record(operation_, comm_, peer_, sentBytes_, receivedBytes_,
+                                   post_, MPITracer::now(), wait_);
+    }
+
+  public:
+    MPITracedFuture (Future&& future, const char* operation, MPI_Comm comm, int peer,
+                     std::size_t sentBytes, std::size_t receivedBytes, double post)
+      : future_(std::move(future))
+      , operation_(operation)
+      , comm_(comm)
+      , peer_(peer)
+      , sentBytes_(sentBytes)
+      , receivedBytes_(receivedBytes)
+      , post_(post)
+    {}
+
+    MPITracedFuture (MPITracedFuture&&) = default;
+    MPITracedFuture& operator= (MPITracedFuture&&) = default;
+
+    bool valid () const
+    {
+      return future_.valid();
+    }
+
+    void wait ()
+    {
+      if (!recorded_)
+      {
+        const double start = MPITracer::now();
+        future_.wait();
+        wait_ += MPITracer::now() - start;
+        complete();
+      }
+      else
+        future_.wait();
+    }
+
+    bool ready () const
+    {
+      if (!future_.ready())
+        return false;
+      complete();
+      return true;
+    }
+
+    decltype(auto) get ()
+    {
+      wait();
+      return future_.get();
+    }
+
+    //! Attach a continuation, see MPIFuture::then()
+    template<class F>
+    MPIContinuation<MPITracedFuture, std::decay_t<F>> then (F&& f) &&
+    {
+      return MPIContinuation<MPITracedFuture, std::decay_t<F>>(std::move(*this), std::forward<F>(f));
+    }
+  };
+
+
+  /*! \brief Decorator of `Communication<MPI_Comm>` that reports all calls to the `MPITracer`
+
+     Can be used wherever the type of the communication is a template
+     parameter. If tracing is not enabled, nothing is recorded and the
+     overhead is negligible compared to the communication.
+
+     \warning The methods of `Communication<MPI_Comm>` are not virtual, they
+              are only hidden by the methods of this class. If it is passed
+              as a `Communication<MPI_Comm>`, by value or by reference, the
+              calls through that object are not traced.
+     \code
+     Dune::MPITracer::instance().enable("trace");
+     Dune::TracingCommunication comm(MPI_COMM_WORLD);
+     double sum = comm.sum(x);
+     auto future = comm.iallreduce<std::plus<double>>(x);
+     \endcode
+     Non-blocking calls return an `MPITracedFuture`. Blocking collectives
+     are recorded with the time from entering to leaving the call as wait
+     time, which includes the time waiting for the other ranks.
+   */
+  class TracingCommunication
+    : public Communication<MPI_Comm>
+  {
+    using Base = Communication<MPI_Comm>;
+
+    template<class T>
+    static std::size_t bytes (int len)
+    {
+      int size;
+      MPI_Type_size(MPITraits<T>::getType(), &size);
+      return std::size_t(size) * len;
+    }
+
+    template<class MPIData>
+    static std::size_t bytes (MPIData&& data)
+    {
+      int size;
+      MPI_Type_size(data.type(), &size);
+      return std::size_t(size) * data.size();
+    }
+
+    static MPITracer& tracer ()
+    {
+      return MPITracer::instance();
+    }
+
+    // run a blocking call and record it as waiting from start to end
+    template<class F>
+    decltype(auto) trace (const char* operation, int peer, std::size_t sent, std::size_t received, F&& f) const
+    {
+      if (!tracer().enabled())
+        return f();
+      const double post = MPITracer::now();
+      decltype(auto) result = f();
+      tracer().record(operation, *this, peer, sent, received, post);
+      return result;
+    }
+
+    template<class Future>
+    MPITracedFuture<Future> traceFuture (const char* operation, int peer, std::size_t sent,
+                                         std::size_t received, double post, Future&& future) const
+    {
+      return MPITracedFuture<Future>(std::move(future), operation, *this, peer, sent, received, post);
+    }
+
+  public:
+    //! Instantiation using a MPI communicator
+    TracingCommunication (const MPI_Comm& c = MPI_COMM_WORLD)
+      : Base(c)
+    {}
+
+    //! Decorate an existing communication
+    TracingCommunication (const Base& comm)
+      : Base(comm)
+    {}
+
+    //! @copydoc Communication::send
+    template<class T>
+    int send (const T& data, int dest_rank, int tag) const
+    {
+      auto& lvalue = const_cast<T&>(data);
+      return trace("send", dest_rank, bytes(getMPIData(lvalue)), 0,
+                   [&]{ return Base::send(data, dest_rank, tag); });
+    }
+
+    //! @copydoc Communication::recv
+    template<class T>
+    T recv (T&& data, int source_rank, int tag, MPI_Status* status = MPI_STATUS_IGNORE) const
+    {
+      if (!tracer().enabled())
+        return Base::recv(std::forward<T>(data), source_rank, tag, status);
+      MPI_Status localStatus;
+      if (status == MPI_STATUS_IGNORE)
+        status = &localStatus;
+      const double post = MPITracer::now();
+      T result = Base::recv(std::forward<T>(data), source_rank, tag, status);
+      int count = 0;
+      MPI_Get_count(status, MPI_BYTE, &count);
+      tracer().record("recv", *this, status->MPI_SOURCE, 0, count, post);
+      return result;
+    }
+
+    //! @copydoc Communication::isend
+    template<class T>
+    auto isend (T&& data, int dest_rank, int tag) const
+    {
+      const double post = MPITracer::now();
+      auto future = Base::isend(std::forward<T>(data), dest_rank, tag);
+      const std::size_t sent = tracer().enabled() ? bytes(future.get_mpidata()) : 0;
+      return traceFuture("isend", dest_rank, sent, 0, post, std::move(future));
+    }
+
+    //! @copydoc Communication::irecv
+    template<class T>
+    auto irecv (T&& data, int source_rank, int tag) const
+    {
+      const double post = MPITracer::now();
+      auto future = Base::irecv(std::forward<T>(data), source_rank, tag);
+      const std::size_t received = tracer().enabled() ? bytes(future.get_mpidata()) : 0;
+      return traceFuture("irecv", source_rank, 0, received, post, std::move(future));
+    }
+
+    //! @copydoc Communication::sum
+    template<typename T>
+    T sum (const T& in) const
+    {
+      return trace("sum", -1, bytes<T>(1), bytes<T>(1), [&]{ return Base::sum(in); });
+    }
+
+    //! @copydoc Communication::sum
+    template<typename T>
+    int sum (T* inout, int len) const
+    {
+      return trace("sum", -1, bytes<T>(len), bytes<T>(len), [&]{ return Base::sum(inout, len); });
+    }
+
+    //! @copydoc Communication::prod
+    template<typename T>
+    T prod (const T& in) const
+    {
+      return trace("prod", -1, bytes<T>(1), bytes<T>(1), [&]{ return Base::prod(in); });
+    }
+
+    //! @copydoc Communication::prod
+    template<typename T>
+    int prod (T* inout, int len) const
+    {
+      return trace("prod", -1, bytes<T>(len), bytes<T>(len), [&]{ return Base::prod(inout, len); });
+    }
+
+    //! @copydoc Communication::min
+    template<typename T>
+    T min (const T& in) const
+    {
+      return trace("min", -1, bytes<T>(1), bytes<T>(1), [&]{ return Base::min(in); });
+    }
+
+    //! @copydoc Communication::min
+    template<typename T>
+    int min (T* inout, int len) const
+    {
+      return trace("min", -1, bytes<T>(len), bytes<T>(len), [&]{ return Base::min(inout, len); });
+    }
+
+    //! @copydoc Communication::max
+    template<typename T>
+    T max (const T& in) const
+    {
+      return trace("max", -1, bytes<T>(1), bytes<T>(1), [&]{ return Base::max(in); });
+    }
+
+    //! @copydoc Communication::max
+    template<typename T>
+    int max (T* inout, int len) const
+    {
+      return trace("max", -1, bytes<T>(len), bytes<T>(len), [&]{ return Base::max(inout, len); });
+    }
+
+    //! @copydoc Communication::barrier
+    int barrier () const
+    {
+      return trace("barrier", -1, 0, 0, [&]{ return Base::barrier(); });
+    }
+
+    //! @copydoc Communication::ibarrier
+    auto ibarrier () const
+    {
+      return traceFuture("ibarrier", -1, 0, 0, MPITracer::now(), Base::ibarrier());
+    }
+
+    //! @copydoc Communication::broadcast
+    template<typename T>
+    int broadcast (T* inout, int len, int root) const
+    {
+      const std::size_t n = bytes<T>(len);
+      return trace("broadcast", -1, rank() == root ? n : 0, rank() == root ? 0 : n,
+                   [&]{ return Base::broadcast(inout, len, root); });
+    }
+
+    //! @copydoc Communication::ibroadcast
+    template<class T>
+    auto ibroadcast (T&& data, int root) const
+    {
+      const double post = MPITracer::now();
+      auto future = Base::ibroadcast(std::forward<T>(data), root);
+      const std::size_t n = tracer().enabled() ? bytes(future.get_mpidata()) : 0;
+      return traceFuture("ibroadcast", -1, rank() == root ? n : 0, rank() == root ? 0 : n, post, std::move(future));
+    }
+
+    //! @copydoc Communication::gather()
+    template<typename T>
+    int gather (const T* in, T* out, int len, int root) const
+    {
+      return trace("gather", -1, bytes<T>(len), rank() == root ? bytes<T>(len) * size() : 0,
+                   [&]{ return Base::gather(in, out, len, root); });
+    }
+
+    //! @copydoc Communication::gatherv()
+    template<typename T>
+    int gatherv (const T* in, int sendDataLen, T* out, int* recvDataLen, int* displ, int root) const
+    {
+      int received = 0;
+      if (rank() == root)
+        for (int i = 0; i < size(); ++i)
+          received += recvDataLen[i];
+      return trace("gatherv", -1, bytes<T>(sendDataLen), bytes<T>(received),
+                   [&]{ return Base::gatherv(in, sendDataLen, out, recvDataLen, displ, root); });
+    }
+
+    //! @copydoc Communication::scatter()
+    template<typename T>
+    int scatter (const T* sendData, T* recvData, int len, int root) const
+    {
+      return trace("scatter", -1, rank() == root ? bytes<T>(len) * size() : 0, bytes<T>(len),
+                   [&]{ return Base::scatter(sendData, recvData, len, root); });
+    }
+
+    //! @copydoc Communication::scatterv()
+    template<typename T>
+    int scatterv (const T* sendData, int* sendDataLen, int* displ, T* recvData, int recvDataLen, int root) const
+    {
+      int sent = 0;
+      if (rank() == root)
+        for (int i = 0; i < size(); ++i)
+          sent += sendDataLen[i];
+      return trace("scatterv", -1, bytes<T>(sent), bytes<T>(recvDataLen),
+                   [&]{ return Base::scatterv(sendData, sendDataLen, displ, recvData, recvDataLen, root); });
+    }
+
+    //! @copydoc Communication::allgather()
+    template<typename T, typename T1>
+    int allgather (const T* sbuf, int count, T1* rbuf) const
+    {
+      return trace("allgather", -1, bytes<T>(count), bytes<T1>(count) * size(),
+                   [&]{ return Base::allgather(sbuf, count, rbuf); });
+    }
+
+    //! @copydoc Communication::allgatherv()
+    template<typename T>
+    int allgatherv (const T* in, int sendDataLen, T* out, int* recvDataLen, int* displ) const
+    {
+      int received = 0;
+      for (int i = 0; i < size(); ++i)
+        received += recvDataLen[i];
+      return trace("allgatherv", -1, bytes<T>(sendDataLen), bytes<T>(received),
+                   [&]{ return Base::allgatherv(in, sendDataLen, out, recvDataLen, displ); });
+    }
+
+    //! @copydoc Communication::allreduce(Type* inout,int len) const
+    template<typename BinaryFunction, typename Type>
+    int allreduce (Type* inout, int len) const
+    {
+      return trace("allreduce", -1, bytes<Type>(len), bytes<Type>(len),
+                   [&]{ return Base::allreduce<BinaryFunction>(inout, len); });
+    }
+
+    //! @copydoc Communication::allreduce(const Type* in,Type* out,int len) const
+    template<typename BinaryFunction, typename Type>
+    int allreduce (const Type* in, Type* out, int len) const
+    {
+      return trace("allreduce", -1, bytes<Type>(len), bytes<Type>(len),
+                   [&]{ return Base::allreduce<BinaryFunction>(in, out, len); });
+    }
+
+    //! @copydoc Communication::iallreduce
+    template<class BinaryFunction, class TIN, class TOUT = TIN>
+    auto iallreduce (TIN&& data_in, TOUT&& data_out) const
+    {
+      const double post = MPITracer::now();
+      auto future = Base::iallreduce<BinaryFunction>(std::forward<TIN>(data_in), std::forward<TOUT>(data_out));
+      const std::size_t n = tracer().enabled() ? bytes(future.get_mpidata()) : 0;
+      return traceFuture("iallreduce", -1, n, n, post, std::move(future));
+    }
+
+    //! @copydoc Communication::iallreduce
+    template<class BinaryFunction, class T>
+    auto iallreduce (T&& data) const
+    {
+      const double post = MPITracer::now();
+      auto future = Base::iallreduce<BinaryFunction>(std::forward<T>(data));
+      const std::size_t n = tracer().enabled() ? bytes(future.get_mpidata()) : 0;
+      return traceFuture("iallreduce", -1, n, n, post, std::move(future));
+    }
+  };
+
+} // namespace Dune
+
+#endif // HAVE_MPI
+
+#endif // DUNE_COMMON_PARALLEL_MPITRACER_HH
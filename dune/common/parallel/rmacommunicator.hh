@@ -0,0 +1,441 @@
+// -*- tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 2 -*-
+// vi: set et ts=4 sw=2 sts=2:
+// SPDX-FileCopyrightInfo: Copyright © DUNE Project contributors, see file LICENSE.md in module root
+// SPDX-License-Identifier: LicenseRef-GPL-2.0-only-with-DUNE-exception
+#ifndef DUNE_COMMON_PARALLEL_RMACOMMUNICATOR_HH
+#define DUNE_COMMON_PARALLEL_RMACOMMUNICATOR_HH
+
+#if HAVE_MPI
+
+#include <algorithm>
+#include <cassert>
+#include <cstddef>
+#include <cstring>
+#include <limits>
+#include <map>
+#include <memory>
+#include <new>
+#include <type_traits>
+#include <vector>
+
+#include <mpi.h>
+
+#include <dune/common/exceptions.hh>
+#include <dune/common/parallel/communicator.hh>
+#include <dune/common/parallel/interface.hh>
+
+namespace Dune
+{
+  /** @addtogroup Common_Parallel
+   *
+   * @{
+   */
+  /**
+   * @file
+   * @brief A communicator for distributed data structures based on one-sided
+   * MPI communication.
+   */
+
+  /**
+   * @brief A communicator that writes the data directly into the receive
+   * buffers of the remote processes using one-sided MPI communication.
+   *
+   * It is a drop-in replacement for BufferedCommunicator: it is set up with the
+   * same Interface and uses the same CommPolicy and GatherScatter concepts.
+   * Hence existing data handles can switch the communication backend by
+   * only changing the type of the communicator.
+   *
+   * The receive buffers of all neighbours are exposed in one `MPI_Win`. The
+   * offsets of the messages in the remote windows are exchanged once in build().
+   * During forward() and backward() the data is gathered into a local send
+   * buffer and written with one `MPI_Put` per neighbour. The epochs are
+   * synchronized with generalized active target synchronization
+   * (post-start-complete-wait), which only involves the actual neighbours
+   * and avoids the handshake of the two-sided rendezvous protocol for small
+   * messages.
+   *
+   * @note build() is collective on the communicator of the interface, as the
+   * window is created there.
+   */
+  class RMACommunicator
+  {
+  public:
+    /**
+     * @brief Constructor.
+     */
+    RMACommunicator();
+
+    /**
+     * @brief Build the buffers and information for the communication process.
+     *
+     * @param interface The interface that defines what indices are to be communicated.
+     */
+    template<class Data, class Interface>
+    typename std::enable_if<std::is_same<SizeOne,typename CommPolicy<Data>::IndexedTypeFlag>::value, void>::type
+    build(const Interface& interface);
+
+    /**
+     * @brief Build the buffers and information for the communication process.
+     *
+     * @param source The source in a forward send. The values will be copied from here to the send buffers.
+     * @param target The target in a forward send. The received values will be copied to here.
+     * @param interface The interface that defines what indices are to be communicated.
+     */
+    template<class Data, class Interface>
+    void build(const Data& source, const Data& target, const Interface& interface);
+
+    /**
+     * @brief Send from source to target.
+     *
+     * @see BufferedCommunicator::forward(const Data&, Data&) for the requirements on GatherScatter.
+     * @param source The values will be copied from here to the send buffers.
+     * @param dest The received values will be copied to here.
+     */
+    template<class GatherScatter, class Data>
+    void forward(const Data& source, Data& dest);
+
+    /**
+     * @brief Communicate in the reverse direction, i.e. send from target to source.
+     *
+     * @see BufferedCommunicator::backward(Data&, const Data&) for the requirements on GatherScatter.
+     * @param dest The values will be copied from here to the send buffers.
+     * @param source The received values will be copied to here.
+     */
+    template<class GatherScatter, class Data>
+    void backward(Data& source, const Data& dest);
+
+    /**
+     * @brief Forward send where target and source are the same.
+     * @param data Source and target of the communication.
+     */
+    template<class GatherScatter, class Data>
+    void forward(Data& data);
+
+    /**
+     * @brief Backward send where target and source are the same.
+     * @param data Source and target of the communication.
+     */
+    template<class GatherScatter, class Data>
+    void backward(Data& data);
+
+    /**
+     * @brief Free the window, the buffers and the message information.
+     *
+     * Collective on the communicator of the interface.
+     */
+    void free();
+
+    /**
+     * @brief Destructor.
+     */
+    ~RMACommunicator();
+
+  private:
+    RMACommunicator(const RMACommunicator&) = delete;
+    RMACommunicator& operator=(const RMACommunicator&) = delete;
+
+    /**
+     * @brief The type of the map that maps interface information to processors.
+     */
+    typedef std::map<int,std::pair<InterfaceInformation,InterfaceInformation> >
+    InterfaceMap;
+
+    /**
+     * @brief Information about the messages exchanged with one process.
+     *
+     * All starts and sizes are in bytes. The forward send buffer and the
+     * backward receive region share one layout, as do the forward receive
+     * region and the backward send buffer.
+     */
+    struct MessageInformation
+    {
+      std::size_t sendStart_ = 0;
+      std::size_t sendSize_ = 0;
+      std::size_t recvStart_ = 0;
+      std::size_t recvSize_ = 0;
+      /** @brief Displacement of our forward message in the remote window. */
+      MPI_Aint remoteForward_ = 0;
+      /** @brief Displacement of our backward message in the remote window. */
+      MPI_Aint remoteBackward_ = 0;
+    };
+
+    typedef std::map<int,MessageInformation> InformationMap;
+
+    /**
+     * @brief Deleter of the send buffer, which is allocated with the alignment of the communicated type.
+     */
+    struct AlignedDelete
+    {
+      std::align_val_t alignment;
+      void operator()(char* buffer) const { ::operator delete(buffer, alignment); }
+    };
+
+    /**
+     * @brief Set up message layout, window and groups for the given sizes.
+     */
+    template<class Data, class Interface, class SizeFunction>
+    void setup(const Interface& interface, SizeFunction&& sizes);
+
+    /**
+     * @brief Gather, put and scatter the data.
+     */
+    template<class GatherScatter, bool FORWARD, class Data>
+    void sendRecv(const Data& source, Data& dest);
+
+    InterfaceMap interfaces_;
+    InformationMap messageInformation_;
+    MPI_Comm communicator_;
+
+    /** @brief Total size of forward (0) and backward (1) send buffer in bytes. */
+    std::size_t sendSize_[2];
+    std::unique_ptr<char,AlignedDelete> sendBuffer_;
+
+    /** @brief The exposed receive buffers, forward region first. */
+    MPI_Win window_;
+    char* windowBuffer_;
+
+    /** @brief Processes we put to in a forward (0) and backward (1) communication. */
+    MPI_Group sendGroup_[2];
+
+    /**
+     * @brief The tag we use for exchanging the window offsets.
+     */
+    constexpr static int commTag_ = 235;
+  };
+
+#ifndef DOXYGEN
+
+  inline RMACommunicator::RMACommunicator()
+    : communicator_(MPI_COMM_NULL), window_(MPI_WIN_NULL), windowBuffer_(nullptr)
+  {
+    sendSize_[0] = sendSize_[1] = 0;
+    sendGroup_[0] = sendGroup_[1] = MPI_GROUP_NULL;
+  }
+
+  inline RMACommunicator::~RMACommunicator()
+  {
+    free();
+  }
+
+  inline void RMACommunicator::free()
+  {
+    int finalized = 0;
+    MPI_Finalized(&finalized);
+    if (!finalized) {
+      if (window_ != MPI_WIN_NULL)
+        MPI_Win_free(&window_);
+      for (auto& group : sendGroup_)
+        if (group != MPI_GROUP_NULL)
+          MPI_Group_free(&group);
+    }
+    window_ = MPI_WIN_NULL;
+    windowBuffer_ = nullptr;
+    sendGroup_[0] = sendGroup_[1] = MPI_GROUP_NULL;
+    messageInformation_.clear();
+    sendBuffer_.reset();
+  }
+
+  template<class Data, class Interface>
+  typename std::enable_if<std::is_same<SizeOne, typename CommPolicy<Data>::IndexedTypeFlag>::value, void>::type
+  RMACommunicator::build(const Interface& interface)
+  {
+    setup<Data>(interface, [](const InterfaceInformation& info, bool) {
+        return std::size_t(info.size());
+      });
+  }
+
+  template<class Data, class Interface>
+  void RMACommunicator::build(const Data& source, const Data& dest, const Interface& interface)
+  {
+    setup<Data>(interface, [&](const InterfaceInformation& info, bool send) {
+        const Data& data = send ? source : dest;
+        std::size_t entries = 0;
+        for (std::size_t i = 0; i < info.size(); i++)
+          entries += CommPolicy<Data>::getSize(data, info[i]);
+        return entries;
+      });
+  }
+
+  template<class Data, class Interface, class SizeFunction>
+  void RMACommunicator::setup(const Interface& interface, SizeFunction&& sizes)
+  {
+    typedef typename CommPolicy<Data>::IndexedType Type;
+    static_assert(std::is_trivially_copyable<Type>::value,
+                  "RMACommunicator can only communicate trivially copyable types");
+
+    free();
+    interfaces_ = interface.interfaces();
+    communicator_ = interface.communicator();
+
+    // compute the message layout, each message is put with an int count
+    const std::size_t maxMessageSize = std::numeric_limits<int>::max();
+    int tooLarge = 0;
+    sendSize_[0] = sendSize_[1] = 0;
+    for (const auto& interfacePair : interfaces_) {
+      std::size_t noSend = sizes(interfacePair.second.first, true) * sizeof(Type);
+      std::size_t noRecv = sizes(interfacePair.second.second, false) * sizeof(Type);
+      tooLarge = tooLarge || noSend > maxMessageSize || noRecv > maxMessageSize;
+      if (noSend + noRecv > 0) {
+        MessageInformation& info = messageInformation_[interfacePair.first];
+        info.sendStart_ = sendSize_[0];
+        info.sendSize_ = noSend;
+        info.recvStart_ = sendSize_[1];
+        info.recvSize_ = noRecv;
+      }
+      sendSize_[0] += noSend;
+      sendSize_[1] += noRecv;
+    }
+    // all ranks have to leave the collective setup together
+    MPI_Allreduce(MPI_IN_PLACE, &tooLarge, 1, MPI_INT, MPI_LOR, communicator_);
+    if (tooLarge) {
+      free();
+      DUNE_THROW(CommunicationError, "RMACommunicator: a message exceeds " << maxMessageSize << " bytes");
+    }
+
+    const std::align_val_t alignment{alignof(Type)};
+    sendBuffer_ = std::unique_ptr<char,AlignedDelete>(
+      static_cast<char*>(::operator new(std::max(sendSize_[0], sendSize_[1]), alignment)),
+      AlignedDelete{alignment});
+
+    // the window holds the forward receive region followed by the backward receive region
+    const MPI_Aint windowSize = static_cast<MPI_Aint>(sendSize_[1] + sendSize_[0]);
+    if (MPI_Win_allocate(windowSize, 1, MPI_INFO_NULL, communicator_, &windowBuffer_, &window_) != MPI_SUCCESS)
+      DUNE_THROW(CommunicationError, "MPI_Win_allocate failed");
+
+    // tell each neighbour where to put its messages in our window
+    std::vector<MPI_Aint> localOffsets, remoteOffsets(2*messageInformation_.size());
+    std::vector<MPI_Request> requests(2*messageInformation_.size());
+    localOffsets.reserve(2*messageInformation_.size());
+    for (const auto& [proc, info] : messageInformation_) {
+      localOffsets.push_back(info.recvStart_);
+      localOffsets.push_back(sendSize_[1] + info.sendStart_);
+    }
+    std::size_t i = 0;
+    for (const auto& entry : messageInformation_) {
+      MPI_Irecv(remoteOffsets.data()+2*i, 2, MPI_AINT, entry.first, commTag_, communicator_, requests.data()+i);
+      ++i;
+    }
+    i = 0;
+    for (const auto& entry : messageInformation_) {
+      MPI_Isend(localOffsets.data()+2*i, 2, MPI_AINT, entry.first, commTag_, communicator_,
+                requests.data()+messageInformation_.size()+i);
+      ++i;
+    }
+    MPI_Waitall(int(requests.size()), requests.data(), MPI_STATUSES_IGNORE);
+
+    i = 0;
+    std::vector<int> targets[2];
+    for (auto& [proc, info] : messageInformation_) {
+      info.remoteForward_ = remoteOffsets[2*i];
+      info.remoteBackward_ = remoteOffsets[2*i+1];
+      if (info.sendSize_ > 0)
+        targets[0].push_back(proc);
+      if (info.recvSize_ > 0)
+        targets[1].push_back(proc);
+      ++i;
+    }
+
+    // groups for the post-start-complete-wait synchronization
+    MPI_Group commGroup;
+    MPI_Comm_group(communicator_, &commGroup);
+    for (int dir = 0; dir < 2; ++dir)
+      MPI_Group_incl(commGroup, int(targets[dir].size()), targets[dir].data(), &sendGroup_[dir]);
+    MPI_Group_free(&commGroup);
+  }
+
+  template<class GatherScatter,class Data>
+  void RMACommunicator::forward(Data& data)
+  {
+    this->template sendRecv<GatherScatter,true>(data, data);
+  }
+
+  template<class GatherScatter, class Data>
+  void RMACommunicator::backward(Data& data)
+  {
+    this->template sendRecv<GatherScatter,false>(data, data);
+  }
+
+  template<class GatherScatter, class Data>
+  void RMACommunicator::forward(const Data& source, Data& dest)
+  {
+    this->template sendRecv<GatherScatter,true>(source, dest);
+  }
+
+  template<class GatherScatter, class Data>
+  void RMACommunicator::backward(Data& source, const Data& dest)
+  {
+    this->template sendRecv<GatherScatter,false>(dest, source);
+  }
+
+  template<class GatherScatter, bool FORWARD, class Data>
+  void RMACommunicator::sendRecv(const Data& source, Data& dest)
+  {
+    typedef typename CommPolicy<Data>::IndexedType Type;
+    typedef typename CommPolicy<Data>::IndexedTypeFlag Flag;
+
+    assert(window_ != MPI_WIN_NULL);
+
+    // In a forward communication we put to the processes we send to and
+    // are written to by the processes we receive from, and vice versa.
+    MPI_Group putGroup = FORWARD ? sendGroup_[0] : sendGroup_[1];
+    MPI_Group exposeGroup = FORWARD ? sendGroup_[1] : sendGroup_[0];
+    MPI_Win_post(exposeGroup, 0, window_);
+
+    // gather all messages into the send buffer
+    Type* buffer = static_cast<Type*>(static_cast<void*>(sendBuffer_.get()));
+    std::size_t index = 0;
+    for (const auto& interfacePair : interfaces_) {
+      const InterfaceInformation& info = FORWARD ? interfacePair.second.first : interfacePair.second.second;
+      for (std::size_t i = 0; i < info.size(); i++) {
+        if constexpr (std::is_same<Flag,SizeOne>::value)
+          buffer[index++] = GatherScatter::gather(source, info[i]);
+        else
+          for (std::size_t j = 0; j < std::size_t(CommPolicy<Data>::getSize(source, info[i])); j++)
+            buffer[index++] = GatherScatter::gather(source, info[i], j);
+      }
+    }
+    assert(index*sizeof(Type) == sendSize_[FORWARD ? 0 : 1]);
+
+    MPI_Win_start(putGroup, 0, window_);
+    for (const auto& [proc, info] : messageInformation_) {
+      const std::size_t start = FORWARD ? info.sendStart_ : info.recvStart_;
+      // the size was checked against the range of int in setup()
+      const int size = int(FORWARD ? info.sendSize_ : info.recvSize_);
+      if (size > 0)
+        MPI_Put(sendBuffer_.get()+start, size, MPI_BYTE, proc,
+                FORWARD ? info.remoteForward_ : info.remoteBackward_, size, MPI_BYTE, window_);
+    }
+    MPI_Win_complete(window_);
+    MPI_Win_wait(window_);
+
+    // scatter the received messages
+    const char* recvRegion = windowBuffer_ + (FORWARD ? 0 : sendSize_[1]);
+    for (const auto& [proc, message] : messageInformation_) {
+      const std::size_t start = FORWARD ? message.recvStart_ : message.sendStart_;
+      const auto& interfacePair = interfaces_.find(proc)->second;
+      const InterfaceInformation& info = FORWARD ? interfacePair.second : interfacePair.first;
+      Type value;
+      std::size_t offset = start;
+      for (std::size_t i = 0; i < info.size(); i++) {
+        if constexpr (std::is_same<Flag,SizeOne>::value) {
+          std::memcpy(&value, recvRegion+offset, sizeof(Type));
+          offset += sizeof(Type);
+          GatherScatter::scatter(dest, value, info[i]);
+        }
+        else
+          for (std::size_t j = 0; j < std::size_t(CommPolicy<Data>::getSize(dest, info[i])); j++) {
+            std::memcpy(&value, recvRegion+offset, sizeof(Type));
+            offset += sizeof(Type);
+            GatherScatter::scatter(dest, value, info[i], j);
+          }
+      }
+    }
+  }
+
+#endif  // DOXYGEN
+
+  /** @} */
+}
+
+#endif // HAVE_MPI
+#endif // DUNE_COMMON_PARALLEL_RMACOMMUNICATOR_HH
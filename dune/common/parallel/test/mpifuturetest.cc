@@ -4,6 +4,7 @@
 #include <functional>
 #include <iostream>
 #include <numeric>
+#include <string>
 #include <vector>
 
 #include <dune/common/dynvector.hh>
@@ -11,6 +12,8 @@
 #include <dune/common/parallel/mpidata.hh>
 #include <dune/common/parallel/mpifuture.hh>
 #include <dune/common/parallel/mpihelper.hh>
+#include <dune/common/parallel/mpiprogressengine.hh>
+#include <dune/common/test/testsuite.hh>
 
 namespace Dune {
   template<class Dummy>
@@ -114,6 +117,88 @@ int main(int argc, char** argv){
     std::cout << "Allreduce result on rank " << mpihelper.rank() <<": " << f.get() << std::endl;
   }
 
+  Dune::TestSuite suite;
+  const int size = mpihelper.size();
+  const int sumOfRanks = size*(size-1)/2;
+
+  {
+    if(mpihelper.rank() == 0)
+      std::cout << "continuations ===========================" << std::endl;
+    auto f = cc.iallreduce<std::plus<int>>(mpihelper.rank())
+      .then([](int sum){ return 2*sum; })
+      .then([](int twice){ return std::to_string(twice); });
+    suite.check(f.get() == std::to_string(2*sumOfRanks)) << "wrong result of chained continuation";
+    suite.check(!f.valid()) << "continuation must be invalid after get()";
+
+    bool called = false;
+    auto g = cc.ibarrier().then([&]{ called = true; });
+    g.wait();
+    suite.check(called) << "continuation of ibarrier was not invoked";
+  }
+
+  {
+    if(mpihelper.rank() == 0)
+      std::cout << "multi-future wait ===========================" << std::endl;
+    std::vector<Dune::MPIFuture<int>> futures;
+    for(int i = 0; i < 5; ++i)
+      futures.push_back(cc.iallreduce<std::plus<int>>(mpihelper.rank() + i));
+    Dune::waitAll(futures);
+    for(int i = 0; i < 5; ++i){
+      suite.check(futures[i].ready()) << "future " << i << " not ready after waitAll";
+      suite.check(futures[i].get() == sumOfRanks + i*size) << "wrong result of future " << i;
+    }
+
+    std::vector<int> results(5, -1);
+    auto store = [&](int i){ return [&results, i](int sum){ results[i] = sum; return sum; }; };
+    using Continuation = decltype(cc.iallreduce<std::plus<int>>(0).then(store(0)));
+    std::vector<Continuation> continuations;
+    for(int i = 0; i < 5; ++i)
+      continuations.push_back(cc.iallreduce<std::plus<int>>(mpihelper.rank() + i).then(store(i)));
+    std::size_t completed = 0;
+    while(completed < continuations.size()){
+      auto indices = Dune::waitSome(continuations);
+      suite.require(!indices.empty()) << "waitSome did not complete any future";
+      completed += indices.size();
+    }
+    for(int i = 0; i < 5; ++i)
+      suite.check(results[i] == sumOfRanks + i*size) << "continuation " << i << " not run by waitSome";
+    suite.check(Dune::testSome(continuations).empty()) << "testSome on completed futures must be empty";
+
+    // MPI may report the completed requests in any order
+    std::fill(results.begin(), results.end(), -1);
+    continuations.clear();
+    for(int i = 0; i < 5; ++i)
+      continuations.push_back(cc.iallreduce<std::plus<int>>(mpihelper.rank() + i).then(store(i)));
+    auto indices = Dune::Impl::completeSome(continuations, [](int n, MPI_Request* r, int* count, int* indices){
+      MPI_Waitall(n, r, MPI_STATUSES_IGNORE);
+      *count = n;
+      for(int i = 0; i < n; ++i)
+        indices[i] = n-1-i;
+    });
+    suite.check(indices == std::vector<std::size_t>{0, 1, 2, 3, 4}) << "completed indices not sorted";
+    for(int i = 0; i < 5; ++i)
+      suite.check(results[i] == sumOfRanks + i*size) << "continuation " << i << " not run for unordered indices";
+  }
+
+  {
+    if(mpihelper.rank() == 0)
+      std::cout << "progress engine ===========================" << std::endl;
+    Dune::MPIProgressEngine engine;
+    int sum = -1, chained = -1;
+    engine.add(cc.iallreduce<std::plus<int>>(mpihelper.rank()), [&](int s){
+        sum = s;
+        // callbacks may start new communication
+        engine.add(cc.iallreduce<std::plus<int>>(int(s)), [&](int t){ chained = t; });
+      });
+    engine.add(cc.ibarrier());
+    suite.check(engine.size() == 2) << "wrong number of outstanding requests";
+    while(!engine.empty())
+      engine.progress();
+    suite.check(sum == sumOfRanks) << "wrong result from progress engine";
+    suite.check(chained == size*sumOfRanks) << "wrong result of chained communication";
+    engine.waitAll();
+  }
+
   // that's wrong, MPIFuture will hold a dangeling reference:
   // Dune::MPIFuture<int&> g;
   // {
@@ -121,5 +206,5 @@ int main(int argc, char** argv){
   //   g = cc.iallreduce<std::plus<int>>(i);
   // }
   // g.wait();
-  return 0;
+  return suite.exit();
 }
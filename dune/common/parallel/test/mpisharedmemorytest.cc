@@ -0,0 +1,49 @@
+// SPDX-FileCopyrightInfo: Copyright © DUNE Project contributors, see file LICENSE.md in module root
+// SPDX-License-Identifier: LicenseRef-GPL-2.0-only-with-DUNE-exception
+#include <cstddef>
+#include <utility>
+
+#include <dune/common/parallel/mpihelper.hh>
+#include <dune/common/parallel/mpisharedmemory.hh>
+#include <dune/common/test/testsuite.hh>
+
+int main(int argc, char** argv)
+{
+  auto& mpihelper = Dune::MPIHelper::instance(argc, argv);
+  Dune::TestSuite suite;
+
+  const std::size_t n = 6, m = 4;
+  Dune::SharedMemoryWindow<double> window(n*m);
+  suite.check(window.size() == n*m) << "Wrong size of shared memory window";
+  suite.check(window.isRoot() == (mpihelper.nodeRank() == 0)) << "Root must be node rank 0";
+
+  // the root process fills the table
+  if (window.isRoot()) {
+    auto table = window.mdspan(n, m);
+    for (std::size_t i = 0; i < n; ++i)
+      for (std::size_t j = 0; j < m; ++j)
+        table(i,j) = 10.0*i + j;
+  }
+  window.barrier();
+
+  // all processes of the node see the same data
+  auto s = window.span();
+  suite.check(s.size() == n*m) << "Wrong size of span";
+  for (std::size_t k = 0; k < s.size(); ++k)
+    suite.check(s[k] == 10.0*(k/m) + (k%m)) << "Wrong value at " << k;
+
+  // static extents
+  auto table = window.mdspan(Dune::Std::extents<std::size_t,6,4>{});
+  suite.check(table(5,3) == 53.0) << "Wrong value in mdspan view";
+
+  suite.checkThrow<Dune::RangeError>([&]{ window.mdspan(n+1, m); })
+    << "Oversized extents must throw";
+
+  // moving transfers the ownership of the window
+  Dune::SharedMemoryWindow<double> moved(std::move(window));
+  suite.check(moved.data() == s.data()) << "Move must keep the shared region";
+  suite.check(window.data() == nullptr) << "Moved-from window must be empty";
+  moved.barrier();
+
+  return suite.exit();
+}
@@ -0,0 +1,86 @@
+// SPDX-FileCopyrightInfo: Copyright © DUNE Project contributors, see file LICENSE.md in module root
+// SPDX-License-Identifier: LicenseRef-GPL-2.0-only-with-DUNE-exception
+#include <functional>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include <dune/common/parallel/future.hh>
+#include <dune/common/parallel/mpihelper.hh>
+#include <dune/common/parallel/mpitracer.hh>
+#include <dune/common/test/testsuite.hh>
+
+int main(int argc, char** argv){
+  auto& mpihelper = Dune::MPIHelper::instance(argc, argv);
+  const int rank = mpihelper.rank();
+  const int size = mpihelper.size();
+  Dune::TestSuite suite;
+
+  Dune::MPITracer& tracer = Dune::MPITracer::instance();
+  Dune::TracingCommunication comm(mpihelper.getCommunicator());
+
+  // nothing is recorded unless tracing is enabled
+  comm.sum(1);
+  suite.check(tracer.summary().empty()) << "call recorded without tracing";
+
+  tracer.enable();
+
+  // collectives
+  int sum = comm.sum(rank);
+  suite.check(sum == size*(size-1)/2) << "wrong result of the decorated sum";
+  std::vector<double> values(4, 1.0);
+  comm.max(values.data(), values.size());
+  comm.barrier();
+
+  // ring exchange with futures
+  const int next = (rank + 1) % size;
+  const int prev = (rank + size - 1) % size;
+  auto recv = comm.irecv(std::vector<double>(8), prev, 42);
+  Dune::Future<std::vector<double>> send = comm.isend(std::vector<double>(8, rank), next, 42);
+  std::vector<double> received = recv.get();
+  send.wait();
+  suite.check(received.size() == 8 && received[0] == prev) << "wrong data received";
+
+  auto continuation = comm.iallreduce<std::plus<int>>(1).then([](int n){ return 2*n; });
+  suite.check(continuation.get() == 2*size) << "wrong result of the continuation";
+
+  tracer.disable();
+  comm.sum(1);
+
+  auto summary = tracer.summary();
+  suite.check(summary["sum"].calls == 1) << "wrong number of sums " << summary["sum"].calls;
+  suite.check(summary["sum"].sentBytes == sizeof(int)) << "wrong bytes of sum";
+  suite.check(summary["max"].sentBytes == 4*sizeof(double)) << "wrong bytes of max";
+  suite.check(summary["barrier"].calls == 1) << "barrier not recorded";
+  suite.check(summary["isend"].calls == 1 && summary["isend"].sentBytes == 8*sizeof(double))
+    << "isend not recorded";
+  suite.check(summary["irecv"].calls == 1 && summary["irecv"].receivedBytes == 8*sizeof(double))
+    << "irecv not recorded";
+  suite.check(summary["iallreduce"].calls == 1) << "iallreduce not recorded";
+  suite.check(summary["irecv"].wait >= 0.0 && summary["irecv"].wait <= summary["irecv"].time + 1e-9)
+    << "waiting time longer than the communication";
+
+  // the ring shows up in the communication matrix
+  auto matrix = tracer.matrix();
+  for (int i = 0; i < size; ++i)
+    for (int j = 0; j < size; ++j)
+    {
+      const bool neighbor = (j == (i + 1) % size);
+      suite.check(matrix.first[i*size+j] == (neighbor ? 1u : 0u))
+        << "wrong number of messages from " << i << " to " << j;
+      suite.check(matrix.second[i*size+j] == (neighbor ? 8*sizeof(double) : 0u))
+        << "wrong number of bytes from " << i << " to " << j;
+    }
+
+  std::ostringstream table;
+  tracer.writeMatrix(table);
+  suite.check((rank == 0) == (table.str().find("isend") != std::string::npos))
+    << "summary not written on rank 0";
+
+  std::ostringstream timeline;
+  tracer.writeTimeline(timeline);
+  suite.check(timeline.str().find("\"peer\": " + std::to_string(next)) != std::string::npos)
+    << "isend missing in the timeline";
+
+  return suite.exit();
+}
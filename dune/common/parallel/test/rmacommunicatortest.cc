@@ -0,0 +1,107 @@
+// SPDX-FileCopyrightInfo: Copyright © DUNE Project contributors, see file LICENSE.md in module root
+// SPDX-License-Identifier: LicenseRef-GPL-2.0-only-with-DUNE-exception
+#include <iostream>
+#include <vector>
+
+#include <dune/common/enumset.hh>
+#include <dune/common/parallel/communicator.hh>
+#include <dune/common/parallel/indexset.hh>
+#include <dune/common/parallel/interface.hh>
+#include <dune/common/parallel/mpihelper.hh>
+#include <dune/common/parallel/plocalindex.hh>
+#include <dune/common/parallel/remoteindices.hh>
+#include <dune/common/parallel/rmacommunicator.hh>
+#include <dune/common/test/testsuite.hh>
+
+enum GridFlags {
+  owner, overlap
+};
+
+typedef Dune::ParallelLocalIndex<GridFlags> LocalIndex;
+typedef Dune::ParallelIndexSet<int,LocalIndex> ParallelIndexSet;
+typedef std::vector<double> Vector;
+
+// Set up a 1D distribution with nx owned indices per process and one
+// overlap index to each neighbour.
+void setupDistributed(ParallelIndexSet& indexSet, Vector& v, std::vector<int>& global,
+                      int nx, int rank, int procs)
+{
+  const int start = rank*nx;
+  const int end = start + nx;
+  const int ostart = rank > 0 ? start-1 : start;
+  const int oend = rank < procs-1 ? end+1 : end;
+
+  indexSet.beginResize();
+  int localIndex = 0;
+  for (int i = ostart; i < oend; i++) {
+    const bool isOverlap = (i < start || i >= end);
+    const bool isPublic = (i <= start) || (i >= end-1);
+    indexSet.add(i, LocalIndex(localIndex++, isOverlap ? overlap : owner, isPublic));
+    global.push_back(i);
+    v.push_back(isOverlap ? -1.0 : i);
+  }
+  indexSet.endResize();
+}
+
+template<class Communicator>
+void testCommunicator(Dune::TestSuite& suite, const Dune::Interface& interface,
+                      const std::vector<int>& global, const Vector& initial,
+                      const std::string& name)
+{
+  Vector v = initial;
+  Communicator comm;
+  comm.template build<Vector>(interface);
+
+  // the overlap receives the values of the owner
+  comm.template forward<Dune::CopyGatherScatter<Vector> >(v);
+  for (std::size_t i = 0; i < v.size(); i++)
+    suite.check(v[i] == global[i]) << name << ": wrong value after forward at " << global[i];
+
+  // repeated communication must reuse the window
+  for (std::size_t i = 0; i < v.size(); i++)
+    if (initial[i] < 0)
+      v[i] = 1000 + global[i];
+  comm.template backward<Dune::CopyGatherScatter<Vector> >(v);
+  comm.template forward<Dune::CopyGatherScatter<Vector> >(v);
+  for (std::size_t i = 0; i < v.size(); i++) {
+    // owned indices at the process boundary received the overlap values
+    const bool atBoundary = (i > 0 && initial[i-1] < 0) || (i+1 < v.size() && initial[i+1] < 0);
+    if (initial[i] >= 0 && !atBoundary)
+      suite.check(v[i] == global[i]) << name << ": interior value changed at " << global[i];
+    else
+      suite.check(v[i] == 1000 + global[i]) << name << ": wrong value after backward at " << global[i];
+  }
+
+  // separate source and target
+  Vector source = initial, target(initial.size(), -2.0);
+  Communicator comm2;
+  comm2.build(source, target, interface);
+  comm2.template forward<Dune::CopyGatherScatter<Vector> >(source, target);
+  for (std::size_t i = 0; i < target.size(); i++)
+    suite.check(target[i] == (initial[i] < 0 ? global[i] : -2.0))
+      << name << ": wrong value after forward with separate target at " << global[i];
+}
+
+int main(int argc, char** argv)
+{
+  auto& mpihelper = Dune::MPIHelper::instance(argc, argv);
+  Dune::TestSuite suite;
+
+  const int rank = mpihelper.rank(), procs = mpihelper.size();
+
+  ParallelIndexSet indexSet;
+  Vector initial;
+  std::vector<int> global;
+  setupDistributed(indexSet, initial, global, 5, rank, procs);
+
+  Dune::RemoteIndices<ParallelIndexSet> remoteIndices(indexSet, indexSet, MPI_COMM_WORLD);
+  remoteIndices.rebuild<false>();
+
+  Dune::Interface interface;
+  interface.build(remoteIndices, Dune::EnumItem<GridFlags,owner>(), Dune::EnumItem<GridFlags,overlap>());
+
+  testCommunicator<Dune::BufferedCommunicator>(suite, interface, global, initial, "BufferedCommunicator");
+  testCommunicator<Dune::RMACommunicator>(suite, interface, global, initial, "RMACommunicator");
+
+  return suite.exit();
+}
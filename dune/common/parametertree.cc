@@ -7,6 +7,7 @@
 #include <iostream>
 #include <ostream>
 #include <string>
+#include <string_view>
 #include <sstream>
 #include <fstream>
 #include <set>
@@ -14,6 +15,7 @@
 
 #include <dune/common/exceptions.hh>
 #include <dune/common/parametertree.hh>
+#include <dune/common/impl/jsonstring.hh>
 
 using namespace Dune;
 
@@ -31,14 +33,13 @@ const ParameterTree ParameterTree::empty_ = ParameterTree{ParameterTree::EmptyTa
 
 void ParameterTree::report(std::ostream& stream, const std::string& prefix) const
 {
-  typedef std::map<std::string, std::string>::const_iterator ValueIt;
-  ValueIt vit = values_.begin();
-  ValueIt vend = values_.end();
+  // values are stored unordered, report them sorted by key
+  KeyVector keys = valueKeys_;
+  std::sort(keys.begin(), keys.end());
+  for(const std::string& key : keys)
+    stream << key << " = \"" << values_.find(key)->second << "\"" << std::endl;
 
-  for(; vit!=vend; ++vit)
-    stream << vit->first << " = \"" << vit->second << "\"" << std::endl;
-
-  typedef std::map<std::string, ParameterTree>::const_iterator SubIt;
+  typedef std::map<std::string, ParameterTree, std::less<>>::const_iterator SubIt;
   SubIt sit = subs_.begin();
   SubIt send = subs_.end();
   for(; sit!=send; ++sit)
@@ -48,59 +49,159 @@ void ParameterTree::report(std::ostream& stream, const std::string& prefix) cons
   }
 }
 
-bool ParameterTree::hasKey(const std::string& key) const
-{
-  std::string::size_type dot = key.find(".");
+namespace {
 
-  if (dot != std::string::npos)
+  // lookup of a std::string key by std::string_view, heterogeneous lookup in
+  // unordered containers is missing in libstdc++ 10 and libc++ before 12
+  template<class Map>
+  auto findKey(const Map& map, std::string_view key)
   {
-    std::string prefix = key.substr(0,dot);
-    if (subs_.count(prefix) == 0)
-      return false;
+#if __cpp_lib_generic_unordered_lookup >= 201811L
+    return map.find(key);
+#else
+    return map.find(std::string(key));
+#endif
+  }
 
-    if (values_.count(prefix) > 0)
-      DUNE_THROW(RangeError,"key " << prefix << " occurs as value and as subtree");
+} // end anonymous namespace
+
+const std::string* ParameterTree::findValue(std::string_view key) const
+{
+  std::string_view::size_type dot = key.find('.');
 
-    const ParameterTree& s = sub(prefix);
-    return s.hasKey(key.substr(dot+1));
+  if (dot != std::string_view::npos)
+  {
+    const ParameterTree* s = findSub(key.substr(0,dot));
+    return s ? s->findValue(key.substr(dot+1)) : nullptr;
   }
   else
-    if (values_.count(key) != 0)
-      {
-        if (subs_.count(key) > 0)
-          DUNE_THROW(RangeError,"key " << key << " occurs as value and as subtree");
-        return true;
-      }
-    else
-      return false;
+  {
+    auto it = findKey(values_, key);
+    if (it == values_.end())
+      return nullptr;
+    if (subs_.find(key) != subs_.end())
+      DUNE_THROW(RangeError,"key " << key << " occurs as value and as subtree");
+    return &it->second;
+  }
+}
 
+const ParameterTree* ParameterTree::findSub(std::string_view key) const
+{
+  const ParameterTree* tree = this;
+  while (true)
+  {
+    std::string_view::size_type dot = key.find('.');
+    std::string_view prefix = key.substr(0,dot);
+    auto it = tree->subs_.find(prefix);
+    if (it == tree->subs_.end())
+      return nullptr;
+    if (findKey(tree->values_, prefix) != tree->values_.end())
+      DUNE_THROW(RangeError,"key " << prefix << " occurs as value and as subtree");
+    tree = &it->second;
+    if (dot == std::string_view::npos)
+      return tree;
+    key.remove_prefix(dot+1);
+  }
 }
 
-bool ParameterTree::hasSub(const std::string& key) const
+namespace {
+
+  // unsigned LEB128 encoding of sizes
+  void writeSize(std::ostream& stream, std::size_t size)
+  {
+    do {
+      unsigned char byte = size & 0x7f;
+      size >>= 7;
+      if (size != 0)
+        byte |= 0x80;
+      stream.put(static_cast<char>(byte));
+    } while (size != 0);
+  }
+
+  void writeString(std::ostream& stream, const std::string& s)
+  {
+    writeSize(stream, s.size());
+    stream.write(s.data(), s.size());
+  }
+
+} // end anonymous namespace
+
+void ParameterTree::writeBinary(std::ostream& stream) const
 {
-  std::string::size_type dot = key.find(".");
+  // the format is
+  //   file   := "DPT" version tree
+  //   tree   := size (string string)^size size (string tree)^size
+  //   string := size char^size
+  // with sizes in unsigned LEB128 encoding
+  stream.write("DPT", 3);
+  stream.put(char(1));
+  writeBinaryTree(stream);
+}
 
-  if (dot != std::string::npos)
+void ParameterTree::writeBinaryTree(std::ostream& stream) const
+{
+  writeSize(stream, valueKeys_.size());
+  for (const std::string& key : valueKeys_)
+  {
+    writeString(stream, key);
+    writeString(stream, values_.find(key)->second);
+  }
+  writeSize(stream, subKeys_.size());
+  for (const std::string& key : subKeys_)
   {
-    std::string prefix = key.substr(0,dot);
-    if (subs_.count(prefix) == 0)
-      return false;
+    writeString(stream, key);
+    subs_.find(key)->second.writeBinaryTree(stream);
+  }
+}
 
-    if (values_.count(prefix) > 0)
-      DUNE_THROW(RangeError,"key " << prefix << " occurs as value and as subtree");
+void ParameterTree::writeJSON(std::ostream& stream, int indent) const
+{
+  writeJSON(stream, indent, 0);
+  stream << std::endl;
+}
 
-    const ParameterTree& s = sub(prefix);
-    return s.hasSub(key.substr(dot+1));
+void ParameterTree::writeJSON(std::ostream& stream, int indent, int level) const
+{
+  const std::string newline = (indent > 0) ? "\n" : "";
+  const std::string inner(indent > 0 ? indent*(level+1) : 0, ' ');
+  const std::string outer(indent > 0 ? indent*level : 0, ' ');
+  const char* separator = (indent > 0) ? ": " : ":";
+
+  if (valueKeys_.empty() && subKeys_.empty())
+  {
+    stream << "{}";
+    return;
   }
-  else
-    if (subs_.count(key) != 0)
-      {
-        if (values_.count(key) > 0)
-          DUNE_THROW(RangeError,"key " << key << " occurs as value and as subtree");
-        return true;
-      }
-    else
-      return false;
+
+  stream << "{" << newline;
+  bool first = true;
+  for (const std::string& key : valueKeys_)
+  {
+    stream << (first ? "" : "," + newline) << inner;
+    Impl::writeJSONString(stream, key);
+    stream << separator;
+    Impl::writeJSONString(stream, values_.find(key)->second);
+    first = false;
+  }
+  for (const std::string& key : subKeys_)
+  {
+    stream << (first ? "" : "," + newline) << inner;
+    Impl::writeJSONString(stream, key);
+    stream << separator;
+    subs_.find(key)->second.writeJSON(stream, indent, level+1);
+    first = false;
+  }
+  stream << newline << outer << "}";
+}
+
+bool ParameterTree::hasKey(const std::string& key) const
+{
+  return findValue(key) != nullptr;
+}
+
+bool ParameterTree::hasSub(const std::string& key) const
+{
+  return findSub(key) != nullptr;
 }
 
 ParameterTree& ParameterTree::sub(const std::string& key)
@@ -169,36 +270,23 @@ std::string& ParameterTree::operator[] (const std::string& key)
 
 const std::string& ParameterTree::operator[] (const std::string& key) const
 {
-  std::string::size_type dot = key.find(".");
-
-  if (dot != std::string::npos)
-  {
-    const ParameterTree& s = sub(key.substr(0,dot));
-    return s[key.substr(dot+1)];
-  }
-  else
-  {
-    if (! hasKey(key))
-      DUNE_THROW(Dune::RangeError, "Key '" << key
-        << "' not found in ParameterTree (prefix " + prefix_ + ")");
-    return values_.find(key)->second;
-  }
+  const std::string* value = findValue(key);
+  if (! value)
+    DUNE_THROW(Dune::RangeError, "Key '" << key
+      << "' not found in ParameterTree (prefix " + prefix_ + ")");
+  return *value;
 }
 
 std::string ParameterTree::get(const std::string& key, const std::string& defaultValue) const
 {
-  if (hasKey(key))
-    return (*this)[key];
-  else
-    return defaultValue;
+  const std::string* value = findValue(key);
+  return value ? *value : defaultValue;
 }
 
 std::string ParameterTree::get(const std::string& key, const char* defaultValue) const
 {
-  if (hasKey(key))
-    return (*this)[key];
-  else
-    return defaultValue;
+  const std::string* value = findValue(key);
+  return value ? *value : std::string(defaultValue);
 }
 
 std::string ParameterTree::ltrim(const std::string& s)
@@ -9,18 +9,30 @@
  * \brief A hierarchical structure of string parameters
  */
 
+#include <any>
 #include <array>
+#include <cctype>
+#include <charconv>
 #include <cstddef>
+#include <functional>
 #include <iostream>
 #include <istream>
 #include <iterator>
 #include <locale>
 #include <map>
+#include <mutex>
 #include <ostream>
 #include <sstream>
 #include <string>
+#include <string_view>
+#include <system_error>
+#include <type_traits>
+#include <typeindex>
 #include <typeinfo>
+#include <unordered_map>
+#include <utility>
 #include <vector>
+#include <version>
 #include <algorithm>
 #include <bitset>
 
@@ -32,6 +44,11 @@ namespace Dune {
 
   /** \brief Hierarchical structure of string parameters
    * \ingroup Common
+   *
+   * Values converted by get() into types other than strings and arithmetic
+   * types (e.g., vectors) are cached, so repeated queries of the same key do
+   * not parse the string again. A cached value is only used as long as the
+   * string it was parsed from is unchanged.
    */
   class ParameterTree
   {
@@ -43,6 +60,75 @@ namespace Dune {
     struct EmptyTag {};
     ParameterTree(EmptyTag);
 
+    // hash for std::string keys supporting lookup by std::string_view
+    struct KeyHash
+    {
+      using is_transparent = void;
+
+      std::size_t operator() (std::string_view key) const noexcept
+      {
+        return std::hash<std::string_view>{}(key);
+      }
+    };
+
+    // cache of values converted by get(), the contents are not copied
+    class ConversionCache
+    {
+      struct Entry
+      {
+        std::string source;
+        std::any value;
+      };
+
+      using Key = std::pair<const std::string*, std::type_index>;
+
+      struct Hash
+      {
+        std::size_t operator() (const Key& key) const noexcept
+        {
+          return std::hash<const std::string*>{}(key.first) ^ (key.second.hash_code() << 1);
+        }
+      };
+
+    public:
+      ConversionCache () = default;
+      ConversionCache (const ConversionCache&) {}
+      ConversionCache& operator= (const ConversionCache&)
+      {
+        std::lock_guard<std::mutex> guard(mutex_);
+        entries_.clear();
+        return *this;
+      }
+
+      // return the value parsed from `value`, parse is only called on a cache miss
+      template<class T, class Parse>
+      T get (const std::string& value, Parse&& parse)
+      {
+        const Key key(&value, std::type_index(typeid(T)));
+        {
+          std::lock_guard<std::mutex> guard(mutex_);
+          auto it = entries_.find(key);
+          if (it != entries_.end() && it->second.source == value)
+            return std::any_cast<const T&>(it->second.value);
+        }
+        T result = parse(value);
+        std::lock_guard<std::mutex> guard(mutex_);
+        Entry& entry = entries_[key];
+        entry.source = value;
+        entry.value = result;
+        return result;
+      }
+
+    private:
+      std::mutex mutex_;
+      std::unordered_map<Key, Entry, Hash> entries_;
+    };
+
+    // whether values of type T are cached by get()
+    template<class T>
+    static constexpr bool isCached = std::is_copy_constructible_v<T>
+      && !std::is_arithmetic_v<T> && !std::is_constructible_v<T, std::string>;
+
   public:
 
     /** \brief storage for key lists
@@ -108,6 +194,29 @@ namespace Dune {
                 const std::string& prefix = "") const;
 
 
+    /** \brief write structure in a compact binary format
+     *
+     * Entries and substructures are written in order of appearance, so
+     * equal trees result in identical output. The data can be read with
+     * ParameterTreeParser::readBinary() on any platform.
+     *
+     * \param stream Stream to write to, should be opened in binary mode
+     */
+    void writeBinary(std::ostream& stream) const;
+
+
+    /** \brief write structure as JSON object
+     *
+     * Values are written as JSON strings and substructures as nested
+     * objects, in order of appearance. The output can be read with
+     * ParameterTreeParser::readJSON().
+     *
+     * \param stream Stream to write to
+     * \param indent Number of spaces per nesting level, 0 writes a single line
+     */
+    void writeJSON(std::ostream& stream, int indent = 2) const;
+
+
     /** \brief get substructure by name
      *
      * \param sub substructure name
@@ -159,8 +268,8 @@ namespace Dune {
      */
     template<typename T>
     T get(const std::string& key, const T& defaultValue) const {
-      if(hasKey(key))
-        return get<T>(key);
+      if(const std::string* value = findValue(key))
+        return convert<T>(key, *value);
       else
         return defaultValue;
     }
@@ -175,18 +284,11 @@ namespace Dune {
      */
     template <class T>
     T get(const std::string& key) const {
-      if(not hasKey(key))
+      const std::string* value = findValue(key);
+      if(not value)
         DUNE_THROW(Dune::RangeError, "Key '" << key
           << "' not found in ParameterTree (prefix " + prefix_ + ")");
-      try {
-        return Parser<T>::parse((*this)[key]);
-      }
-      catch(const RangeError& e) {
-        // rethrow the error and add more information
-        DUNE_THROW(RangeError, "Cannot parse value \"" << (*this)[key]
-          << "\" for key \"" << prefix_ << "." << key << "\""
-          << e.what());
-      }
+      return convert<T>(key, *value);
     }
 
     /** \brief get value keys
@@ -217,13 +319,41 @@ namespace Dune {
     KeyVector valueKeys_;
     KeyVector subKeys_;
 
-    std::map<std::string, std::string> values_;
-    std::map<std::string, ParameterTree> subs_;
+    std::unordered_map<std::string, std::string, KeyHash, std::equal_to<>> values_;
+    std::map<std::string, ParameterTree, std::less<>> subs_;
+
+    mutable ConversionCache conversions_;
+
+    // find the value or the substructure for a (dotted) key without
+    // creating it, return nullptr if it does not exist
+    const std::string* findValue(std::string_view key) const;
+    const ParameterTree* findSub(std::string_view key) const;
+
+    // convert the value of key to T, using the cache if applicable
+    template<class T>
+    T convert(const std::string& key, const std::string& value) const
+    {
+      try {
+        if constexpr (isCached<T>)
+          return conversions_.get<T>(value, Parser<T>::parse);
+        else
+          return Parser<T>::parse(value);
+      }
+      catch(const RangeError& e) {
+        // rethrow the error and add more information
+        DUNE_THROW(RangeError, "Cannot parse value \"" << value
+          << "\" for key \"" << prefix_ << "." << key << "\""
+          << e.what());
+      }
+    }
 
     static std::string ltrim(const std::string& s);
     static std::string rtrim(const std::string& s);
     static std::vector<std::string> split(const std::string & s);
 
+    void writeBinaryTree(std::ostream& stream) const;
+    void writeJSON(std::ostream& stream, int indent, int level) const;
+
     // parse into a fixed-size range of iterators
     template<class Iterator>
     static void parseRange(const std::string &str,
@@ -253,7 +383,41 @@ namespace Dune {
 
   template<typename T>
   struct ParameterTree::Parser {
+#if __cpp_lib_to_chars >= 201611L
+    static constexpr bool floatingPointFromChars = true;
+#else
+    // std::from_chars for floating-point types is missing in libstdc++ 10 and libc++ before 17
+    static constexpr bool floatingPointFromChars = false;
+#endif
+
+    // types parsed by std::from_chars, char types are read as characters by streams
+    static constexpr bool useFromChars
+      = (floatingPointFromChars && (std::is_same_v<T, float> || std::is_same_v<T, double>))
+      || (std::is_integral_v<T> && !std::is_same_v<T, bool> && !std::is_same_v<T, char>
+          && !std::is_same_v<T, signed char> && !std::is_same_v<T, unsigned char>
+          && !std::is_same_v<T, wchar_t> && !std::is_same_v<T, char8_t>
+          && !std::is_same_v<T, char16_t> && !std::is_same_v<T, char32_t>);
+
     static T parse(const std::string& str) {
+      if constexpr (useFromChars) {
+        // fast path for plain numbers, anything else (e.g. a leading '+',
+        // inf or out of range values) is left to the stream based parsing
+        // below to keep its semantics
+        const std::size_t first = str.find_first_not_of(" \t\n\r");
+        const std::size_t last = str.find_last_not_of(" \t\n\r");
+        if (first != std::string::npos) {
+          const char* begin = str.data() + first;
+          const char* end = str.data() + last + 1;
+          const char* digits = (*begin == '-') ? begin + 1 : begin;
+          if (digits != end && (std::isdigit(static_cast<unsigned char>(*digits)) || *digits == '.')) {
+            T val;
+            auto [ptr, ec] = std::from_chars(begin, end, val);
+            if (ec == std::errc() && ptr == end)
+              return val;
+          }
+        }
+      }
+
       T val;
       std::istringstream s(str);
       // make sure we are in locale "C"
@@ -5,6 +5,7 @@
 
 #include "parametertreeparser.hh"
 
+#include <cctype>
 #include <cstdlib>
 #include <iostream>
 #include <ostream>
@@ -47,6 +48,17 @@ Dune::ParameterTree Dune::ParameterTreeParser::readINITree(const std::string& fi
   return pt;
 }
 
+bool Dune::ParameterTreeParser::readFile(const std::string& file, std::string& content)
+{
+  std::ifstream in(file, std::ios::binary);
+  if (!in)
+    return false;
+  std::ostringstream s;
+  s << in.rdbuf();
+  content = s.str();
+  return true;
+}
+
 Dune::ParameterTree Dune::ParameterTreeParser::readINITree(std::istream& in)
 {
   Dune::ParameterTree pt;
@@ -152,6 +164,297 @@ void Dune::ParameterTreeParser::readINITree(std::istream& in,
 
 }
 
+namespace {
+
+  // sizes are stored in unsigned LEB128 encoding, see ParameterTree::writeBinary
+  std::size_t readSize(std::istream& in)
+  {
+    std::size_t size = 0;
+    for (unsigned int shift = 0; ; shift += 7)
+    {
+      const int byte = in.get();
+      if (byte == std::istream::traits_type::eof())
+        DUNE_THROW(Dune::ParameterTreeParserError, "Unexpected end of binary ParameterTree data");
+      if (shift >= 8*sizeof(std::size_t))
+        DUNE_THROW(Dune::ParameterTreeParserError, "Invalid size in binary ParameterTree data");
+      size |= std::size_t(byte & 0x7f) << shift;
+      if ((byte & 0x80) == 0)
+        return size;
+    }
+  }
+
+  std::string readString(std::istream& in)
+  {
+    std::size_t size = readSize(in);
+    std::string s;
+    // read in chunks, so that corrupted sizes do not lead to huge allocations
+    while (s.size() < size)
+    {
+      const std::size_t offset = s.size();
+      s.resize(offset + std::min<std::size_t>(size - offset, 1 << 16));
+      in.read(s.data() + offset, s.size() - offset);
+      if (std::size_t(in.gcount()) != s.size() - offset)
+        DUNE_THROW(Dune::ParameterTreeParserError, "Unexpected end of binary ParameterTree data");
+    }
+    return s;
+  }
+
+  void readBinaryTree(std::istream& in, Dune::ParameterTree& pt, bool overwrite)
+  {
+    for (std::size_t n = readSize(in); n > 0; --n)
+    {
+      std::string key = readString(in);
+      std::string value = readString(in);
+      if (overwrite || ! pt.hasKey(key))
+        pt[key] = std::move(value);
+    }
+    for (std::size_t n = readSize(in); n > 0; --n)
+    {
+      std::string key = readString(in);
+      readBinaryTree(in, pt.sub(key), overwrite);
+    }
+  }
+
+  // recursive descent parser for the subset of JSON accepted by readJSON
+  class JSONReader
+  {
+  public:
+    JSONReader(std::istream& in, const std::string& srcname, bool overwrite)
+      : in_(in), srcname_(srcname), overwrite_(overwrite)
+    {}
+
+    void read(Dune::ParameterTree& pt)
+    {
+      readObject(pt);
+      if (next() != std::istream::traits_type::eof())
+        error("unexpected data after the top level object");
+    }
+
+  private:
+    // skip whitespace and return the next character without extracting it
+    int next()
+    {
+      int c = in_.peek();
+      while (c == ' ' || c == '\t' || c == '\n' || c == '\r')
+      {
+        if (c == '\n')
+          ++line_;
+        in_.get();
+        c = in_.peek();
+      }
+      return c;
+    }
+
+    void expect(char expected)
+    {
+      if (next() != expected)
+        error(std::string("expected '") + expected + "'");
+      in_.get();
+    }
+
+    [[noreturn]] void error(const std::string& message)
+    {
+      DUNE_THROW(Dune::ParameterTreeParserError, "Invalid JSON in " << srcname_
+                 << " (line " << line_ << "): " << message);
+    }
+
+    void readObject(Dune::ParameterTree& pt)
+    {
+      expect('{');
+      if (next() == '}')
+      {
+        in_.get();
+        return;
+      }
+      while (true)
+      {
+        if (next() != '"')
+          error("expected a string as key");
+        std::string key = readString();
+        expect(':');
+        if (next() == '{')
+          readObject(pt.sub(key));
+        else
+        {
+          std::string value = readValue();
+          if (overwrite_ || ! pt.hasKey(key))
+            pt[key] = std::move(value);
+        }
+        if (next() == ',')
+          in_.get();
+        else
+        {
+          expect('}');
+          return;
+        }
+      }
+    }
+
+    // read a value that is not an object into its string representation
+    std::string readValue()
+    {
+      const int c = next();
+      if (c == '"')
+        return readString();
+      if (c == '[')
+      {
+        in_.get();
+        std::string value;
+        if (next() == ']')
+        {
+          in_.get();
+          return value;
+        }
+        while (true)
+        {
+          if (next() == '{' || next() == '[')
+            error("nested objects and arrays are not supported in arrays");
+          value += (value.empty() ? "" : " ") + readValue();
+          if (next() == ',')
+            in_.get();
+          else
+          {
+            expect(']');
+            return value;
+          }
+        }
+      }
+
+      // numbers and literals
+      std::string value;
+      for (int d = in_.peek(); std::isalnum(d) || d == '-' || d == '+' || d == '.'; d = in_.peek())
+        value += static_cast<char>(in_.get());
+      if (value.empty())
+        error("expected a value");
+      if (value == "null")
+        error("null values are not supported");
+      return value;
+    }
+
+    std::string readString()
+    {
+      expect('"');
+      std::string s;
+      while (true)
+      {
+        int c = in_.get();
+        if (c == std::istream::traits_type::eof())
+          error("unterminated string");
+        if (c == '"')
+          return s;
+        if (c == '\n')
+          ++line_;
+        if (c != '\\')
+        {
+          s += static_cast<char>(c);
+          continue;
+        }
+        switch (c = in_.get()) {
+        case '"' : case '\\' : case '/' : s += static_cast<char>(c); break;
+        case 'b' : s += '\b'; break;
+        case 'f' : s += '\f'; break;
+        case 'n' : s += '\n'; break;
+        case 'r' : s += '\r'; break;
+        case 't' : s += '\t'; break;
+        case 'u' : appendUTF8(s, readCodePoint()); break;
+        default : error("invalid escape sequence in string");
+        }
+      }
+    }
+
+    unsigned int readHex4()
+    {
+      unsigned int value = 0;
+      for (int i = 0; i < 4; ++i)
+      {
+        const int c = in_.get();
+        if (!std::isxdigit(c))
+          error("invalid unicode escape sequence");
+        value = 16*value + (std::isdigit(c) ? c - '0' : std::tolower(c) - 'a' + 10);
+      }
+      return value;
+    }
+
+    // code point of a \u escape sequence, combining surrogate pairs
+    unsigned int readCodePoint()
+    {
+      unsigned int cp = readHex4();
+      if (cp >= 0xd800 && cp < 0xdc00)
+      {
+        if (in_.get() != '\\' || in_.get() != 'u')
+          error("invalid surrogate pair");
+        const unsigned int low = readHex4();
+        if (low < 0xdc00 || low >= 0xe000)
+          error("invalid surrogate pair");
+        cp = 0x10000 + ((cp - 0xd800) << 10) + (low - 0xdc00);
+      }
+      return cp;
+    }
+
+    static void appendUTF8(std::string& s, unsigned int cp)
+    {
+      if (cp < 0x80)
+        s += static_cast<char>(cp);
+      else if (cp < 0x800)
+      {
+        s += static_cast<char>(0xc0 | (cp >> 6));
+        s += static_cast<char>(0x80 | (cp & 0x3f));
+      }
+      else if (cp < 0x10000)
+      {
+        s += static_cast<char>(0xe0 | (cp >> 12));
+        s += static_cast<char>(0x80 | ((cp >> 6) & 0x3f));
+        s += static_cast<char>(0x80 | (cp & 0x3f));
+      }
+      else
+      {
+        s += static_cast<char>(0xf0 | (cp >> 18));
+        s += static_cast<char>(0x80 | ((cp >> 12) & 0x3f));
+        s += static_cast<char>(0x80 | ((cp >> 6) & 0x3f));
+        s += static_cast<char>(0x80 | (cp & 0x3f));
+      }
+    }
+
+    std::istream& in_;
+    const std::string& srcname_;
+    bool overwrite_;
+    int line_ = 1;
+  };
+
+} // end anonymous namespace
+
+void Dune::ParameterTreeParser::readBinary(std::istream& in, ParameterTree& pt, bool overwrite)
+{
+  char header[4];
+  in.read(header, 4);
+  if (in.gcount() != 4 || std::string(header, 3) != "DPT")
+    DUNE_THROW(ParameterTreeParserError, "Stream does not contain binary ParameterTree data");
+  if (header[3] != 1)
+    DUNE_THROW(ParameterTreeParserError, "Unsupported version " << int(header[3])
+               << " of binary ParameterTree data");
+  readBinaryTree(in, pt, overwrite);
+}
+
+Dune::ParameterTree Dune::ParameterTreeParser::readBinary(std::istream& in)
+{
+  Dune::ParameterTree pt;
+  readBinary(in, pt, true);
+  return pt;
+}
+
+void Dune::ParameterTreeParser::readJSON(std::istream& in, ParameterTree& pt,
+                                         const std::string& srcname, bool overwrite)
+{
+  JSONReader(in, srcname, overwrite).read(pt);
+}
+
+Dune::ParameterTree Dune::ParameterTreeParser::readJSON(std::istream& in)
+{
+  Dune::ParameterTree pt;
+  readJSON(in, pt, "stream", true);
+  return pt;
+}
+
 void Dune::ParameterTreeParser::readOptions(int argc, char* argv [],
                                             ParameterTree& pt)
 {
@@ -10,11 +10,13 @@
  */
 
 #include <istream>
+#include <sstream>
 #include <string>
 #include <vector>
 
 #include <dune/common/parametertree.hh>
 #include <dune/common/exceptions.hh>
+#include <dune/common/parallel/communication.hh>
 
 namespace Dune {
 
@@ -142,6 +144,93 @@ namespace Dune {
      */
     static Dune::ParameterTree readINITree(const std::string& file);
 
+    /** \brief parse file collectively
+     *
+     * The file is only read on rank 0 of the communicator and its contents
+     * are broadcast to all other ranks, which then parse it. This avoids that
+     * all processes of a large parallel run access the same file at startup.
+     * Must be called on all ranks of `comm`.
+     *
+     * \param file      filename, only used on rank 0
+     * \param[out] pt   The parameter tree to store the config structure.
+     * \param comm      The communicator to distribute the file with
+     * \param overwrite Whether to overwrite already existing values.
+     * \throw IOError on all ranks if the file cannot be opened on rank 0
+     */
+    template<class C>
+    static void readINITree(const std::string& file, ParameterTree& pt,
+                            const Communication<C>& comm, bool overwrite = true)
+    {
+      // size of the file contents, -1 if it could not be read
+      long size = -1;
+      std::string content;
+      if (comm.rank() == 0 && readFile(file, content))
+        size = content.size();
+      comm.broadcast(&size, 1, 0);
+      if (size < 0)
+        DUNE_THROW(Dune::IOError, "Could not open configuration file " << file);
+
+      content.resize(size);
+      if (size > 0)
+        comm.broadcast(content.data(), size, 0);
+
+      std::istringstream in(content);
+      readINITree(in, pt, "file '" + file + "'", overwrite);
+    }
+
+    /** \brief parse file collectively and return tree
+     *
+     * \param file filename, only used on rank 0
+     * \param comm The communicator to distribute the file with
+     * \see readINITree(const std::string&, ParameterTree&, const Communication<C>&, bool)
+     */
+    template<class C>
+    static Dune::ParameterTree readINITree(const std::string& file, const Communication<C>& comm)
+    {
+      Dune::ParameterTree pt;
+      readINITree(file, pt, comm, true);
+      return pt;
+    }
+
+    //@}
+
+    /** @name Parsing methods for serialized trees
+     *
+     *  Read trees written by ParameterTree::writeBinary() and
+     *  ParameterTree::writeJSON(). The JSON reader accepts any object whose
+     *  members are objects (substructures), strings, numbers, booleans or
+     *  arrays of these. Numbers and booleans are stored with their textual
+     *  representation and arrays as their space separated elements, so they
+     *  can be read as, e.g., `std::vector<double>`.
+     */
+    //@{
+
+    /** \brief read binary representation of a tree
+     *
+     * \param in        The stream to read from, should be opened in binary mode
+     * \param[out] pt   The parameter tree to store the config structure.
+     * \param overwrite Whether to overwrite already existing values.
+     * \throw ParameterTreeParserError if the data is not a valid tree
+     */
+    static void readBinary(std::istream& in, ParameterTree& pt, bool overwrite = true);
+
+    /** \brief read binary representation of a tree and return it */
+    static Dune::ParameterTree readBinary(std::istream& in);
+
+    /** \brief read JSON representation of a tree
+     *
+     * \param in        The stream to read from
+     * \param[out] pt   The parameter tree to store the config structure.
+     * \param srcname   Name of the source for error messages
+     * \param overwrite Whether to overwrite already existing values.
+     * \throw ParameterTreeParserError if the input is not valid
+     */
+    static void readJSON(std::istream& in, ParameterTree& pt,
+                         const std::string& srcname = "stream", bool overwrite = true);
+
+    /** \brief read JSON representation of a tree and return it */
+    static Dune::ParameterTree readJSON(std::istream& in);
+
     //@}
 
     /** \brief parse command line options and build hierarchical ParameterTree structure
@@ -183,6 +272,7 @@ namespace Dune {
       std::vector<std::string> help = std::vector<std::string>());
 
   private:
+    static bool readFile(const std::string& file, std::string& content);
     static std::string generateHelpString(std::string progname, std::vector<std::string> keywords, unsigned int required, std::vector<std::string> help);
   };
 
@@ -0,0 +1,126 @@
+// -*- tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 2 -*-
+// vi: set et ts=4 sw=2 sts=2:
+// SPDX-FileCopyrightInfo: Copyright © DUNE Project contributors, see file LICENSE.md in module root
+// SPDX-License-Identifier: LicenseRef-GPL-2.0-only-with-DUNE-exception
+
+#include <dune/common/perfcounters.hh>
+
+#if defined(__linux__) && __has_include(<linux/perf_event.h>)
+#define DUNE_HAVE_PERF_EVENT 1
+#include <cstring>
+#include <linux/perf_event.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+using namespace Dune;
+
+#if DUNE_HAVE_PERF_EVENT
+
+namespace {
+
+  constexpr std::uint64_t configs[PerfCounters::size] = {
+    PERF_COUNT_HW_CPU_CYCLES,
+    PERF_COUNT_HW_INSTRUCTIONS,
+    PERF_COUNT_HW_CACHE_MISSES,
+    PERF_COUNT_HW_BRANCH_MISSES
+  };
+
+  int openCounter (std::uint64_t config, int thread, int group)
+  {
+    perf_event_attr attr;
+    std::memset(&attr, 0, sizeof(attr));
+    attr.size = sizeof(attr);
+    attr.type = PERF_TYPE_HARDWARE;
+    attr.config = config;
+    attr.read_format = PERF_FORMAT_GROUP | PERF_FORMAT_TOTAL_TIME_ENABLED | PERF_FORMAT_TOTAL_TIME_RUNNING;
+    // only count in user space, which is permitted for the own process up to perf_event_paranoid = 2
+    attr.exclude_kernel = 1;
+    attr.exclude_hv = 1;
+    return syscall(SYS_perf_event_open, &attr, thread, -1, group, PERF_FLAG_FD_CLOEXEC);
+  }
+
+} // end anonymous namespace
+
+PerfCounters::PerfCounters(int thread)
+{
+  fds_.fill(-1);
+  index_.fill(-1);
+  // all counters form a group, which is scheduled on the PMU as a whole and read at once
+  for (std::size_t e = 0; e < size; ++e)
+  {
+    const int fd = openCounter(configs[e], thread, leader_);
+    if (fd < 0)
+      continue;
+    if (leader_ < 0)
+      leader_ = fd;
+    fds_[e] = fd;
+    index_[e] = opened_++;
+  }
+}
+
+PerfCounters::~PerfCounters()
+{
+  // close the leader last
+  for (std::size_t e = size; e-- > 0;)
+    if (fds_[e] >= 0)
+      close(fds_[e]);
+}
+
+PerfCounters::Values PerfCounters::read() const
+{
+  Values values;
+  values.fill(0);
+  if (leader_ < 0)
+    return values;
+
+  // layout of PERF_FORMAT_GROUP: number of counters, enabled and running time, values
+  std::uint64_t buffer[3 + size];
+  if (::read(leader_, buffer, sizeof(buffer)) < ssize_t((3 + opened_) * sizeof(std::uint64_t)))
+    return values;
+  const std::uint64_t enabled = buffer[1];
+  const std::uint64_t running = buffer[2];
+  for (std::size_t e = 0; e < size; ++e)
+  {
+    if (index_[e] < 0)
+      continue;
+    const std::uint64_t value = buffer[3 + index_[e]];
+    values[e] = (running > 0 && running < enabled) ? std::uint64_t(double(value) * enabled / running) : value;
+  }
+  return values;
+}
+
+int PerfCounters::threadId()
+{
+  return syscall(SYS_gettid);
+}
+
+#else // DUNE_HAVE_PERF_EVENT
+
+PerfCounters::PerfCounters(int)
+{
+  fds_.fill(-1);
+  index_.fill(-1);
+}
+
+PerfCounters::~PerfCounters() = default;
+
+PerfCounters::Values PerfCounters::read() const
+{
+  Values values;
+  values.fill(0);
+  return values;
+}
+
+int PerfCounters::threadId()
+{
+  return 0;
+}
+
+#endif // DUNE_HAVE_PERF_EVENT
+
+const char* PerfCounters::name(Event event)
+{
+  static const char* names[size] = {"cycles", "instructions", "cache misses", "branch misses"};
+  return names[event];
+}
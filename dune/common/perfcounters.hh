@@ -0,0 +1,103 @@
+// -*- tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 2 -*-
+// vi: set et ts=4 sw=2 sts=2:
+// SPDX-FileCopyrightInfo: Copyright © DUNE Project contributors, see file LICENSE.md in module root
+// SPDX-License-Identifier: LicenseRef-GPL-2.0-only-with-DUNE-exception
+#ifndef DUNE_COMMON_PERFCOUNTERS_HH
+#define DUNE_COMMON_PERFCOUNTERS_HH
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+
+/** \file
+ * \brief Hardware performance counters of a thread
+ */
+
+namespace Dune {
+
+  /** @addtogroup Common
+     @{
+   */
+
+  /** \brief Hardware performance counters of a single thread
+
+     Counts cycles, instructions, cache misses and branch misses of a
+     thread in user space using the Linux `perf_event_open` interface.
+     Counters that cannot be opened, e.g., on other systems, in virtual
+     machines without a virtual PMU or if `/proc/sys/kernel/perf_event_paranoid`
+     forbids it, are not available and always read as zero.
+
+     \code
+     Dune::PerfCounters counters;
+     auto start = counters.read();
+     kernel();
+     auto stop = counters.read();
+     if (counters.available(Dune::PerfCounters::cacheMisses))
+       std::cout << stop[Dune::PerfCounters::cacheMisses] - start[Dune::PerfCounters::cacheMisses] << std::endl;
+     \endcode
+
+     Reading the counters is a system call which costs in the order of a
+     microsecond, so only regions that run considerably longer should be
+     measured.
+   */
+  class PerfCounters
+  {
+  public:
+    //! The counted events
+    enum Event { cycles, instructions, cacheMisses, branchMisses };
+
+    //! Number of counted events
+    static constexpr std::size_t size = 4;
+
+    //! Values of the counters, indexed by `Event`
+    using Values = std::array<std::uint64_t, size>;
+
+    /** \brief Open the counters of a thread and start counting
+     *
+     * \param thread  Linux thread id as returned by `threadId()` of the
+     *                thread to count, 0 for the calling thread
+     */
+    explicit PerfCounters (int thread = 0);
+
+    ~PerfCounters ();
+
+    PerfCounters (const PerfCounters&) = delete;
+    PerfCounters& operator= (const PerfCounters&) = delete;
+
+    //! Whether any counter is available
+    bool available () const
+    {
+      return leader_ >= 0;
+    }
+
+    //! Whether the counter of `event` is available
+    bool available (Event event) const
+    {
+      return index_[event] >= 0;
+    }
+
+    /** \brief Events since the counters were opened
+     *
+     * If the counters had to be multiplexed with other users of the PMU,
+     * the values are extrapolated to the full time.
+     */
+    Values read () const;
+
+    //! Name of an event, e.g., "cache misses"
+    static const char* name (Event event);
+
+    //! Linux thread id of the calling thread, 0 if unknown
+    static int threadId ();
+
+  private:
+    int leader_ = -1;
+    std::array<int, size> fds_;
+    std::array<int, size> index_;
+    int opened_ = 0;
+  };
+
+  /** @} */
+
+} // end namespace Dune
+
+#endif // DUNE_COMMON_PERFCOUNTERS_HH
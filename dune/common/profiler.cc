@@ -0,0 +1,366 @@
+// -*- tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 2 -*-
+// vi: set et ts=4 sw=2 sts=2:
+// SPDX-FileCopyrightInfo: Copyright © DUNE Project contributors, see file LICENSE.md in module root
+// SPDX-License-Identifier: LicenseRef-GPL-2.0-only-with-DUNE-exception
+
+#include <algorithm>
+#include <iomanip>
+#include <locale>
+#include <sstream>
+#include <thread>
+
+#include <dune/common/profiler.hh>
+#include <dune/common/impl/jsonstring.hh>
+
+using namespace Dune;
+
+namespace {
+
+  // call tree with the nodes identified by their names, used to merge the
+  // trees of several threads or ranks
+  struct RegionTree
+  {
+    struct Node
+    {
+      std::string name;
+      std::vector<std::size_t> children = {};
+      double count = 0.0;
+      double inclusive = 0.0;
+      double exclusive = 0.0;
+      std::array<double, PerfCounters::size> events = {};
+    };
+
+    RegionTree ()
+    {
+      nodes.push_back(Node{""});
+    }
+
+    std::size_t child (std::size_t parent, const char* name)
+    {
+      for (std::size_t c : nodes[parent].children)
+        if (nodes[c].name == name)
+          return c;
+      nodes.push_back(Node{name});
+      nodes[parent].children.push_back(nodes.size()-1);
+      return nodes.size()-1;
+    }
+
+    // nodes in depth-first order, children in order of appearance
+    std::vector<Profiler::RegionStatistics> flatten () const
+    {
+      std::vector<Profiler::RegionStatistics> result;
+      flatten(result, 0, "", -1);
+      return result;
+    }
+
+    void flatten (std::vector<Profiler::RegionStatistics>& result,
+                  std::size_t n, const std::string& path, int depth) const
+    {
+      if (n != 0)
+      {
+        const Node& node = nodes[n];
+        Profiler::RegionStatistics region;
+        region.path = path;
+        region.name = node.name;
+        region.depth = depth;
+        region.count = {node.count, node.count, node.count};
+        region.inclusive = {node.inclusive, node.inclusive, node.inclusive};
+        region.exclusive = {node.exclusive, node.exclusive, node.exclusive};
+        for (std::size_t e = 0; e < PerfCounters::size; ++e)
+          region.events[e] = {node.events[e], node.events[e], node.events[e]};
+        result.push_back(std::move(region));
+      }
+      for (std::size_t c : nodes[n].children)
+        flatten(result, c, (n == 0 ? "" : path + "/") + nodes[c].name, depth+1);
+    }
+
+    std::vector<Node> nodes;
+  };
+
+  void writeJSON(std::ostream& stream, const Profiler::Statistics& s)
+  {
+    stream << "{\"min\": " << s.min << ", \"max\": " << s.max << ", \"avg\": " << s.avg << "}";
+  }
+
+} // end anonymous namespace
+
+std::uint32_t Profiler::ThreadData::addNode(const char* name)
+{
+  const std::uint32_t node = nodes_.size();
+  nodes_.push_back(Node{name, current_});
+
+  // append to the children of the current node to keep the order of appearance
+  std::uint32_t* next = &nodes_[current_].firstChild;
+  while (*next != none)
+    next = &nodes_[*next].nextSibling;
+  *next = node;
+  return node;
+}
+
+Profiler::Profiler()
+  : startTicks_(Clock::now())
+  , startTime_(std::chrono::steady_clock::now())
+{}
+
+Profiler& Profiler::instance()
+{
+  static Profiler profiler;
+  return profiler;
+}
+
+Profiler::ThreadData* Profiler::registerThread()
+{
+  // closes the counters when the thread exits, its results are kept
+  struct ExitGuard
+  {
+    ThreadData* data;
+
+    ~ExitGuard ()
+    {
+      std::lock_guard<std::mutex> lock(instance().mutex_);
+      data->alive_ = false;
+      data->counters_.reset();
+    }
+  };
+
+  ThreadData* data = nullptr;
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    threads_.push_back(std::make_unique<ThreadData>(threads_.size(), PerfCounters::threadId(), maxEvents_));
+    data = threads_.back().get();
+    if (counters_)
+      data->counters_ = std::make_unique<PerfCounters>();
+  }
+  thread_local ExitGuard guard{data};
+  return data;
+}
+
+void Profiler::reset()
+{
+  std::lock_guard<std::mutex> lock(mutex_);
+  for (auto& thread : threads_)
+  {
+    for (auto& node : thread->nodes_)
+    {
+      node.count = node.ticks = 0;
+      node.events.fill(0);
+    }
+    thread->events_.clear();
+  }
+  startTicks_ = Clock::now();
+  startTime_ = std::chrono::steady_clock::now();
+}
+
+void Profiler::enableTracing(std::size_t maxEventsPerThread)
+{
+  std::lock_guard<std::mutex> lock(mutex_);
+  maxEvents_ = maxEventsPerThread;
+  for (auto& thread : threads_)
+    thread->maxEvents_ = maxEvents_;
+}
+
+void Profiler::disableTracing()
+{
+  enableTracing(0);
+}
+
+bool Profiler::enableCounters()
+{
+  ThreadData& data = threadData();
+  std::lock_guard<std::mutex> lock(mutex_);
+  counters_ = true;
+  for (auto& thread : threads_)
+  {
+    if (thread->counters_ || !thread->alive_)
+      continue;
+    thread->counters_ = std::make_unique<PerfCounters>(thread.get() == &data ? 0 : thread->tid_);
+    // active regions count from now on
+    const PerfCounters::Values start = thread->counters_->read();
+    for (auto& node : thread->nodes_)
+      node.eventsStart = start;
+  }
+  return data.counters_->available();
+}
+
+void Profiler::disableCounters()
+{
+  std::lock_guard<std::mutex> lock(mutex_);
+  counters_ = false;
+  for (auto& thread : threads_)
+    thread->counters_.reset();
+}
+
+double Profiler::secondsPerTick() const
+{
+  if constexpr (Clock::cycleCounter)
+  {
+    // calibrate the counter against the steady clock over at least 10ms
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto time = std::chrono::steady_clock::now();
+    while (time - startTime_ < std::chrono::milliseconds(10))
+    {
+      std::this_thread::yield();
+      time = std::chrono::steady_clock::now();
+    }
+    const std::uint64_t ticks = Clock::now();
+    return std::chrono::duration<double>(time - startTime_).count() / double(ticks - startTicks_);
+  }
+  else
+    return std::chrono::duration<double>(std::chrono::steady_clock::duration(1)).count();
+}
+
+std::vector<Profiler::RegionStatistics> Profiler::statistics() const
+{
+  const double tick = secondsPerTick();
+
+  RegionTree tree;
+  std::lock_guard<std::mutex> lock(mutex_);
+  for (const auto& thread : threads_)
+  {
+    const auto& nodes = thread->nodes_;
+    std::vector<std::size_t> merged(nodes.size(), 0);
+    // nodes are stored after their parents
+    for (std::size_t n = 1; n < nodes.size(); ++n)
+    {
+      merged[n] = tree.child(merged[nodes[n].parent], nodes[n].name);
+      std::uint64_t childTicks = 0;
+      for (std::uint32_t c = nodes[n].firstChild; c != none; c = nodes[c].nextSibling)
+        childTicks += nodes[c].ticks;
+      auto& node = tree.nodes[merged[n]];
+      node.count += nodes[n].count;
+      node.inclusive += tick * nodes[n].ticks;
+      node.exclusive += tick * (nodes[n].ticks > childTicks ? nodes[n].ticks - childTicks : 0);
+      for (std::size_t e = 0; e < PerfCounters::size; ++e)
+        node.events[e] += nodes[n].events[e];
+    }
+  }
+  return tree.flatten();
+}
+
+std::string Profiler::joinPaths(const std::vector<RegionStatistics>& regions)
+{
+  std::string paths;
+  for (const auto& region : regions)
+  {
+    paths += region.path;
+    paths += '\0';
+  }
+  return paths;
+}
+
+std::vector<Profiler::RegionStatistics> Profiler::mergePaths(const std::string& paths)
+{
+  RegionTree tree;
+  std::size_t begin = 0;
+  while (begin < paths.size())
+  {
+    const std::size_t end = paths.find('\0', begin);
+    std::size_t node = 0;
+    std::size_t first = begin;
+    while (true)
+    {
+      const std::size_t last = std::min(paths.find('/', first), end);
+      node = tree.child(node, paths.substr(first, last-first).c_str());
+      if (last == end)
+        break;
+      first = last + 1;
+    }
+    begin = end + 1;
+  }
+  return tree.flatten();
+}
+
+void Profiler::printTable(std::ostream& out, const std::vector<RegionStatistics>& results)
+{
+  std::size_t width = 6;
+  for (const auto& region : results)
+    width = std::max(width, 2*region.depth + region.name.size());
+
+  // the averages of the hardware events are only printed if they were counted
+  bool events = false;
+  for (const auto& region : results)
+    for (const auto& stats : region.events)
+      events = events || stats.max > 0;
+
+  std::ostringstream s;
+  s.imbue(std::locale::classic());
+  s << std::left << std::setw(width+2) << "region" << std::right
+    << std::setw(6) << "ranks" << std::setw(12) << "calls"
+    << std::setw(12) << "incl. min" << std::setw(12) << "incl. avg" << std::setw(12) << "incl. max"
+    << std::setw(12) << "excl. min" << std::setw(12) << "excl. avg" << std::setw(12) << "excl. max";
+  if (events)
+    for (std::size_t e = 0; e < PerfCounters::size; ++e)
+      s << std::setw(15) << PerfCounters::name(PerfCounters::Event(e));
+  s << "\n";
+  s << std::setprecision(4);
+  for (const auto& region : results)
+  {
+    s << std::left << std::setw(width+2) << (std::string(2*region.depth, ' ') + region.name) << std::right
+      << std::setw(6) << region.ranks << std::setprecision(12) << std::setw(12) << region.count.avg << std::setprecision(4)
+      << std::setw(12) << region.inclusive.min << std::setw(12) << region.inclusive.avg << std::setw(12) << region.inclusive.max
+      << std::setw(12) << region.exclusive.min << std::setw(12) << region.exclusive.avg << std::setw(12) << region.exclusive.max;
+    if (events)
+      for (const auto& stats : region.events)
+        s << std::setw(15) << stats.avg;
+    s << "\n";
+  }
+  out << s.str();
+}
+
+void Profiler::writeJSON(std::ostream& out, const std::vector<RegionStatistics>& results)
+{
+  std::ostringstream s;
+  s.imbue(std::locale::classic());
+  s << std::setprecision(10) << "[";
+  for (std::size_t i = 0; i < results.size(); ++i)
+  {
+    const auto& region = results[i];
+    s << (i == 0 ? "\n" : ",\n") << "  {\"path\": ";
+    Impl::writeJSONString(s, region.path);
+    s << ", \"name\": ";
+    Impl::writeJSONString(s, region.name);
+    s << ", \"depth\": " << region.depth << ", \"ranks\": " << region.ranks << ",\n   \"count\": ";
+    ::writeJSON(s, region.count);
+    s << ", \"inclusive\": ";
+    ::writeJSON(s, region.inclusive);
+    s << ", \"exclusive\": ";
+    ::writeJSON(s, region.exclusive);
+    s << ",\n   \"events\": {";
+    for (std::size_t e = 0; e < PerfCounters::size; ++e)
+    {
+      s << (e == 0 ? "" : ", ");
+      Impl::writeJSONString(s, PerfCounters::name(PerfCounters::Event(e)));
+      s << ": ";
+      ::writeJSON(s, region.events[e]);
+    }
+    s << "}}";
+  }
+  s << "\n]\n";
+  out << s.str();
+}
+
+void Profiler::writeChromeTrace(std::ostream& out, int pid) const
+{
+  // timestamps and durations in microseconds
+  const double tick = 1e6 * secondsPerTick();
+
+  std::ostringstream s;
+  s.imbue(std::locale::classic());
+  s << std::setprecision(12) << "{\"traceEvents\": [";
+  bool first = true;
+  std::lock_guard<std::mutex> lock(mutex_);
+  for (const auto& thread : threads_)
+  {
+    for (const auto& event : thread->events_)
+    {
+      s << (first ? "\n" : ",\n") << "{\"name\": ";
+      Impl::writeJSONString(s, thread->nodes_[event.node].name);
+      s << ", \"cat\": \"dune\", \"ph\": \"X\", \"pid\": " << pid << ", \"tid\": " << thread->id_
+        << ", \"ts\": " << tick * double(std::int64_t(event.start - startTicks_))
+        << ", \"dur\": " << tick * double(event.stop - event.start) << "}";
+      first = false;
+    }
+  }
+  s << "\n],\n\"displayTimeUnit\": \"ms\"}\n";
+  out << s.str();
+}
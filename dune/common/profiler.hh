@@ -0,0 +1,436 @@
+// -*- tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 2 -*-
+// vi: set et ts=4 sw=2 sts=2:
+// SPDX-FileCopyrightInfo: Copyright © DUNE Project contributors, see file LICENSE.md in module root
+// SPDX-License-Identifier: LicenseRef-GPL-2.0-only-with-DUNE-exception
+#ifndef DUNE_COMMON_PROFILER_HH
+#define DUNE_COMMON_PROFILER_HH
+
+#include <array>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <memory>
+#include <mutex>
+#include <ostream>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include <dune/common/perfcounters.hh>
+#include <dune/common/parallel/communication.hh>
+
+/** \file
+ * \brief Hierarchical profiling of scoped code regions
+ */
+
+namespace Dune {
+
+  /** @addtogroup Common
+     @{
+   */
+
+  namespace Impl {
+
+    /** \brief Tick source of the profiler
+     *
+     * Uses the time stamp counter on x86 and `std::chrono::steady_clock`
+     * elsewhere. Ticks are converted into seconds by `Profiler`.
+     */
+    struct ProfilerClock
+    {
+#if (defined(__x86_64__) || defined(__i386__)) && (defined(__GNUC__) || defined(__clang__))
+      static constexpr bool cycleCounter = true;
+
+      static std::uint64_t now () noexcept
+      {
+        return __builtin_ia32_rdtsc();
+      }
+#else
+      static constexpr bool cycleCounter = false;
+
+      static std::uint64_t now () noexcept
+      {
+        return std::chrono::steady_clock::now().time_since_epoch().count();
+      }
+#endif
+    };
+
+  } // end namespace Impl
+
+
+  /** \brief Hierarchical profiler of scoped code regions
+
+     Every thread maintains its own call tree of regions. A region is entered
+     by creating a `ProfileRegion` (or via the macros `DUNE_PROFILE_REGION`
+     and `DUNE_PROFILE_FUNCTION`) and left when the guard is destroyed. For
+     every node of the tree, i.e., every path of nested regions, the number
+     of calls and the inclusive time are recorded; the exclusive time is the
+     inclusive time without the time spent in nested regions.
+
+     \code
+     void assemble ()
+     {
+       DUNE_PROFILE_FUNCTION();
+       for (...)
+       {
+         DUNE_PROFILE_REGION("local assembly");
+         ...
+       }
+     }
+
+     // after the computation, collective over all ranks
+     Dune::Profiler::instance().report(std::cout, comm);
+     \endcode
+
+     The results can be printed as a table, written as JSON or, if tracing
+     is enabled, as a timeline in the Chrome trace event format, which can be
+     viewed with `chrome://tracing` or Perfetto.
+
+     If hardware counters are enabled with `enableCounters()`, the cycles,
+     instructions, cache misses and branch misses of every region are
+     counted as well, see `PerfCounters`. This allows to tell whether a
+     region is limited by memory or by computation, but adds the cost of
+     two system calls to every region.
+
+     \note Regions are identified by the address of their name, which must
+           have static storage duration, e.g., a string literal. Names must not
+           contain '/' which separates the names in the path of a region.
+     \note The results of other threads must only be evaluated while these
+           threads do not enter or leave regions, e.g., after they are joined.
+   */
+  class Profiler
+  {
+    using Clock = Impl::ProfilerClock;
+    static constexpr std::uint32_t none = std::numeric_limits<std::uint32_t>::max();
+
+  public:
+
+    //! Minimum, maximum and average of a quantity over all ranks that entered a region
+    struct Statistics
+    {
+      double min = 0.0;
+      double max = 0.0;
+      double avg = 0.0;
+    };
+
+    //! Results for a node of the call tree
+    struct RegionStatistics
+    {
+      //! Names of the enclosing regions and the region, separated by '/'
+      std::string path;
+      std::string name;
+      //! Nesting depth, 0 for top level regions
+      int depth = 0;
+      //! Number of ranks that entered the region
+      int ranks = 1;
+      //! Number of calls summed over the threads of a rank
+      Statistics count;
+      //! Inclusive time in seconds summed over the threads of a rank
+      Statistics inclusive;
+      //! Exclusive time in seconds summed over the threads of a rank
+      Statistics exclusive;
+      //! Inclusive hardware events summed over the threads of a rank, indexed by `PerfCounters::Event`
+      std::array<Statistics, PerfCounters::size> events = {};
+    };
+
+    //! The call tree and trace events of a single thread
+    class ThreadData
+    {
+      friend class Profiler;
+
+      struct Node
+      {
+        const char* name;
+        std::uint32_t parent;
+        std::uint32_t firstChild = none;
+        std::uint32_t nextSibling = none;
+        std::uint64_t count = 0;
+        std::uint64_t ticks = 0;
+        std::uint64_t start = 0;
+        PerfCounters::Values events = {};
+        PerfCounters::Values eventsStart = {};
+      };
+
+      struct Event
+      {
+        std::uint32_t node;
+        std::uint64_t start;
+        std::uint64_t stop;
+      };
+
+    public:
+      ThreadData (int id, int tid, std::size_t maxEvents)
+        : id_(id), tid_(tid), maxEvents_(maxEvents)
+      {
+        nodes_.push_back(Node{"", none});
+      }
+
+      //! Enter the region `name` nested in the current region
+      void enter (const char* name)
+      {
+        std::uint32_t child = nodes_[current_].firstChild;
+        while (child != none && nodes_[child].name != name)
+          child = nodes_[child].nextSibling;
+        if (child == none)
+          child = addNode(name);
+        current_ = child;
+        if (counters_)
+          nodes_[child].eventsStart = counters_->read();
+        nodes_[child].start = Clock::now();
+      }
+
+      //! Leave the current region
+      void leave ()
+      {
+        const std::uint64_t stop = Clock::now();
+        Node& node = nodes_[current_];
+        node.ticks += stop - node.start;
+        ++node.count;
+        if (counters_)
+        {
+          const PerfCounters::Values events = counters_->read();
+          // scaled counts of multiplexed counters are estimates and may decrease
+          for (std::size_t e = 0; e < PerfCounters::size; ++e)
+            if (events[e] > node.eventsStart[e])
+              node.events[e] += events[e] - node.eventsStart[e];
+        }
+        if (events_.size() < maxEvents_)
+          events_.push_back(Event{current_, node.start, stop});
+        current_ = node.parent;
+      }
+
+    private:
+      std::uint32_t addNode (const char* name);
+
+      std::vector<Node> nodes_;
+      std::uint32_t current_ = 0;
+      int id_;
+      int tid_;
+      bool alive_ = true;
+      std::size_t maxEvents_;
+      std::vector<Event> events_;
+      std::unique_ptr<PerfCounters> counters_;
+    };
+
+    //! The profiler of the program
+    static Profiler& instance ();
+
+    //! The call tree of the calling thread
+    static ThreadData& threadData ()
+    {
+      thread_local ThreadData* data = nullptr;
+      if (!data)
+        data = instance().registerThread();
+      return *data;
+    }
+
+    /** \brief Discard all results and trace events
+     *
+     * The call trees are kept, so this may be called inside of regions.
+     * Other threads must not enter or leave regions meanwhile.
+     */
+    void reset ();
+
+    /** \brief Record every call of a region for the Chrome trace
+     *
+     * At most `maxEventsPerThread` calls are recorded per thread, later
+     * calls are counted but not traced.
+     */
+    void enableTracing (std::size_t maxEventsPerThread = 1000000);
+
+    //! Stop recording calls, already recorded calls are kept
+    void disableTracing ();
+
+    /** \brief Count hardware events of all threads in every region
+     *
+     * Threads that are registered later count events as well, threads that
+     * have exited are skipped. Regions that are active during this call only
+     * count the events after it. Other threads must not enter or leave
+     * regions meanwhile.
+     *
+     * \returns Whether any counter is available on the calling thread
+     */
+    bool enableCounters ();
+
+    //! Stop counting hardware events, already counted events are kept
+    void disableCounters ();
+
+    //! Results of this rank with the threads merged, in depth-first order
+    std::vector<RegionStatistics> statistics () const;
+
+    /** \brief Results over all ranks of `comm`
+     *
+     * This is a collective operation. A region is listed if it was entered
+     * on any rank, the statistics only take the ranks into account that
+     * entered the region. All ranks obtain the same results.
+     */
+    template<class C>
+    std::vector<RegionStatistics> statistics (const Communication<C>& comm) const
+    {
+      std::vector<RegionStatistics> local = statistics();
+      if (comm.size() == 1)
+        return local;
+
+      // the union of the regions of all ranks
+      const std::string paths = joinPaths(local);
+      const int size = paths.size();
+      std::vector<int> sizes(comm.size()), offsets(comm.size(), 0);
+      comm.allgather(&size, 1, sizes.data());
+      for (int i = 1; i < comm.size(); ++i)
+        offsets[i] = offsets[i-1] + sizes[i-1];
+      std::string allPaths(offsets.back() + sizes.back(), '\0');
+      comm.allgatherv(paths.data(), size, allPaths.data(), sizes.data(), offsets.data());
+      std::vector<RegionStatistics> result = mergePaths(allPaths);
+
+      // reduce count, inclusive and exclusive time over the ranks
+      const std::size_t n = result.size();
+      std::unordered_map<std::string, const RegionStatistics*> localRegions;
+      for (const auto& region : local)
+        localRegions.emplace(region.path, &region);
+      // count, inclusive time, exclusive time and the events of a region
+      constexpr std::size_t m = 3 + PerfCounters::size;
+      constexpr double inf = std::numeric_limits<double>::infinity();
+      std::vector<double> min(m*n, inf), max(m*n, -inf), sum((m+1)*n, 0.0);
+      for (std::size_t i = 0; i < n; ++i)
+      {
+        auto it = localRegions.find(result[i].path);
+        if (it == localRegions.end())
+          continue;
+        const RegionStatistics& region = *it->second;
+        for (std::size_t j = 0; j < m; ++j)
+          min[m*i+j] = max[m*i+j] = sum[(m+1)*i+j] = quantity(region, j).avg;
+        sum[(m+1)*i+m] = 1.0;
+      }
+      comm.min(min.data(), min.size());
+      comm.max(max.data(), max.size());
+      comm.sum(sum.data(), sum.size());
+
+      for (std::size_t i = 0; i < n; ++i)
+      {
+        const double ranks = sum[(m+1)*i+m];
+        result[i].ranks = ranks;
+        for (std::size_t j = 0; j < m; ++j)
+          quantity(result[i], j) = Statistics{min[m*i+j], max[m*i+j], sum[(m+1)*i+j] / ranks};
+      }
+      return result;
+    }
+
+    //! Print the results of this rank as a table
+    void report (std::ostream& out) const
+    {
+      printTable(out, statistics());
+    }
+
+    //! Print the results over all ranks as a table on rank 0, collective
+    template<class C>
+    void report (std::ostream& out, const Communication<C>& comm) const
+    {
+      std::vector<RegionStatistics> results = statistics(comm);
+      if (comm.rank() == 0)
+        printTable(out, results);
+    }
+
+    //! Print results as a table with one row per region, indented by the depth
+    static void printTable (std::ostream& out, const std::vector<RegionStatistics>& results);
+
+    //! Write results as a JSON array of regions in depth-first order
+    static void writeJSON (std::ostream& out, const std::vector<RegionStatistics>& results);
+
+    /** \brief Write the traced calls of all threads in the Chrome trace event format
+     *
+     * \param pid  The process id of the events, e.g., the rank. The traces of
+     *             several ranks can be merged by concatenating their `traceEvents`.
+     */
+    void writeChromeTrace (std::ostream& out, int pid = 0) const;
+
+    //! Seconds per tick of the profiler clock
+    double secondsPerTick () const;
+
+  private:
+    Profiler ();
+
+    ThreadData* registerThread ();
+
+    // the j-th reduced quantity: count, inclusive time, exclusive time, events
+    template<class Region>
+    static auto& quantity (Region& region, std::size_t j)
+    {
+      if (j == 0)
+        return region.count;
+      else if (j == 1)
+        return region.inclusive;
+      else if (j == 2)
+        return region.exclusive;
+      else
+        return region.events[j-3];
+    }
+
+    static std::string joinPaths (const std::vector<RegionStatistics>& regions);
+    static std::vector<RegionStatistics> mergePaths (const std::string& paths);
+
+    mutable std::mutex mutex_;
+    std::vector<std::unique_ptr<ThreadData>> threads_;
+    std::size_t maxEvents_ = 0;
+    bool counters_ = false;
+    std::uint64_t startTicks_;
+    std::chrono::steady_clock::time_point startTime_;
+  };
+
+
+  /** \brief Guard that profiles the enclosing scope as a region
+
+     \param name  Name of the region with static storage duration, e.g., a string literal
+
+     The guard is always active, use the macro `DUNE_PROFILE_REGION` to
+     profile a region only if profiling is enabled.
+   */
+  class ProfileRegion
+  {
+  public:
+    explicit ProfileRegion (const char* name)
+      : data_(Profiler::threadData())
+    {
+      data_.enter(name);
+    }
+
+    ~ProfileRegion ()
+    {
+      data_.leave();
+    }
+
+    ProfileRegion (const ProfileRegion&) = delete;
+    ProfileRegion& operator= (const ProfileRegion&) = delete;
+
+  private:
+    Profiler::ThreadData& data_;
+  };
+
+  /** @} */
+
+} // end namespace Dune
+
+#define DUNE_PROFILE_CONCAT_IMPL(a, b) a##b
+#define DUNE_PROFILE_CONCAT(a, b) DUNE_PROFILE_CONCAT_IMPL(a, b)
+
+#if defined(DUNE_ENABLE_PROFILING) || defined(DOXYGEN)
+
+/**
+ * \brief If `DUNE_ENABLE_PROFILING` is defined: profile the rest of the
+ * enclosing scope as region \a name; otherwise, do nothing.
+ */
+#define DUNE_PROFILE_REGION(name) \
+  ::Dune::ProfileRegion DUNE_PROFILE_CONCAT(duneProfileRegion, __LINE__){name}
+
+/**
+ * \brief If `DUNE_ENABLE_PROFILING` is defined: profile the rest of the
+ * enclosing function as region named after the function; otherwise, do nothing.
+ */
+#define DUNE_PROFILE_FUNCTION() DUNE_PROFILE_REGION(__func__)
+
+#else
+#define DUNE_PROFILE_REGION(name) do {} while (false)
+#define DUNE_PROFILE_FUNCTION() do {} while (false)
+#endif
+
+#endif // DUNE_COMMON_PROFILER_HH
@@ -5,8 +5,11 @@
 #ifndef DUNE_SLLIST_HH
 #define DUNE_SLLIST_HH
 
+#include <algorithm>
 #include <memory>
 #include <cassert>
+#include <new>
+#include <type_traits>
 #include "iteratorfacades.hh"
 #include <ostream>
 
@@ -38,11 +41,19 @@ namespace Dune
    * The list is capable of insertions at the front and at
    * the end and of removing elements at the front. Those
    * operations require constant time.
+   *
+   * The elements are not allocated one by one. Instead the list
+   * allocates blocks of about 1 KiB that hold several elements,
+   * and elements that are removed are kept for reuse. Elements
+   * inserted one after the other are therefore mostly adjacent in
+   * memory. The memory is only returned to the allocator by clear()
+   * and the destructor, which release all blocks at once.
    */
   template<typename T, class A=std::allocator<T> >
   class SLList
   {
     struct Element;
+    struct Block;
     friend class SLListIterator<T,A>;
     friend class SLListConstIterator<T,A>;
 
@@ -59,9 +70,9 @@ namespace Dune
     typedef T MemberType;
 
     /**
-     * @brief The allocator to use.
+     * @brief The allocator to use for the blocks of elements.
      */
-    using Allocator = typename std::allocator_traits<A>::template rebind_alloc<Element>;
+    using Allocator = typename std::allocator_traits<A>::template rebind_alloc<Block>;
 
     /**
      * @brief The mutable iterator of the list.
@@ -125,9 +136,26 @@ namespace Dune
      */
     inline void pop_front();
 
-    /** @brief Remove all elements from the list. */
+    /**
+     * @brief Remove all elements from the list.
+     *
+     * Releases the memory of all elements at once.
+     */
     inline void clear();
 
+    /**
+     * @brief Move all elements of another list to the end of this list.
+     *
+     * If the allocators of both lists compare equal, the elements are
+     * neither copied nor moved, this list just takes over the memory
+     * of the other list in constant time. The unused elements of the
+     * newest block of one of the lists are not handed out before the list
+     * is cleared. Otherwise the elements are copied. Afterwards the other
+     * list is empty.
+     * @param other The list whose elements are moved.
+     */
+    void splice_back(SLList<T,A>& other);
+
     /**
      * @brief Get an iterator pointing to the first
      * element in the list.
@@ -214,10 +242,52 @@ namespace Dune
       Element(const MemberType& item, Element* next_=0);
 
       Element();
+    };
 
-      ~Element();
+    /** @brief An element that is not used, linked to the next unused one. */
+    struct FreeElement
+    {
+      FreeElement* next_;
+    };
+
+    /**
+     * @brief The number of elements in one block.
+     *
+     * Chosen such that a block has about 1 KiB, but at least 4 elements.
+     */
+    constexpr static std::size_t blockSize =
+      std::max<std::size_t>(4, (1024 - sizeof(Block*)) / sizeof(Element));
+
+    /** @brief A block of memory for several elements. */
+    struct Block
+    {
+      /** @brief The block allocated before this one. */
+      Block* next_;
+      /** @brief The uninitialized memory of the elements. */
+      alignas(Element) unsigned char elements_[blockSize * sizeof(Element)];
+
+      Element* element(std::size_t i)
+      {
+        return reinterpret_cast<Element*>(elements_) + i;
+      }
     };
 
+    /**
+     * @brief Get memory for a new element.
+     *
+     * Takes an element that was removed before or the next unused one
+     * in the last block, and allocates a new block if there is neither.
+     */
+    Element* allocateElement();
+
+    /**
+     * @brief Destroy an element and keep its memory for reuse.
+     */
+    void deallocateElement(Element* element);
+
+    /** @brief Destroy all elements and release all blocks. */
+    void releaseBlocks();
+
     /**
      * @brief Delete the next element in the list.
      * @param current Element whose next element should be deleted.
@@ -261,6 +331,21 @@ namespace Dune
 
     /** brief The number of elements the list holds. */
     int size_;
+
+    /** @brief The last allocated block, linked to the ones allocated before. */
+    Block* blocks_;
+
+    /** @brief The end of the chain of blocks. */
+    Block* lastBlock_;
+
+    /** @brief The number of elements used in the last allocated block. */
+    std::size_t usedInBlock_;
+
+    /** @brief The removed elements available for reuse. */
+    FreeElement* free_;
+
+    /** @brief The last element of the list of removed elements. */
+    FreeElement* freeTail_;
   };
 
   /**
@@ -558,15 +643,10 @@ namespace Dune
     : next_(0), item_()
   {}
 
-  template<typename T, class A>
-  SLList<T,A>::Element::~Element()
-  {
-    next_=0;
-  }
-
   template<typename T, class A>
   SLList<T,A>::SLList()
-    : beforeHead_(), tail_(&beforeHead_), allocator_(), size_(0)
+    : beforeHead_(), tail_(&beforeHead_), allocator_(), size_(0),
+      blocks_(0), lastBlock_(0), usedInBlock_(blockSize), free_(0), freeTail_(0)
   {
     beforeHead_.next_=0;
     assert(&beforeHead_==tail_);
@@ -575,7 +655,8 @@ namespace Dune
 
   template<typename T, class A>
   SLList<T,A>::SLList(const SLList<T,A>& other)
-    : beforeHead_(), tail_(&beforeHead_), allocator_(), size_(0)
+    : beforeHead_(), tail_(&beforeHead_), allocator_(), size_(0),
+      blocks_(0), lastBlock_(0), usedInBlock_(blockSize), free_(0), freeTail_(0)
   {
     copyElements(other);
   }
@@ -583,7 +664,8 @@ namespace Dune
   template<typename T, class A>
   template<typename T1, class A1>
   SLList<T,A>::SLList(const SLList<T1,A1>& other)
-    : beforeHead_(), tail_(&beforeHead_), allocator_(), size_(0)
+    : beforeHead_(), tail_(&beforeHead_), allocator_(), size_(0),
+      blocks_(0), lastBlock_(0), usedInBlock_(blockSize), free_(0), freeTail_(0)
   {
     copyElements(other);
   }
@@ -639,19 +721,133 @@ namespace Dune
     return *this;
   }
 
+  template<typename T, class A>
+  typename SLList<T,A>::Element* SLList<T,A>::allocateElement()
+  {
+    if(free_) {
+      FreeElement* element = free_;
+      free_ = element->next_;
+      element->~FreeElement();
+      return reinterpret_cast<Element*>(element);
+    }
+    if(usedInBlock_ == blockSize) {
+      Block* block = allocator_.allocate(1);
+      block->next_ = blocks_;
+      if(!blocks_)
+        lastBlock_ = block;
+      blocks_ = block;
+      usedInBlock_ = 0;
+    }
+    return blocks_->element(usedInBlock_++);
+  }
+
+  template<typename T, class A>
+  inline void SLList<T,A>::deallocateElement(Element* element)
+  {
+    element->~Element();
+    free_ = ::new (static_cast<void*>(element)) FreeElement{free_};
+    if(!free_->next_)
+      freeTail_ = free_;
+  }
+
+  template<typename T, class A>
+  void SLList<T,A>::releaseBlocks()
+  {
+    if constexpr (!std::is_trivially_destructible_v<Element>)
+      for(Element* current = beforeHead_.next_; current; ) {
+        Element* next = current->next_;
+        current->~Element();
+        current = next;
+      }
+
+    while(blocks_) {
+      Block* next = blocks_->next_;
+      allocator_.deallocate(blocks_, 1);
+      blocks_ = next;
+    }
+    lastBlock_ = 0;
+    usedInBlock_ = blockSize;
+    free_ = 0;
+    freeTail_ = 0;
+    beforeHead_.next_ = 0;
+    size_ = 0;
+  }
+
   template<typename T, class A>
   inline void SLList<T,A>::push_back(const MemberType& item)
   {
     assert(size_>0 || tail_==&beforeHead_);
-    tail_->next_ = allocator_.allocate(1);
-    assert(size_>0 || tail_==&beforeHead_);
-    tail_ = tail_->next_;
-    ::new (static_cast<void*>(&(tail_->item_)))T(item);
-    tail_->next_=0;
+    Element* added = ::new (static_cast<void*>(allocateElement())) Element(item);
+    tail_->next_ = added;
+    tail_ = added;
     assert(tail_->next_==0);
     ++size_;
   }
 
+  template<typename T, class A>
+  void SLList<T,A>::splice_back(SLList<T,A>& other)
+  {
+    assert(this != &other);
+    bool equalAllocators;
+    if constexpr (std::allocator_traits<Allocator>::is_always_equal::value)
+      equalAllocators = true;
+    else
+      equalAllocators = (allocator_ == other.allocator_);
+
+    if(!equalAllocators) {
+      for(const_iterator element = other.begin(); element != other.end(); ++element)
+        push_back(*element);
+      other.clear();
+      return;
+    }
+
+    if(other.empty() && !other.blocks_)
+      return;
+
+    // Link the elements.
+    if(!other.empty()) {
+      tail_->next_ = other.beforeHead_.next_;
+      tail_ = other.tail_;
+      size_ += other.size_;
+    }
+
+    // Take over the blocks. The newest block stays at the front of the
+    // chain, as its unused elements are handed out one after the other.
+    // Of the two newest blocks, the one with more unused elements is kept
+    // in front; the unused elements of the other one are not reused.
+    if(!blocks_) {
+      blocks_ = other.blocks_;
+      lastBlock_ = other.lastBlock_;
+      usedInBlock_ = other.usedInBlock_;
+    }else if(other.blocks_) {
+      if(other.usedInBlock_ < usedInBlock_) {
+        other.lastBlock_->next_ = blocks_;
+        blocks_ = other.blocks_;
+        usedInBlock_ = other.usedInBlock_;
+      }else{
+        lastBlock_->next_ = other.blocks_;
+        lastBlock_ = other.lastBlock_;
+      }
+    }
+
+    // Take over the removed elements.
+    if(other.free_) {
+      other.freeTail_->next_ = free_;
+      if(!free_)
+        freeTail_ = other.freeTail_;
+      free_ = other.free_;
+    }
+
+    other.beforeHead_.next_ = 0;
+    other.tail_ = &other.beforeHead_;
+    other.size_ = 0;
+    other.blocks_ = 0;
+    other.lastBlock_ = 0;
+    other.usedInBlock_ = blockSize;
+    other.free_ = 0;
+    other.freeTail_ = 0;
+  }
+
   template<typename T, class A>
   inline void SLList<T,A>::insertAfter(Element* current, const T& item)
   {
@@ -666,13 +862,8 @@ namespace Dune
 
     assert(!changeTail || !tmp);
 
-    // Allocate space
-    current->next_ = allocator_.allocate(1);
-
-    // Use copy constructor to initialize memory
-    std::allocator_traits<Allocator>::construct(allocator_, current->next_, Element(item,tmp));
-
-    //::new(static_cast<void*>(&(current->next_->item_))) T(item);
+    // Allocate space and copy the item
+    current->next_ = ::new (static_cast<void*>(allocateElement())) Element(item,tmp);
 
     if(!current->next_->next_) {
       // Update tail
@@ -686,17 +877,12 @@ namespace Dune
   template<typename T, class A>
   inline void SLList<T,A>::push_front(const MemberType& item)
   {
+    Element* added = ::new (static_cast<void*>(allocateElement())) Element(item, beforeHead_.next_);
     if(tail_ == &beforeHead_) {
       // list was empty
-      beforeHead_.next_ = tail_ = allocator_.allocate(1, 0);
-      ::new(static_cast<void*>(&beforeHead_.next_->item_))T(item);
-      beforeHead_.next_->next_=0;
-    }else{
-      Element* added = allocator_.allocate(1, 0);
-      ::new(static_cast<void*>(&added->item_))T(item);
-      added->next_=beforeHead_.next_;
-      beforeHead_.next_=added;
+      tail_ = added;
     }
+    beforeHead_.next_=added;
     assert(tail_->next_==0);
     ++size_;
   }
@@ -722,8 +908,7 @@ namespace Dune
       }
 
     current->next_ = next->next_;
-    std::allocator_traits<Allocator>::destroy(allocator_, next);
-    allocator_.deallocate(next, 1);
+    deallocateElement(next);
     --size_;
     assert(!watchForTail || &beforeHead_ != tail_ || size_==0);
   }
@@ -737,9 +922,7 @@ namespace Dune
   template<typename T, class A>
   inline void SLList<T,A>::clear()
   {
-    while(beforeHead_.next_ ) {
-      this->template deleteNext<false>(&beforeHead_);
-    }
+    releaseBlocks();
 
     assert(size_==0);
     // update the tail!
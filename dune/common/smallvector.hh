@@ -0,0 +1,820 @@
+// -*- tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 2 -*-
+// vi: set et ts=4 sw=2 sts=2:
+// SPDX-FileCopyrightInfo: Copyright © DUNE Project contributors, see file LICENSE.md in module root
+// SPDX-License-Identifier: LicenseRef-GPL-2.0-only-with-DUNE-exception
+#ifndef DUNE_COMMON_SMALLVECTOR_HH
+#define DUNE_COMMON_SMALLVECTOR_HH
+
+/** \file
+ * \brief A std::vector-like container which stores a small number of elements inline
+ */
+
+#include <algorithm>
+#include <cstddef>
+#include <cstring>
+#include <functional>
+#include <initializer_list>
+#include <iostream>
+#include <iterator>
+#include <memory>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+
+#include <dune/common/boundschecking.hh>
+#include <dune/common/hash.hh>
+#include <dune/common/std/algorithm.hh>
+#include <dune/common/std/compare.hh>
+#include <dune/common/typetraits.hh>
+
+namespace Dune
+{
+  /**
+     \brief A vector which stores up to n elements inline and more on the heap
+
+     SmallVector has the interface of std::vector. As long as it holds at
+     most n elements, these are stored inside the object and no memory is
+     allocated. Larger vectors are stored on the heap, just like a
+     std::vector. This suits data that is usually small but may occasionally
+     be larger, e.g. the neighbors of an element or the degrees of freedom of
+     an element with hanging nodes, where a ReservedVector would need the
+     worst-case capacity and a std::vector allocates every time.
+
+     Elements of types for which IsTriviallyRelocatable is true are moved by
+     copying their bytes when the vector grows and when elements are inserted
+     or erased.
+
+     \note Moving or swapping a SmallVector whose elements are stored inline
+           moves the elements. In contrast to std::vector, this invalidates
+           iterators and references to the elements.
+
+     \tparam T The value type SmallVector stores.
+     \tparam n The number of elements stored without heap allocation.
+   */
+  template<class T, std::size_t n>
+  class SmallVector
+  {
+    static_assert(n > 0, "SmallVector needs an inline capacity of at least one element");
+
+    using allocator_type = std::allocator<T>;
+    using allocator_traits = std::allocator_traits<allocator_type>;
+
+    static constexpr bool relocatable = IsTriviallyRelocatable<T>::value;
+
+  public:
+
+    /** @{ Typedefs */
+
+    //! The type of object, T, stored in the vector.
+    typedef T value_type;
+    //! Pointer to T.
+    typedef T* pointer;
+    //! Const pointer to T.
+    typedef const T* const_pointer;
+    //! Reference to T
+    typedef T& reference;
+    //! Const reference to T
+    typedef const T& const_reference;
+    //! An unsigned integral type.
+    typedef std::size_t size_type;
+    //! A signed integral type.
+    typedef std::ptrdiff_t difference_type;
+    //! Iterator used to iterate through a vector.
+    typedef pointer iterator;
+    //! Const iterator used to iterate through a vector.
+    typedef const_pointer const_iterator;
+    //! Reverse iterator
+    typedef std::reverse_iterator<iterator> reverse_iterator;
+    //! Const reverse iterator
+    typedef std::reverse_iterator<const_iterator> const_reverse_iterator;
+
+    /** @} */
+
+    /** @{ Constructors */
+
+    //! Constructs an empty vector
+    SmallVector() noexcept
+      : data_(inlineData())
+      , size_(0)
+      , capacity_(n)
+    {}
+
+    //! Constructs the vector with `count` value-initialized elements.
+    explicit SmallVector(size_type count)
+      : SmallVector()
+    {
+      resize(count);
+    }
+
+    //! Constructs the vector with `count` copies of elements with value `value`.
+    SmallVector(size_type count, const value_type& value)
+      : SmallVector()
+    {
+      assign(count, value);
+    }
+
+    //! Constructs the vector from an iterator range `[first,last)`
+    template<std::input_iterator InputIt>
+    SmallVector(InputIt first, InputIt last)
+      : SmallVector()
+    {
+      assign(first, last);
+    }
+
+    //! Constructs the vector from an initializer list
+    SmallVector(std::initializer_list<value_type> l)
+      : SmallVector()
+    {
+      assign(l.begin(), l.end());
+    }
+
+    //! Copy constructor
+    SmallVector(const SmallVector& other)
+      : SmallVector()
+    {
+      assign(other.begin(), other.end());
+    }
+
+    //! Move constructor, takes over the heap memory or moves the inline elements
+    SmallVector(SmallVector&& other)
+          noexcept(relocatable || std::is_nothrow_move_constructible_v<value_type>)
+      : SmallVector()
+    {
+      takeFrom(other);
+    }
+
+    ~SmallVector()
+    {
+      std::destroy_n(data_, size_);
+      deallocate();
+    }
+
+    //! Copy assignment
+    SmallVector& operator= (const SmallVector& other)
+    {
+      if (this != &other)
+        assign(other.begin(), other.end());
+      return *this;
+    }
+
+    //! Move assignment
+    SmallVector& operator= (SmallVector&& other)
+          noexcept(relocatable || std::is_nothrow_move_constructible_v<value_type>)
+    {
+      if (this != &other)
+      {
+        clear();
+        deallocate();
+        takeFrom(other);
+      }
+      return *this;
+    }
+
+    //! Assignment from an initializer list
+    SmallVector& operator= (std::initializer_list<value_type> l)
+    {
+      assign(l.begin(), l.end());
+      return *this;
+    }
+
+    //! Replaces the contents by `count` copies of `value`
+    void assign(size_type count, const value_type& value)
+    {
+      if (contains(&value))
+      {
+        const value_type copy(value);
+        assign(count, copy);
+        return;
+      }
+      clear();
+      reserve(count);
+      std::uninitialized_fill_n(data_, count, value);
+      size_ = count;
+    }
+
+    //! Replaces the contents by the elements of the iterator range `[first,last)`
+    template<std::input_iterator InputIt>
+    void assign(InputIt first, InputIt last)
+    {
+      clear();
+      if constexpr (std::forward_iterator<InputIt>)
+      {
+        const size_type count = std::distance(first, last);
+        reserve(count);
+        std::uninitialized_copy(first, last, data_);
+        size_ = count;
+      }
+      else
+        for (; first != last; ++first)
+          emplace_back(*first);
+    }
+
+    //! Replaces the contents by the elements of an initializer list
+    void assign(std::initializer_list<value_type> l)
+    {
+      assign(l.begin(), l.end());
+    }
+
+    /** @} */
+
+    /** @{ Comparison */
+
+    //! Compares the values in the vector `this` with `that` for equality
+    bool operator== (const SmallVector& that) const
+    {
+      return std::equal(begin(), end(), that.begin(), that.end());
+    }
+
+    //! Lexicographically compares the values in the vector `this` with `that`
+    auto operator<=> (const SmallVector& that) const
+    {
+      return Std::lexicographical_compare_three_way(begin(), end(), that.begin(), that.end());
+    }
+
+    /** @} */
+
+    /** @{ Modifiers */
+
+    //! Erases all elements, the capacity is unchanged.
+    void clear() noexcept
+    {
+      std::destroy_n(data_, size_);
+      size_ = 0;
+    }
+
+    //! Resizes the vector to `count` elements, new elements are value-initialized.
+    void resize(size_type count)
+    {
+      if (count < size_)
+        std::destroy_n(data_ + count, size_ - count);
+      else
+      {
+        reserveForGrowth(count);
+        std::uninitialized_value_construct_n(data_ + size_, count - size_);
+      }
+      size_ = count;
+    }
+
+    //! Resizes the vector to `count` elements, new elements are copies of `value`.
+    void resize(size_type count, const value_type& value)
+    {
+      if (count < size_)
+        std::destroy_n(data_ + count, size_ - count);
+      else if (count > capacity_ && contains(&value))
+      {
+        const value_type copy(value);
+        resize(count, copy);
+        return;
+      }
+      else
+      {
+        reserveForGrowth(count);
+        std::uninitialized_fill_n(data_ + size_, count - size_, value);
+      }
+      size_ = count;
+    }
+
+    //! Appends an element to the end of the vector, amortized O(1) time.
+    void push_back(const value_type& t)
+    {
+      emplace_back(t);
+    }
+
+    //! Appends an element to the end of the vector by moving the value, amortized O(1) time.
+    void push_back(value_type&& t)
+    {
+      emplace_back(std::move(t));
+    }
+
+    //! Appends an element to the end of the vector by constructing it in place
+    template<class... Args>
+    reference emplace_back(Args&&... args)
+    {
+      if (size_ == capacity_)
+        return growAndEmplaceBack(std::forward<Args>(args)...);
+      pointer p = std::construct_at(data_ + size_, std::forward<Args>(args)...);
+      ++size_;
+      return *p;
+    }
+
+    //! Erases the last element of the vector, O(1) time.
+    void pop_back()
+    {
+      DUNE_ASSERT_BOUNDS(size_ > 0);
+      std::destroy_at(data_ + --size_);
+    }
+
+    //! Inserts an element constructed in place before `pos`
+    template<class... Args>
+    iterator emplace(const_iterator pos, Args&&... args)
+    {
+      const size_type i = pos - cbegin();
+      DUNE_ASSERT_BOUNDS(i <= size_);
+      if (i == size_)
+      {
+        emplace_back(std::forward<Args>(args)...);
+        return begin() + i;
+      }
+
+      if constexpr (relocatable)
+      {
+        // construct the element first, as the arguments may refer to elements of the vector
+        alignas(value_type) std::byte buffer[sizeof(value_type)];
+        pointer tmp = std::construct_at(reinterpret_cast<pointer>(buffer), std::forward<Args>(args)...);
+        if (size_ == capacity_)
+        {
+          try {
+            reallocate(growth(size_ + 1));
+          }
+          catch (...) {
+            std::destroy_at(tmp);
+            throw;
+          }
+        }
+        std::memmove(static_cast<void*>(data_ + i + 1), static_cast<const void*>(data_ + i), (size_ - i) * sizeof(value_type));
+        std::memcpy(static_cast<void*>(data_ + i), static_cast<const void*>(tmp), sizeof(value_type));
+        ++size_;
+      }
+      else
+      {
+        value_type tmp(std::forward<Args>(args)...);
+        emplace_back(std::move(back()));
+        std::move_backward(data_ + i, data_ + size_ - 2, data_ + size_ - 1);
+        data_[i] = std::move(tmp);
+      }
+      return begin() + i;
+    }
+
+    //! Inserts a copy of `value` before `pos`
+    iterator insert(const_iterator pos, const value_type& value)
+    {
+      return emplace(pos, value);
+    }
+
+    //! Inserts `value` before `pos` by moving it
+    iterator insert(const_iterator pos, value_type&& value)
+    {
+      return emplace(pos, std::move(value));
+    }
+
+    //! Inserts `count` copies of `value` before `pos`
+    iterator insert(const_iterator pos, size_type count, const value_type& value)
+    {
+      const size_type i = pos - cbegin();
+      DUNE_ASSERT_BOUNDS(i <= size_);
+      if (contains(&value))
+      {
+        const value_type copy(value);
+        return insert(pos, count, copy);
+      }
+      const size_type oldSize = size_;
+      reserveForGrowth(size_ + count);
+      std::uninitialized_fill_n(data_ + size_, count, value);
+      size_ += count;
+      std::rotate(data_ + i, data_ + oldSize, data_ + size_);
+      return begin() + i;
+    }
+
+    //! Inserts the elements of the iterator range `[first,last)` before `pos`
+    template<std::input_iterator InputIt>
+    iterator insert(const_iterator pos, InputIt first, InputIt last)
+    {
+      const size_type i = pos - cbegin();
+      DUNE_ASSERT_BOUNDS(i <= size_);
+      const size_type oldSize = size_;
+      if constexpr (std::forward_iterator<InputIt>)
+      {
+        const size_type count = std::distance(first, last);
+        reserveForGrowth(size_ + count);
+        std::uninitialized_copy(first, last, data_ + size_);
+        size_ += count;
+      }
+      else
+        for (; first != last; ++first)
+          emplace_back(*first);
+      std::rotate(data_ + i, data_ + oldSize, data_ + size_);
+      return begin() + i;
+    }
+
+    //! Inserts the elements of an initializer list before `pos`
+    iterator insert(const_iterator pos, std::initializer_list<value_type> l)
+    {
+      return insert(pos, l.begin(), l.end());
+    }
+
+    //! Erases the element at `pos`
+    iterator erase(const_iterator pos)
+    {
+      return erase(pos, pos + 1);
+    }
+
+    //! Erases the elements in the range `[first,last)`
+    iterator erase(const_iterator first, const_iterator last)
+    {
+      const size_type i = first - cbegin();
+      const size_type count = last - first;
+      DUNE_ASSERT_BOUNDS(i + count <= size_);
+      if (count == 0)
+        return begin() + i;
+      if constexpr (relocatable)
+      {
+        std::destroy_n(data_ + i, count);
+        std::memmove(static_cast<void*>(data_ + i), static_cast<const void*>(data_ + i + count), (size_ - i - count) * sizeof(value_type));
+      }
+      else
+      {
+        std::move(data_ + i + count, data_ + size_, data_ + i);
+        std::destroy_n(data_ + size_ - count, count);
+      }
+      size_ -= count;
+      return begin() + i;
+    }
+
+    //! Swap the content with another vector
+    void swap(SmallVector& other)
+          noexcept(relocatable || std::is_nothrow_move_constructible_v<value_type>)
+    {
+      if (!isInline() && !other.isInline())
+      {
+        std::swap(data_, other.data_);
+        std::swap(size_, other.size_);
+        std::swap(capacity_, other.capacity_);
+      }
+      else
+      {
+        SmallVector tmp(std::move(other));
+        other = std::move(*this);
+        *this = std::move(tmp);
+      }
+    }
+
+    //! Swap the content of two vectors
+    friend void swap(SmallVector& a, SmallVector& b) noexcept(noexcept(a.swap(b)))
+    {
+      a.swap(b);
+    }
+
+    /** @} */
+
+    /** @{ Iterators  */
+
+    //! Returns a iterator pointing to the beginning of the vector.
+    iterator begin() noexcept
+    {
+      return data_;
+    }
+
+    //! Returns a const_iterator pointing to the beginning of the vector.
+    const_iterator begin() const noexcept
+    {
+      return data_;
+    }
+
+    //! Returns a const_iterator pointing to the beginning of the vector.
+    const_iterator cbegin() const noexcept
+    {
+      return data_;
+    }
+
+    //! Returns a reverse-iterator pointing to the end of the vector.
+    reverse_iterator rbegin() noexcept
+    {
+      return reverse_iterator{end()};
+    }
+
+    //! Returns a const reverse-iterator pointing to the end of the vector.
+    const_reverse_iterator rbegin() const noexcept
+    {
+      return const_reverse_iterator{end()};
+    }
+
+    //! Returns a const reverse-iterator pointing to the end of the vector.
+    const_reverse_iterator crbegin() const noexcept
+    {
+      return const_reverse_iterator{end()};
+    }
+
+    //! Returns an iterator pointing to the end of the vector.
+    iterator end() noexcept
+    {
+      return data_ + size_;
+    }
+
+    //! Returns a const_iterator pointing to the end of the vector.
+    const_iterator end() const noexcept
+    {
+      return data_ + size_;
+    }
+
+    //! Returns a const_iterator pointing to the end of the vector.
+    const_iterator cend() const noexcept
+    {
+      return data_ + size_;
+    }
+
+    //! Returns a reverse-iterator pointing to the begin of the vector.
+    reverse_iterator rend() noexcept
+    {
+      return reverse_iterator{begin()};
+    }
+
+    //! Returns a const reverse-iterator pointing to the begin of the vector.
+    const_reverse_iterator rend() const noexcept
+    {
+      return const_reverse_iterator{begin()};
+    }
+
+    //! Returns a const reverse-iterator pointing to the begin of the vector.
+    const_reverse_iterator crend() const noexcept
+    {
+      return const_reverse_iterator{begin()};
+    }
+
+    /** @} */
+
+    /** @{ Element access  */
+
+    //! Returns reference to the i'th element.
+    reference at(size_type i)
+    {
+      if (!(i < size()))
+        throw std::out_of_range("Index out of range");
+      return data_[i];
+    }
+
+    //! Returns a const reference to the i'th element.
+    const_reference at(size_type i) const
+    {
+      if (!(i < size()))
+        throw std::out_of_range("Index out of range");
+      return data_[i];
+    }
+
+    //! Returns reference to the i'th element.
+    reference operator[] (size_type i)
+    {
+      DUNE_ASSERT_BOUNDS(i < size_);
+      return data_[i];
+    }
+
+    //! Returns a const reference to the i'th element.
+    const_reference operator[] (size_type i) const
+    {
+      DUNE_ASSERT_BOUNDS(i < size_);
+      return data_[i];
+    }
+
+    //! Returns reference to first element of vector.
+    reference front()
+    {
+      DUNE_ASSERT_BOUNDS(size_ > 0);
+      return data_[0];
+    }
+
+    //! Returns const reference to first element of vector.
+    const_reference front() const
+    {
+      DUNE_ASSERT_BOUNDS(size_ > 0);
+      return data_[0];
+    }
+
+    //! Returns reference to last element of vector.
+    reference back()
+    {
+      DUNE_ASSERT_BOUNDS(size_ > 0);
+      return data_[size_-1];
+    }
+
+    //! Returns const reference to last element of vector.
+    const_reference back() const
+    {
+      DUNE_ASSERT_BOUNDS(size_ > 0);
+      return data_[size_-1];
+    }
+
+    //! Returns pointer to the underlying memory.
+    pointer data() noexcept
+    {
+      return data_;
+    }
+
+    //! Returns const pointer to the underlying memory.
+    const_pointer data() const noexcept
+    {
+      return data_;
+    }
+
+    /** @} */
+
+    /** @{ Capacity */
+
+    //! Returns number of elements in the vector.
+    size_type size() const noexcept
+    {
+      return size_;
+    }
+
+    //! Returns true if vector has no elements.
+    bool empty() const noexcept
+    {
+      return size_==0;
+    }
+
+    //! Returns the number of elements that fit into the allocated memory, at least n.
+    size_type capacity() const noexcept
+    {
+      return capacity_;
+    }
+
+    //! Returns the number of elements stored without heap allocation.
+    static constexpr size_type inline_capacity() noexcept
+    {
+      return n;
+    }
+
+    //! Returns the maximum length of the vector.
+    static size_type max_size() noexcept
+    {
+      return allocator_traits::max_size(allocator_type());
+    }
+
+    //! Returns true if the elements are stored inside the object.
+    bool isInline() const noexcept
+    {
+      return data_ == inlineData();
+    }
+
+    //! Increases the capacity to at least `count` elements.
+    void reserve(size_type count)
+    {
+      if (count > capacity_)
+        reallocate(count);
+    }
+
+    //! Releases unused heap memory, moving the elements inline if they fit.
+    void shrink_to_fit()
+    {
+      if (!isInline() && size_ < capacity_)
+        reallocate(std::max(size_, n));
+    }
+
+    /** @} */
+
+    //! Send SmallVector to an output stream
+    friend std::ostream& operator<< (std::ostream& s, const SmallVector& v)
+    {
+      for (size_type i=0; i<v.size(); i++)
+        s << v[i] << "  ";
+      return s;
+    }
+
+    inline friend std::size_t hash_value(const SmallVector& v) noexcept
+    {
+      return hash_range(v.begin(), v.end());
+    }
+
+  private:
+    pointer inlineData() noexcept
+    {
+      return reinterpret_cast<pointer>(inline_);
+    }
+
+    const_pointer inlineData() const noexcept
+    {
+      return reinterpret_cast<const_pointer>(inline_);
+    }
+
+    // whether p points to an element of this vector
+    bool contains(const_pointer p) const noexcept
+    {
+      std::less<const_pointer> less;
+      return !less(p, data_) && less(p, data_ + size_);
+    }
+
+    // capacity after growing to at least `count` elements
+    size_type growth(size_type count) const
+    {
+      if (count > max_size())
+        throw std::length_error("SmallVector exceeds its maximal size");
+      return std::max(count, std::min(2 * capacity_, max_size()));
+    }
+
+    void reserveForGrowth(size_type count)
+    {
+      if (count > capacity_)
+        reallocate(growth(count));
+    }
+
+    static pointer allocate(size_type count)
+    {
+      allocator_type allocator;
+      return allocator_traits::allocate(allocator, count);
+    }
+
+    static void deallocate(pointer p, size_type count) noexcept
+    {
+      allocator_type allocator;
+      allocator_traits::deallocate(allocator, p, count);
+    }
+
+    // release the heap memory, the vector must be empty
+    void deallocate() noexcept
+    {
+      if (!isInline())
+      {
+        deallocate(data_, capacity_);
+        data_ = inlineData();
+        capacity_ = n;
+      }
+    }
+
+    // move count elements from src into uninitialized memory at dest and destroy them at src
+    static void relocate(pointer src, size_type count, pointer dest)
+    {
+      if constexpr (relocatable)
+      {
+        if (count > 0)
+          std::memcpy(static_cast<void*>(dest), static_cast<const void*>(src), count * sizeof(value_type));
+      }
+      else
+      {
+        // copy instead of move if moving may throw, to keep the elements on failure
+        if constexpr (std::is_nothrow_move_constructible_v<value_type> || !std::is_copy_constructible_v<value_type>)
+          std::uninitialized_move_n(src, count, dest);
+        else
+          std::uninitialized_copy_n(src, count, dest);
+        std::destroy_n(src, count);
+      }
+    }
+
+    // move the elements to memory for `count` elements, which is inline if count <= n
+    void reallocate(size_type count)
+    {
+      pointer newData = count <= n ? inlineData() : allocate(count);
+      try {
+        relocate(data_, size_, newData);
+      }
+      catch (...) {
+        if (newData != inlineData())
+          deallocate(newData, count);
+        throw;
+      }
+      if (!isInline())
+        deallocate(data_, capacity_);
+      data_ = newData;
+      capacity_ = std::max(count, n);
+    }
+
+    // construct the new element in the new memory before moving the old
+    // elements, as the arguments may refer to elements of the vector
+    template<class... Args>
+    reference growAndEmplaceBack(Args&&... args)
+    {
+      const size_type newCapacity = growth(size_ + 1);
+      pointer newData = allocate(newCapacity);
+      pointer p = nullptr;
+      try {
+        p = std::construct_at(newData + size_, std::forward<Args>(args)...);
+        relocate(data_, size_, newData);
+      }
+      catch (...) {
+        if (p)
+          std::destroy_at(p);
+        deallocate(newData, newCapacity);
+        throw;
+      }
+      if (!isInline())
+        deallocate(data_, capacity_);
+      data_ = newData;
+      capacity_ = newCapacity;
+      ++size_;
+      return *p;
+    }
+
+    // take over the elements of other, this vector must be empty and inline
+    void takeFrom(SmallVector& other)
+    {
+      if (!other.isInline())
+      {
+        data_ = other.data_;
+        capacity_ = other.capacity_;
+        other.data_ = other.inlineData();
+        other.capacity_ = n;
+      }
+      else
+        relocate(other.data_, other.size_, data_);
+      size_ = other.size_;
+      other.size_ = 0;
+    }
+
+    pointer data_;
+    size_type size_;
+    size_type capacity_;
+    alignas(value_type) std::byte inline_[n * sizeof(value_type)];
+  };
+
+}
+
+DUNE_DEFINE_HASH(DUNE_HASH_TEMPLATE_ARGS(typename T, std::size_t n),DUNE_HASH_TYPE(Dune::SmallVector<T,n>))
+
+#endif // DUNE_COMMON_SMALLVECTOR_HH
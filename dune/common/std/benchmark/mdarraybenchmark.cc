@@ -0,0 +1,90 @@
+// -*- tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 2 -*-
+// vi: set et ts=4 sw=2 sts=2:
+// SPDX-FileCopyrightInfo: Copyright © DUNE Project contributors, see file LICENSE.md in module root
+// SPDX-License-Identifier: LicenseRef-GPL-2.0-only-with-DUNE-exception
+
+/**
+ * @brief Benchmark for the construction of small local tensors in inner loops.
+ *
+ * A rank-3 tensor (basis x quadrature point x component) is constructed and
+ * filled once per element. The default storage of `Std::mdarray` is compared
+ * with `std::vector` storage for fully static and mostly static extents. For
+ * each variant the time per element and the number of heap allocations are
+ * reported.
+ *
+ * Usage: ./mdarraybenchmark [elements]
+ */
+
+#include <cstddef>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <new>
+#include <span>
+#include <string>
+#include <vector>
+
+#include <dune/common/timer.hh>
+#include <dune/common/std/extents.hh>
+#include <dune/common/std/mdarray.hh>
+
+// count all heap allocations of the program
+static std::size_t allocations = 0;
+
+void* operator new (std::size_t size)
+{
+  ++allocations;
+  if (void* p = std::malloc(size))
+    return p;
+  throw std::bad_alloc{};
+}
+
+void operator delete (void* p) noexcept { std::free(p); }
+void operator delete (void* p, std::size_t) noexcept { std::free(p); }
+
+template <class Tensor, class... Exts>
+void benchmark (const std::string& name, std::size_t elements, Exts... exts)
+{
+  double checksum = 0.0;
+  const std::size_t allocationsBefore = allocations;
+  Dune::Timer timer;
+  for (std::size_t e = 0; e < elements; ++e) {
+    Tensor tensor(exts...);
+    for (std::size_t i = 0; i < std::size_t(tensor.extent(0)); ++i)
+      for (std::size_t q = 0; q < std::size_t(tensor.extent(1)); ++q)
+        for (std::size_t c = 0; c < std::size_t(tensor.extent(2)); ++c)
+          tensor(i,q,c) = double(e + i*q + c);
+    checksum += tensor(0,0,0) + tensor(tensor.extent(0)-1, tensor.extent(1)-1, tensor.extent(2)-1);
+  }
+  const double time = timer.elapsed();
+  std::cout << std::left << std::setw(40) << name
+            << std::setw(14) << 1e9*time/elements
+            << std::setw(14) << double(allocations - allocationsBefore)/elements
+            << checksum << std::endl;
+}
+
+int main (int argc, char** argv)
+{
+  using namespace Dune::Std;
+  const std::size_t elements = argc > 1 ? std::atol(argv[1]) : 1000000;
+
+  std::cout << std::left << std::setw(40) << "tensor"
+            << std::setw(14) << "ns/element"
+            << std::setw(14) << "allocs/element"
+            << "checksum" << std::endl;
+
+  // 4 basis functions x 4 quadrature points x 3 components
+  using StaticExtents = extents<int,4,4,3>;
+  benchmark<mdarray<double,StaticExtents>>("static, default storage", elements);
+  benchmark<mdarray<double,StaticExtents,layout_right,std::vector<double>>>("static, std::vector", elements);
+
+  // dynamic number of basis functions
+  using MostlyStaticExtents = extents<int,std::dynamic_extent,4,3>;
+  benchmark<mdarray<double,MostlyStaticExtents>>("mostly static, default storage", elements, 4);
+  benchmark<mdarray<double,MostlyStaticExtents,layout_right,std::vector<double>>>("mostly static, std::vector", elements, 4);
+
+  // fully dynamic extents are stored in a std::vector by default
+  benchmark<mdarray<double,dextents<int,3>>>("dynamic, default storage", elements, 4, 4, 3);
+
+  return 0;
+}
@@ -0,0 +1,168 @@
+// -*- tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 2 -*-
+// vi: set et ts=4 sw=2 sts=2:
+// SPDX-FileCopyrightInfo: Copyright © DUNE Project contributors, see file LICENSE.md in module root
+// SPDX-License-Identifier: LicenseRef-GPL-2.0-only-with-DUNE-exception
+#ifndef DUNE_COMMON_STD_IMPL_SMALLBUFFERCONTAINER_HH
+#define DUNE_COMMON_STD_IMPL_SMALLBUFFERCONTAINER_HH
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <utility>
+#include <vector>
+
+namespace Dune::Std {
+namespace Impl {
+
+/**
+ * \brief A fixed-size container with inline storage for up to `N` elements.
+ *
+ * The size is set on construction. If it does not exceed `N`, the elements
+ * are stored inline and no heap allocation takes place. Otherwise the elements
+ * are stored in a `std::vector`. The container provides the subset of the
+ * `std::vector` interface needed by `Std::mdarray`.
+ *
+ * \tparam T  The element type, must be default constructible.
+ * \tparam N  The number of elements stored inline.
+ */
+template <class T, std::size_t N>
+class SmallBufferContainer
+{
+public:
+  using value_type = T;
+  using size_type = std::size_t;
+  using difference_type = std::ptrdiff_t;
+  using reference = value_type&;
+  using const_reference = const value_type&;
+  using pointer = value_type*;
+  using const_pointer = const value_type*;
+  using iterator = pointer;
+  using const_iterator = const_pointer;
+
+  /// \brief The number of elements that are stored without heap allocation
+  static constexpr size_type inline_capacity () noexcept { return N; }
+
+  /// \brief Construct an empty container
+  SmallBufferContainer () noexcept
+    : size_(0)
+    , data_(inline_.data())
+  {}
+
+  /// \brief Construct a container with `size` value-initialized elements
+  explicit SmallBufferContainer (size_type size)
+    : SmallBufferContainer(size, value_type{})
+  {}
+
+  /// \brief Construct a container with `size` copies of `value`
+  SmallBufferContainer (size_type size, const value_type& value)
+    : size_(size)
+  {
+    if (size_ <= N) {
+      data_ = inline_.data();
+      std::fill_n(data_, size_, value);
+    } else {
+      heap_.assign(size_, value);
+      data_ = heap_.data();
+    }
+  }
+
+  SmallBufferContainer (const SmallBufferContainer& other)
+    : size_(other.size_)
+    , heap_(other.heap_)
+  {
+    updateData();
+    std::copy_n(other.data_, other.isInline() ? size_ : 0, inline_.data());
+  }
+
+  SmallBufferContainer (SmallBufferContainer&& other) noexcept
+    : size_(other.size_)
+    , heap_(std::move(other.heap_))
+  {
+    updateData();
+    std::move(other.inline_.data(), other.inline_.data() + (isInline() ? size_ : 0), inline_.data());
+    other.reset();
+  }
+
+  SmallBufferContainer& operator= (const SmallBufferContainer& other)
+  {
+    if (this != &other) {
+      size_ = other.size_;
+      heap_ = other.heap_;
+      updateData();
+      std::copy_n(other.data_, other.isInline() ? size_ : 0, inline_.data());
+    }
+    return *this;
+  }
+
+  SmallBufferContainer& operator= (SmallBufferContainer&& other) noexcept
+  {
+    if (this != &other) {
+      size_ = other.size_;
+      heap_ = std::move(other.heap_);
+      updateData();
+      std::move(other.inline_.data(), other.inline_.data() + (isInline() ? size_ : 0), inline_.data());
+      other.reset();
+    }
+    return *this;
+  }
+
+  /// \brief Whether the elements are stored inline
+  bool isInline () const noexcept { return size_ <= N; }
+
+  size_type size () const noexcept { return size_; }
+  [[nodiscard]] bool empty () const noexcept { return size_ == 0; }
+
+  pointer data () noexcept { return data_; }
+  const_pointer data () const noexcept { return data_; }
+
+  reference operator[] (size_type i) noexcept { return data_[i]; }
+  const_reference operator[] (size_type i) const noexcept { return data_[i]; }
+
+  iterator begin () noexcept { return data_; }
+  const_iterator begin () const noexcept { return data_; }
+  const_iterator cbegin () const noexcept { return data_; }
+  iterator end () noexcept { return data_ + size_; }
+  const_iterator end () const noexcept { return data_ + size_; }
+  const_iterator cend () const noexcept { return data_ + size_; }
+
+  friend bool operator== (const SmallBufferContainer& lhs, const SmallBufferContainer& rhs)
+  {
+    return std::equal(lhs.begin(), lhs.end(), rhs.begin(), rhs.end());
+  }
+
+  friend bool operator!= (const SmallBufferContainer& lhs, const SmallBufferContainer& rhs)
+  {
+    return !(lhs == rhs);
+  }
+
+  friend void swap (SmallBufferContainer& lhs, SmallBufferContainer& rhs) noexcept
+  {
+    SmallBufferContainer tmp(std::move(lhs));
+    lhs = std::move(rhs);
+    rhs = std::move(tmp);
+  }
+
+private:
+  void updateData () noexcept
+  {
+    data_ = isInline() ? inline_.data() : heap_.data();
+  }
+
+  // leave a moved-from container empty with inline storage
+  void reset () noexcept
+  {
+    size_ = 0;
+    heap_.clear();
+    data_ = inline_.data();
+  }
+
+  size_type size_;
+  std::array<value_type,N> inline_{};
+  std::vector<value_type> heap_;
+  pointer data_;
+};
+
+} // end namespace Impl
+} // end namespace Dune::Std
+
+#endif // DUNE_COMMON_STD_IMPL_SMALLBUFFERCONTAINER_HH
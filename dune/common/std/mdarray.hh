@@ -19,11 +19,68 @@
 #include <dune/common/indices.hh>
 #include <dune/common/rangeutilities.hh>
 #include <dune/common/std/default_accessor.hh>
+#include <dune/common/std/layout_left.hh>
+#include <dune/common/std/layout_right.hh>
 #include <dune/common/std/mdspan.hh>
 #include <dune/common/std/no_unique_address.hh>
 #include <dune/common/std/impl/containerconstructiontraits.hh>
+#include <dune/common/std/impl/smallbuffercontainer.hh>
 
 namespace Dune::Std {
+namespace Impl {
+
+/**
+ * \brief Select the default storage container of an mdarray.
+ *
+ * For the exhaustive layouts `layout_left` and `layout_right`
+ * - a `std::array` is used if all extents are static,
+ * - a `SmallBufferContainer` is used if some extents are static and the
+ *   static part fits at least once into `inlineBytes`. Its inline capacity
+ *   is the largest multiple of the static part that fits into `inlineBytes`.
+ *
+ * In all other cases the storage is a `std::vector`.
+ */
+template <class Element, class Extents, class LayoutPolicy>
+struct MdarrayDefaultContainer
+{
+  static constexpr std::size_t inlineBytes = 512;
+
+  static constexpr std::size_t staticSize ()
+  {
+    std::size_t s = 1;
+    for (typename Extents::rank_type r = 0; r < Extents::rank(); ++r)
+      if (Extents::static_extent(r) != std::dynamic_extent)
+        s *= Extents::static_extent(r);
+    return s;
+  }
+
+  static constexpr bool exhaustive
+    = std::is_same_v<LayoutPolicy, Std::layout_right> || std::is_same_v<LayoutPolicy, Std::layout_left>;
+
+  static constexpr std::size_t inlineCapacity ()
+  {
+    if (staticSize() == 0)
+      return 0;
+    return (inlineBytes / sizeof(Element) / staticSize()) * staticSize();
+  }
+
+  static constexpr auto select ()
+  {
+    if constexpr (exhaustive && Extents::rank_dynamic() == 0)
+      return std::array<Element, staticSize()>{};
+    else if constexpr (exhaustive && staticSize() == 0)
+      return std::array<Element, 0>{};
+    else if constexpr (exhaustive && Extents::rank_dynamic() < Extents::rank() && inlineCapacity() > 0)
+      return SmallBufferContainer<Element, inlineCapacity()>{};
+    else
+      return std::vector<Element>{};
+  }
+
+  using type = decltype(select());
+};
+
+} // end namespace Impl
+
 
 /**
  * \brief An owning multi-dimensional array analog of mdspan.
@@ -62,9 +119,13 @@ namespace Dune::Std {
  *                  compile time. Must be a specialization of `Std::extents`.
  * \tparam LayoutPolicy   Specifies how to convert multi-dimensional index to underlying flat index.
  * \tparam Container      A container type accessible by a single index provided by the layout mapping.
+ *                        In contrast to P1684 the default is not always `std::vector`: if all
+ *                        extents are static, an inline `std::array` is used, and if most extents
+ *                        are static, a container with a small inline buffer is used. Thus small
+ *                        local tensors can be constructed without heap allocation.
  **/
 template <class Element, class Extents, class LayoutPolicy = Std::layout_right,
-          class Container = std::vector<Element>>
+          class Container = typename Impl::MdarrayDefaultContainer<Element,Extents,LayoutPolicy>::type>
 class mdarray
 {
   template <class,class,class,class> friend class mdarray;
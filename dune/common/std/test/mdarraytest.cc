@@ -5,6 +5,7 @@
 #include <config.h>
 
 #include <array>
+#include <span>
 #include <type_traits>
 #include <vector>
 
@@ -14,6 +15,7 @@
 #include <dune/common/std/layout_left.hh>
 #include <dune/common/std/layout_right.hh>
 #include <dune/common/std/mdarray.hh>
+#include <dune/common/std/impl/smallbuffercontainer.hh>
 
 template <class Tensor>
 void checkAccess(Dune::TestSuite& testSuite, const Tensor& tensor)
@@ -104,6 +106,7 @@ void test_layout (Dune::TestSuite& testSuite, std::string name, const E& extent)
 
   Dune::TestSuite subTestSuite(name);
   test_container<std::vector<double>>(subTestSuite, "std::vector<double>", mapping);
+  test_container<Dune::Std::Impl::SmallBufferContainer<double,4>>(subTestSuite, "SmallBufferContainer<double,4>", mapping);
   if constexpr(E::rank_dynamic() == 0) {
     if constexpr (E::rank() == 0)
         test_container<std::array<double,1>>(subTestSuite, "std::array<double,1>", mapping);
@@ -133,10 +136,71 @@ void test_extents (Dune::TestSuite& testSuite, std::string name)
   testSuite.subTest(subTestSuite);
 }
 
+void test_default_container (Dune::TestSuite& testSuite)
+{
+  Dune::TestSuite subTestSuite("default container");
+  using namespace Dune::Std;
+
+  // all extents static -> inline std::array
+  using T1 = mdarray<double, extents<int,3,4,2>>;
+  static_assert(std::is_same_v<T1::container_type, std::array<double,24>>);
+  using T2 = mdarray<double, extents<int>>;
+  static_assert(std::is_same_v<T2::container_type, std::array<double,1>>);
+
+  // mostly static extents -> small buffer with a multiple of the static size inline
+  using T3 = mdarray<double, extents<int,std::dynamic_extent,4,3>, layout_left>;
+  using C3 = T3::container_type;
+  static_assert(std::is_same_v<C3, Impl::SmallBufferContainer<double,C3::inline_capacity()>>);
+  static_assert(C3::inline_capacity() > 0 && C3::inline_capacity() % 12 == 0);
+
+  T3 small(2, 4, 3);
+  subTestSuite.check(small.container().isInline()) << "small tensor must be stored inline";
+  subTestSuite.check(small.container_size() == 24);
+  for (int i = 0; i < small.extent(0); ++i)
+    for (int j = 0; j < small.extent(1); ++j)
+      for (int k = 0; k < small.extent(2); ++k)
+        small(i,j,k) = 100*i + 10*j + k;
+
+  T3 large(T3::extents_type(int(C3::inline_capacity()), 4, 3), 1.0);
+  subTestSuite.check(!large.container().isInline()) << "large tensor must be stored on the heap";
+  subTestSuite.check(large(large.extent(0)-1,3,2) == 1.0);
+
+  // copy, move and swap keep the data
+  T3 copy(small);
+  subTestSuite.check(copy == small) << "copy of small buffer mdarray differs";
+  subTestSuite.check(copy.container_data() != small.container_data());
+  T3 moved(std::move(copy));
+  subTestSuite.check(moved(1,3,2) == 132.0);
+  subTestSuite.check(moved.container_data() == moved.container().data());
+  swap(moved, large);
+  subTestSuite.check(large(1,3,2) == 132.0 && large.container().isInline());
+  subTestSuite.check(moved(0,0,0) == 1.0 && !moved.container().isInline());
+
+  // moved-from containers are empty
+  C3 heapContainer(2*C3::inline_capacity(), 1.0), inlineContainer(3, 2.0);
+  C3 movedHeap(std::move(heapContainer));
+  subTestSuite.check(heapContainer.empty() && heapContainer.isInline() && heapContainer.begin() == heapContainer.end())
+    << "moved-from container on the heap not empty";
+  subTestSuite.check(movedHeap.size() == 2*C3::inline_capacity() && movedHeap[0] == 1.0);
+  movedHeap = std::move(inlineContainer);
+  subTestSuite.check(inlineContainer.empty() && inlineContainer.isInline()) << "moved-from inline container not empty";
+  subTestSuite.check(movedHeap.size() == 3 && movedHeap[2] == 2.0 && movedHeap.isInline());
+
+  // fully dynamic extents and strided layouts keep std::vector
+  using T4 = mdarray<double, dextents<int,2>>;
+  static_assert(std::is_same_v<T4::container_type, std::vector<double>>);
+  using T5 = mdarray<double, extents<int,std::dynamic_extent,1000>>;
+  static_assert(std::is_same_v<T5::container_type, std::vector<double>>);
+
+  testSuite.subTest(subTestSuite);
+}
+
 int main(int argc, char** argv)
 {
   Dune::TestSuite testSuite;
 
+  test_default_container(testSuite);
+
   // definition of some extents
   test_extents<Dune::Std::extents<int>>(testSuite, "rank=0");
   test_extents<Dune::Std::extents<int,7>>(testSuite, "rank=1");
@@ -7,6 +7,9 @@
 #include <iostream>
 #include <cstdlib>
 #include <algorithm>
+#include <numeric>
+#include <list>
+#include <vector>
 
 class Double {
 public:
@@ -168,6 +171,99 @@ int testComparison(){
   return 0;
 }
 
+int testAppend(){
+  using namespace Dune;
+  ArrayList<double,10> alist;
+  alist.push_back(-1);
+
+  std::vector<double> values(95);
+  std::iota(values.begin(), values.end(), 0.0);
+  alist.append(values);
+  // input range without known size
+  std::list<double> more(values.begin(), values.begin()+10);
+  alist.append(more.begin(), more.end());
+  alist.reserve(200);
+  alist.append(alist.begin()+1, alist.begin()+6);
+
+  if(alist.size()!=111) {
+    std::cerr<<"Append failed: wrong size "<<alist.size()<<" "<<__FILE__<<":"<<__LINE__<<std::endl;
+    return 1;
+  }
+  for(int i=0; i<111; i++) {
+    double expected = (i==0) ? -1 : (i<=95) ? i-1 : (i<=105) ? i-96 : i-106;
+    if(alist[i]!=expected) {
+      std::cerr<<"Append failed: "<<alist[i]<<"!="<<expected<<" "<<__FILE__<<":"<<__LINE__<<std::endl;
+      return 1;
+    }
+  }
+  return 0;
+}
+
+int testSegments(){
+  using namespace Dune;
+  ArrayList<double,10> alist;
+  initConsecutive(alist);
+  ArrayList<double,10>::iterator iter=alist.begin()+14;
+  iter.eraseToHere();
+
+  // 85 entries from 15 to 99 in the segments [15,20), [20,30), ..., [90,100)
+  const ArrayList<double,10>& clist = alist;
+  if(clist.segmentCount()!=9 || clist.segment(0).size()!=5 || clist.segment(0)[0]!=15
+     || clist.segment(8).size()!=10) {
+    std::cerr<<"Wrong segments "<<__FILE__<<":"<<__LINE__<<std::endl;
+    return 1;
+  }
+
+  double sum=0;
+  std::size_t segments=0;
+  clist.forEachSegment([&](std::span<const double> segment){
+    ++segments;
+    for(double value : segment)
+      sum+=value;
+  });
+  if(segments!=9 || sum!=99*100/2-14*15/2) {
+    std::cerr<<"forEachSegment failed "<<__FILE__<<":"<<__LINE__<<std::endl;
+    return 1;
+  }
+
+  alist.forEachSegment(alist.begin()+3, alist.begin()+27, [](std::span<double> segment){
+    for(double& value : segment)
+      value=-value;
+  });
+  for(int i=0; i<85; i++)
+    if(alist[i]!=((i>=3 && i<27) ? -(i+15) : i+15)) {
+      std::cerr<<"forEachSegment on range failed at "<<i<<" "<<__FILE__<<":"<<__LINE__<<std::endl;
+      return 1;
+    }
+  return 0;
+}
+
+int testSplit(){
+  using namespace Dune;
+  ArrayList<double,10> alist;
+  initConsecutive(alist);
+  (alist.begin()+4).eraseToHere();
+
+  for(std::size_t parts : {1, 2, 3, 7, 20}) {
+    auto next = alist.begin();
+    for(std::size_t part=0; part<parts; part++) {
+      auto range = alist.split(part, parts);
+      if(range.begin()!=next || (range.begin()!=alist.end() && range.begin()!=alist.begin()
+                                 && int(*range.begin())%10!=0)) {
+        std::cerr<<"Part "<<part<<" of "<<parts<<" does not start at a chunk boundary "
+                 <<__FILE__<<":"<<__LINE__<<std::endl;
+        return 1;
+      }
+      next = range.end();
+    }
+    if(next!=alist.end()) {
+      std::cerr<<"Parts do not cover the list "<<__FILE__<<":"<<__LINE__<<std::endl;
+      return 1;
+    }
+  }
+  return 0;
+}
+
 
 int main(){
   using namespace Dune;
@@ -197,6 +293,21 @@ int main(){
     ret++;
     cerr<< "Erasing failed!"<<endl;
   }
+
+  if(0!=testAppend()) {
+    ret++;
+    cerr<< "Appending failed!"<<endl;
+  }
+
+  if(0!=testSegments()) {
+    ret++;
+    cerr<< "Segments failed!"<<endl;
+  }
+
+  if(0!=testSplit()) {
+    ret++;
+    cerr<< "Splitting failed!"<<endl;
+  }
   return ret;
 
 }
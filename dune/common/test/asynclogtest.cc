@@ -0,0 +1,84 @@
+// -*- tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 2 -*-
+// vi: set et ts=4 sw=2 sts=2:
+// SPDX-FileCopyrightInfo: Copyright © DUNE Project contributors, see file LICENSE.md in module root
+// SPDX-License-Identifier: LicenseRef-GPL-2.0-only-with-DUNE-exception
+
+#include <cstdio>
+#include <fstream>
+#include <sstream>
+#include <string>
+
+#include <dune/common/asynclog.hh>
+#include <dune/common/debugstream.hh>
+#include <dune/common/test/testsuite.hh>
+
+using Stream = Dune::DebugStream<3, 2>;
+using InactiveStream = Dune::DebugStream<1, 2>;
+
+int main()
+{
+  Dune::TestSuite suite;
+
+  // common output with the lines prefixed by the rank
+  {
+    std::ostringstream out;
+    Stream stream;
+    InactiveStream inactive;
+    {
+      Dune::AsyncLog::Options options;
+      options.out = &out;
+      Dune::AsyncLog log(3, options);
+      log.attach(stream);
+      log.attach(inactive);
+      stream << "first line" << std::endl << "second " << 2 << std::endl << "incomplete";
+      inactive << "filtered at compile time" << std::endl;
+      log.flush();
+      suite.check(out.str() == "[3] first line\n[3] second 2\n") << "wrong output after flush: " << out.str();
+    }
+    suite.check(out.str() == "[3] first line\n[3] second 2\n[3] incomplete") << "incomplete line not written";
+  }
+
+  // one file per rank
+  {
+    Dune::AsyncLog::Options options;
+    options.file = "asynclogtest-%r.log";
+    options.bufferSize = 64;
+    std::string expected;
+    Stream stream;
+    {
+      Dune::AsyncLog log(7, options);
+      log.attach(stream);
+      for (int i = 0; i < 1000; ++i)
+      {
+        stream << "line " << i << "\n";
+        expected += "line " + std::to_string(i) + "\n";
+      }
+      std::cout << "writer stalled " << log.stalls() << " times" << std::endl;
+    }
+    std::ifstream file("asynclogtest-7.log");
+    std::stringstream content;
+    content << file.rdbuf();
+    suite.check(content.str() == expected) << "output lost with a small ring buffer";
+    std::remove("asynclogtest-7.log");
+  }
+
+  // filtered ranks deactivate the streams
+  {
+    std::ostringstream out;
+    Stream stream;
+    {
+      Dune::AsyncLog::Options options;
+      options.out = &out;
+      options.ranks = {0, 2};
+      Dune::AsyncLog log(1, options);
+      suite.check(!log.enabled()) << "rank 1 not filtered";
+      log.attach(stream);
+      suite.check(!stream.active()) << "stream of a filtered rank is active";
+      stream << "not written" << std::endl;
+    }
+    suite.check(stream.active()) << "stream not restored";
+    suite.check(out.str().empty()) << "filtered rank wrote output";
+  }
+
+  return suite.exit();
+}
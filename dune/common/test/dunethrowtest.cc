@@ -4,6 +4,7 @@
 // SPDX-License-Identifier: LicenseRef-GPL-2.0-only-with-DUNE-exception
 
 #include <regex>
+#include <string>
 
 #include <dune/common/exceptions.hh>
 #include <dune/common/test/testsuite.hh>
@@ -22,6 +23,13 @@ struct TestClass
   static const std::size_t c = 3;
 };
 
+struct NonCopyable
+{
+  NonCopyable() = default;
+  NonCopyable(const NonCopyable&) = delete;
+  friend std::ostream& operator<<(std::ostream& s, const NonCopyable&) { return s << "nc"; }
+};
+
 int main()
 {
   Dune::TestSuite test;
@@ -125,5 +133,39 @@ int main()
       << "DUNE_THROW cannot be used in constexpr context";
   }
 
+  // Check that DUNE_THROW_LAZY copies values that are destroyed during stack unwinding
+  {
+    std::string message;
+    try {
+      std::string name = "a string that does not fit into the small buffer";
+      char buffer[] = "buffer";
+      NonCopyable nc;
+      DUNE_THROW_LAZY(Dune::RangeError, name << " " << buffer << " " << std::string_view(name).substr(0, 1))
+        << TestClass::b << nc << std::endl;
+    }
+    catch(Dune::Exception& e) {
+      message = e.what();
+    }
+    test.check(std::regex_match(message, std::regex("Dune::RangeError \\[.*\\]: a string that does not fit into the small buffer buffer a2nc\n")))
+      << "DUNE_THROW_LAZY did not create expected message but '" << message << "'";
+  }
+
+  // Check that copies share the lazily formatted message and that message() replaces it
+  {
+    try {
+      DUNE_THROW_LAZY(Dune::MathError, "singular");
+    }
+    catch(Dune::MathError& e) {
+      Dune::MathError copy = e;
+      test.check(copy.what() == e.what())
+        << "copies of a lazy exception do not share the message";
+      copy.message("replaced");
+      test.check(std::string(copy.what()) == "replaced")
+        << "message() did not replace the lazy message";
+      test.check(std::regex_match(e.what(), std::regex(".*\\]: singular")))
+        << "message() of a copy changed the original";
+    }
+  }
+
   return test.exit();
 }
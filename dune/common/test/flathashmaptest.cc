@@ -0,0 +1,167 @@
+// -*- tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 2 -*-
+// vi: set et ts=4 sw=2 sts=2:
+// SPDX-FileCopyrightInfo: Copyright © DUNE Project contributors, see file LICENSE.md in module root
+// SPDX-License-Identifier: LicenseRef-GPL-2.0-only-with-DUNE-exception
+#include <cstdint>
+#include <memory>
+#include <random>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include <dune/common/flathashmap.hh>
+#include <dune/common/flathashset.hh>
+#include <dune/common/test/testsuite.hh>
+
+// a hash function that maps all keys to few values, which makes the probe sequences long
+struct BadHash
+{
+  std::size_t operator() (int key) const
+  {
+    return key % 3;
+  }
+};
+
+template<class Map>
+void checkAgainstUnorderedMap (Dune::TestSuite& suite, const std::string& name)
+{
+  Map map;
+  std::unordered_map<int,int> reference;
+  std::mt19937 random(42);
+  std::uniform_int_distribution<int> keys(0, 2000);
+
+  for (int i = 0; i < 20000; ++i)
+  {
+    const int key = keys(random);
+    switch (random() % 4)
+    {
+      case 0:
+      case 1:
+        map[key] = i;
+        reference[key] = i;
+        break;
+      case 2:
+        suite.check(map.erase(key) == reference.erase(key)) << name << ": wrong result of erase";
+        break;
+      case 3:
+        suite.check(map.contains(key) == reference.contains(key)) << name << ": wrong result of contains";
+        break;
+    }
+  }
+
+  suite.check(map.size() == reference.size()) << name << ": wrong size";
+  std::size_t visited = 0;
+  for (const auto& [key, value] : map)
+  {
+    ++visited;
+    suite.check(reference.at(key) == value) << name << ": wrong value of key " << key;
+  }
+  suite.check(visited == map.size()) << name << ": iteration visited " << visited << " elements";
+  suite.check(map.load_factor() <= map.max_load_factor()) << name << ": table too full";
+}
+
+int main()
+{
+  Dune::TestSuite suite;
+
+  // the SIMD and the portable groups find the same positions
+  {
+    std::mt19937 random(1);
+    const std::int8_t values[] = {Dune::Impl::flatHashEmpty, Dune::Impl::flatHashDeleted, 0, 1, 5, 127};
+    for (int trial = 0; trial < 1000; ++trial)
+    {
+      std::int8_t ctrl[16];
+      for (auto& c : ctrl)
+        c = values[random() % 6];
+      for (std::size_t offset = 0; offset < Dune::Impl::FlatHashGroup::width; offset += 8)
+      {
+        Dune::Impl::FlatHashGroup group(ctrl);
+        Dune::Impl::FlatHashGroupPortable portable(ctrl + offset);
+        auto inGroup = [&](auto mask, std::size_t j) {
+          for (int i : mask)
+            if (std::size_t(i) == j + offset)
+              return true;
+          return false;
+        };
+        for (std::size_t j = 0; j < 8; ++j)
+        {
+          suite.check(inGroup(group.maskEmpty(), j) == bool(ctrl[j+offset] == Dune::Impl::flatHashEmpty))
+            << "wrong empty mask";
+          suite.check(inGroup(group.maskEmptyOrDeleted(), j) == !Dune::Impl::flatHashIsFull(ctrl[j+offset]))
+            << "wrong free mask";
+          suite.check(inGroup(group.maskFull(), j) == Dune::Impl::flatHashIsFull(ctrl[j+offset]))
+            << "wrong full mask";
+          auto inPortable = [&](auto mask) {
+            for (int i : mask)
+              if (std::size_t(i) == j)
+                return true;
+            return false;
+          };
+          suite.check(inPortable(portable.maskEmpty()) == bool(ctrl[j+offset] == Dune::Impl::flatHashEmpty))
+            << "wrong portable empty mask";
+          suite.check(inPortable(portable.maskEmptyOrDeleted()) == !Dune::Impl::flatHashIsFull(ctrl[j+offset]))
+            << "wrong portable free mask";
+          // the portable match may contain false positives, but never misses a match
+          if (ctrl[j+offset] == 5)
+            suite.check(inPortable(portable.match(5)) && inGroup(group.match(5), j)) << "match missed";
+        }
+      }
+    }
+  }
+
+  checkAgainstUnorderedMap<Dune::FlatHashMap<int,int>>(suite, "FlatHashMap");
+  checkAgainstUnorderedMap<Dune::FlatHashMap<int,int,BadHash>>(suite, "FlatHashMap with bad hash");
+
+  // reserve, rehash and memory usage
+  {
+    Dune::FlatHashMap<std::int64_t,int> map;
+    suite.check(map.bucket_count() == 0 && map.begin() == map.end()) << "empty map allocated memory";
+    map.reserve(1000);
+    const std::size_t buckets = map.bucket_count();
+    const std::size_t memory = map.memoryUsage();
+    for (int i = 0; i < 1000; ++i)
+      map.try_emplace(std::int64_t(i) << 32, i);
+    suite.check(map.bucket_count() == buckets) << "map grew although memory was reserved";
+    suite.check(memory >= 1000 * sizeof(std::pair<const std::int64_t,int>)) << "memory usage too small";
+    for (int i = 0; i < 900; ++i)
+      map.erase(std::int64_t(i) << 32);
+    map.rehash(0);
+    suite.check(map.size() == 100 && map.bucket_count() < buckets) << "rehash(0) did not shrink the map";
+    suite.check(map.at(std::int64_t(950) << 32) == 950) << "element lost in rehash";
+    suite.checkThrow<std::out_of_range>([&]{ map.at(1); }) << "at() did not throw";
+  }
+
+  // strings, move-only values, erase while iterating, copies
+  {
+    Dune::FlatHashMap<std::string, std::unique_ptr<int>> map;
+    for (int i = 0; i < 100; ++i)
+      map.try_emplace(std::to_string(i), std::make_unique<int>(i));
+    suite.check(!map.try_emplace("1", nullptr).second) << "existing key inserted";
+    for (auto it = map.begin(); it != map.end(); )
+      it = (*it->second % 2 == 0) ? map.erase(it) : std::next(it);
+    suite.check(map.size() == 50 && map.contains("1") && !map.contains("2")) << "wrong erase while iterating";
+    auto moved = std::move(map);
+    suite.check(map.empty() && *moved.at("99") == 99) << "wrong move";
+
+    Dune::FlatHashMap<std::string,int> a = {{"one", 1}, {"two", 2}};
+    auto b = a;
+    b.insert_or_assign("two", 3);
+    suite.check(a != b && a.at("two") == 2 && b["two"] == 3) << "wrong copy";
+    b["two"] = 2;
+    suite.check(a == b) << "wrong comparison";
+  }
+
+  // sets
+  {
+    Dune::FlatHashSet<int> set = {1, 2, 3, 2};
+    suite.check(set.size() == 3 && set.count(2) == 1 && !set.contains(4)) << "wrong set";
+    set.insert(4);
+    set.erase(1);
+    int sum = 0;
+    for (int key : set)
+      sum += key;
+    suite.check(sum == 9) << "wrong set elements";
+  }
+
+  return suite.exit();
+}
@@ -0,0 +1,127 @@
+// -*- tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 2 -*-
+// vi: set et ts=4 sw=2 sts=2:
+// SPDX-FileCopyrightInfo: Copyright © DUNE Project contributors, see file LICENSE.md in module root
+// SPDX-License-Identifier: LicenseRef-GPL-2.0-only-with-DUNE-exception
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <cstdint>
+#include <cstring>
+#include <list>
+#include <string>
+#include <tuple>
+#include <unordered_set>
+#include <utility>
+#include <vector>
+
+#include <dune/common/flathashmap.hh>
+#include <dune/common/hash.hh>
+#include <dune/common/reservedvector.hh>
+#include <dune/common/test/testsuite.hh>
+
+// checks that dense tuples (i,j,k) have distinct hashes and fill the buckets of a
+// table with 2^bits buckets evenly
+template<class Tuple, class Hash>
+void checkDenseTuples (Dune::TestSuite& suite, const std::string& name, Hash hash)
+{
+  const int n = 64;
+  const int bits = 18;
+  std::unordered_set<std::size_t> hashes;
+  std::vector<int> buckets(1 << bits, 0);
+  for (int i = 0; i < n; ++i)
+    for (int j = 0; j < n; ++j)
+      for (int k = 0; k < n; ++k)
+      {
+        const std::size_t h = hash(Tuple{i, j, k});
+        hashes.insert(h);
+        ++buckets[h & ((1 << bits) - 1)];
+      }
+  suite.check(hashes.size() == std::size_t(n * n * n)) << name << ": " << n * n * n - hashes.size() << " collisions";
+  // with 2^18 keys in 2^18 buckets, the fullest bucket of a random function holds about 9 keys
+  const int maxLoad = *std::max_element(buckets.begin(), buckets.end());
+  suite.check(maxLoad <= 12) << name << ": " << maxLoad << " keys in one bucket";
+}
+
+int main()
+{
+  Dune::TestSuite suite;
+
+  // reference values of wyhash final version 4.2 with seed i for the i-th message
+  if constexpr (std::endian::native == std::endian::little)
+  {
+    const std::pair<std::uint64_t, std::string> vectors[] = {
+      {0x93228a4de0eec5a2ull, ""},
+      {0xc5bac3db178713c4ull, "a"},
+      {0xa97f2f7b1d9b3314ull, "abc"},
+      {0x786d1f1df3801df4ull, "message digest"},
+      {0xdca5a8138ad37c87ull, "abcdefghijklmnopqrstuvwxyz"},
+      {0xb9e734f117cfaf70ull, "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789"},
+      {0x6cc5eab49a92d617ull, "12345678901234567890123456789012345678901234567890123456789012345678901234567890"}
+    };
+    for (std::size_t i = 0; i < std::size(vectors); ++i)
+      suite.check(Dune::hash_bytes(vectors[i].second.data(), vectors[i].second.size(), i) == vectors[i].first)
+        << "wrong hash of \"" << vectors[i].second << "\"";
+  }
+
+  // every length, independent of the alignment, every bit matters
+  {
+    unsigned char buffer[256 + 8];
+    for (std::size_t i = 0; i < sizeof(buffer); ++i)
+      buffer[i] = static_cast<unsigned char>(i * 131 + 7);
+    std::unordered_set<std::uint64_t> hashes;
+    for (std::size_t len = 0; len <= 256; ++len)
+    {
+      unsigned char shifted[256 + 8];
+      std::memcpy(shifted + 3, buffer, len);
+      const std::uint64_t h = Dune::hash_bytes(buffer, len);
+      hashes.insert(h);
+      suite.check(Dune::hash_bytes(shifted + 3, len) == h) << "hash depends on alignment for length " << len;
+      suite.check(Dune::hash_bytes(buffer, len, 1) != h) << "hash ignores the seed for length " << len;
+      for (std::size_t bit = 0; bit < 8 * len; bit += 7)
+      {
+        buffer[bit / 8] ^= 1 << (bit % 8);
+        suite.check(Dune::hash_bytes(buffer, len) != h) << "hash ignores bit " << bit << " of length " << len;
+        buffer[bit / 8] ^= 1 << (bit % 8);
+      }
+    }
+    suite.check(hashes.size() == 257) << "prefixes have equal hashes";
+  }
+
+  // policies and range_hash
+  {
+    const std::vector<int> v = {3, 1, 4, 1, 5};
+    const std::array<int,5> a = {3, 1, 4, 1, 5};
+    Dune::ReservedVector<int,8> r = {3, 1, 4, 1, 5};
+    const std::list<int> l = {3, 1, 4, 1, 5};
+
+    Dune::range_hash<> wyhash;
+    suite.check(wyhash(v) == Dune::hash_bytes(v.data(), 5 * sizeof(int))) << "contiguous range not hashed as bytes";
+    suite.check(wyhash(v) == wyhash(a) && wyhash(v) == wyhash(r)) << "equal contiguous ranges have different hashes";
+    suite.check(wyhash(l) == Dune::hash_range<Dune::WyHashPolicy>(l.begin(), l.end())) << "wrong hash of list";
+    suite.check(wyhash(l) != wyhash(std::list<int>{3, 1, 4, 1})) << "list hash ignores the last element";
+
+    Dune::range_hash<Dune::HashCombinePolicy> combine;
+    suite.check(combine(v) == Dune::hash_range(v.begin(), v.end())) << "wrong hash of HashCombinePolicy";
+    std::size_t seed = 0;
+    Dune::hash_combine(seed, 1);
+    Dune::hash_combine(seed, std::string("one"));
+    suite.check(combine(std::pair<int,std::string>(1, "one")) == seed) << "wrong tuple hash of HashCombinePolicy";
+
+    // pairs of doubles are hashed through the hash of their elements, so that 0.0 == -0.0 agree
+    suite.check(wyhash(std::pair<double,int>(0.0, 1)) == wyhash(std::pair<double,int>(-0.0, 1))) << "wrong hash of zero";
+    suite.check(wyhash(std::vector<double>{0.0}) == wyhash(std::vector<double>{-0.0})) << "wrong hash of zero";
+    suite.check(wyhash(std::tuple<int,int>(1, 2)) != wyhash(std::tuple<int,int>(2, 1))) << "tuple hash is symmetric";
+    suite.check(wyhash(std::tuple<int,int>(0, 0)) != wyhash(std::tuple<int,int,int>(0, 0, 0))) << "tuple hash ignores size";
+
+    Dune::FlatHashMap<std::array<int,3>, int, Dune::range_hash<>> map;
+    for (int i = 0; i < 100; ++i)
+      map[{i, i + 1, i + 2}] = i;
+    suite.check(map.size() == 100 && map.at({7, 8, 9}) == 7) << "wrong map with range_hash";
+  }
+
+  checkDenseTuples<std::array<int,3>>(suite, "WyHashPolicy array", Dune::range_hash<>());
+  checkDenseTuples<std::tuple<int,int,int>>(suite, "WyHashPolicy tuple", Dune::range_hash<>());
+  checkDenseTuples<std::array<std::int64_t,3>>(suite, "WyHashPolicy int64 array", Dune::range_hash<>());
+
+  return suite.exit();
+}
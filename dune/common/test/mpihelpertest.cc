@@ -5,6 +5,7 @@
 
 #include <iostream>
 
+#include <dune/common/exceptions.hh>
 #include <dune/common/parallel/mpihelper.hh>
 
 int main(int argc, char** argv)
@@ -19,7 +20,7 @@ int main(int argc, char** argv)
   typedef Dune::MPIHelper Helper;
 
   {
-    Helper& mpi = Helper::instance(argc, argv);
+    Helper& mpi = Helper::instance(argc, argv, Dune::MPIThreadLevel::funneled);
 
     [[maybe_unused]] Helper::MPICommunicator comm = mpi.getCommunicator();
     comm= mpi.getCommunicator();
@@ -31,6 +32,21 @@ int main(int argc, char** argv)
     [[maybe_unused]] Helper::MPICommunicator comm = mpi.getCommunicator();
     comm= mpi.getCommunicator();
 
+    // check the node-local topology information
+    auto nodeComm = Dune::Communication<Helper::MPICommunicator>(mpi.getNodeCommunicator());
+    if (nodeComm.rank() != mpi.nodeRank() || nodeComm.size() != mpi.nodeSize())
+      DUNE_THROW(Dune::Exception, "Node communicator does not match nodeRank()/nodeSize()");
+    if (mpi.nodeSize() < 1 || mpi.nodeSize() > mpi.size())
+      DUNE_THROW(Dune::Exception, "Invalid number of ranks per node: " << mpi.nodeSize());
+    if (mpi.getCommunication().sum(mpi.nodeRank() == 0 ? mpi.nodeSize() : 0) != mpi.size())
+      DUNE_THROW(Dune::Exception, "Node communicators do not partition the world communicator");
+    if (mpi.boundCores() < 1)
+      DUNE_THROW(Dune::Exception, "Process is not bound to any core");
+
+    std::cout << "rank " << mpi.rank() << ": node rank " << mpi.nodeRank() << " of " << mpi.nodeSize()
+              << ", thread level " << int(mpi.threadLevel())
+              << ", bound to " << mpi.boundCores() << " cores" << std::endl;
+
 #ifdef MPIHELPER_PREINITIALIZE
 #if HAVE_MPI
     MPI_Finalize();
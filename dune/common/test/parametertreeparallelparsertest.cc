@@ -0,0 +1,70 @@
+// -*- tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 2 -*-
+// vi: set et ts=4 sw=2 sts=2:
+// SPDX-FileCopyrightInfo: Copyright © DUNE Project contributors, see file LICENSE.md in module root
+// SPDX-License-Identifier: LicenseRef-GPL-2.0-only-with-DUNE-exception
+
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <string>
+#include <vector>
+
+#include <dune/common/exceptions.hh>
+#include <dune/common/parametertree.hh>
+#include <dune/common/parametertreeparser.hh>
+#include <dune/common/parallel/mpihelper.hh>
+#include <dune/common/test/testsuite.hh>
+
+int main(int argc, char** argv)
+{
+  Dune::MPIHelper& mpihelper = Dune::MPIHelper::instance(argc, argv);
+  auto comm = mpihelper.getCommunication();
+  Dune::TestSuite suite;
+
+  // make sure the ranks started by the MPI launcher share the communicator,
+  // otherwise every rank reads the file on its own and the broadcast is not tested
+  for (const char* var : {"OMPI_COMM_WORLD_SIZE", "PMI_SIZE"})
+    if (const char* size = std::getenv(var))
+      suite.check(comm.size() == std::atoi(size)) << "test runs on " << size << " ranks but is not built with MPI";
+
+  // only rank 0 gets the real file name, the file is read there only
+  const std::string file = "parametertreeparallelparsertest.ini";
+  if (comm.rank() == 0)
+  {
+    std::ofstream out(file);
+    out << "x = 1\n"
+        << "[solver]\n"
+        << "tolerance = 1e-8 # comment\n"
+        << "name = \"multi\n"
+        << "line\"\n";
+  }
+
+  Dune::ParameterTree pt = Dune::ParameterTreeParser::readINITree(
+    comm.rank() == 0 ? file : std::string("does-not-exist.ini"), comm);
+  suite.check(pt.get<int>("x") == 1) << "value on rank " << comm.rank();
+  suite.check(pt.get<double>("solver.tolerance") == 1e-8) << "value in subtree on rank " << comm.rank();
+  suite.check(pt.get<std::string>("solver.name") == "multi\nline") << "multi-line value on rank " << comm.rank();
+
+  // existing values are kept if overwrite is false
+  Dune::ParameterTree pt2;
+  pt2["x"] = "2";
+  Dune::ParameterTreeParser::readINITree(file, pt2, comm, false);
+  suite.check(pt2.get<int>("x") == 2) << "value was overwritten on rank " << comm.rank();
+  suite.check(pt2.hasKey("solver.tolerance")) << "value missing on rank " << comm.rank();
+
+  // a missing file is reported on all ranks
+  bool thrown = false;
+  try {
+    Dune::ParameterTreeParser::readINITree("does-not-exist.ini", comm);
+  }
+  catch (const Dune::IOError&) {
+    thrown = true;
+  }
+  suite.check(thrown) << "no exception for missing file on rank " << comm.rank();
+
+  comm.barrier();
+  if (comm.rank() == 0)
+    std::remove(file.c_str());
+
+  return suite.exit();
+}
@@ -285,6 +285,109 @@ void testReport()
   check_recursiveTreeCompare(ptree, ptree2);
 }
 
+// check that converted values are cached but follow changes of the string
+void testConversionCache()
+{
+  Dune::ParameterTree ptree;
+  ptree["a.b.vector"] = "1 2 3";
+  const Dune::ParameterTree& cptree = ptree;
+  check_assert(cptree.get<std::vector<int>>("a.b.vector").size() == 3);
+  check_assert(cptree.sub("a").get<std::vector<int>>("b.vector").size() == 3);
+  ptree["a.b.vector"] = "4 5";
+  std::vector<int> v = cptree.get<std::vector<int>>("a.b.vector");
+  check_assert(v.size() == 2 && v[0] == 4 && v[1] == 5);
+  check_assert(cptree.get<std::vector<double>>("a.b.vector")[1] == 5.0);
+
+  Dune::ParameterTree copy = ptree;
+  copy["a.b.vector"] = "6";
+  check_assert(copy.get<std::vector<int>>("a.b.vector").size() == 1);
+  check_assert(cptree.get<std::vector<int>>("a.b.vector").size() == 2);
+}
+
+// check the parsing of numbers
+void testNumbers()
+{
+  Dune::ParameterTree ptree;
+  ptree["int"] = " -42\t";
+  ptree["plus"] = "+7";
+  ptree["double"] = "1.5e-3 ";
+  ptree["dot"] = ".25";
+  ptree["inf"] = "inf";
+  ptree["overflow"] = "100000";
+  check_assert(ptree.get<int>("int") == -42);
+  check_assert(ptree.get<long>("plus") == 7);
+  check_assert(ptree.get<double>("double") == 1.5e-3);
+  check_assert(ptree.get<float>("dot") == 0.25f);
+  check_throw(ptree.get<double>("inf"), Dune::RangeError);
+  check_throw(ptree.get<short>("overflow"), Dune::RangeError);
+  check_throw(ptree.get<int>("double"), Dune::RangeError);
+}
+
+// test binary and JSON serialization round trips
+void testSerialization()
+{
+  std::stringstream s;
+  s << "z = 1\n"
+    << "a = 'quoted \"value\" with\n newline' \n"
+    << "[foo]\n"
+    << "path = C:\\dir\\file\n"
+    << "vector = 1 2 3\n"
+    << "[foo.bar]\n"
+    << "utf8 = \xc3\xa4\xe2\x82\xac\n";
+  Dune::ParameterTree ptree;
+  Dune::ParameterTreeParser::readINITree(s, ptree);
+  ptree["foo.control"] = std::string("\x01\t");
+  ptree.sub("empty");
+
+  {
+    std::stringstream binary;
+    ptree.writeBinary(binary);
+    Dune::ParameterTree ptree2 = Dune::ParameterTreeParser::readBinary(binary);
+    check_recursiveTreeCompare(ptree, ptree2);
+    check_assert(ptree2.hasSub("empty"));
+
+    // stable output
+    std::stringstream binary2;
+    ptree2.writeBinary(binary2);
+    check_assert(binary.str() == binary2.str());
+
+    // truncated data
+    std::string data = binary.str();
+    std::stringstream truncated(data.substr(0, data.size()-3));
+    check_throw(Dune::ParameterTreeParser::readBinary(truncated), Dune::ParameterTreeParserError);
+    std::stringstream invalid("no tree");
+    check_throw(Dune::ParameterTreeParser::readBinary(invalid), Dune::ParameterTreeParserError);
+  }
+
+  for (int indent : {0, 2})
+  {
+    std::stringstream json;
+    ptree.writeJSON(json, indent);
+    Dune::ParameterTree ptree2 = Dune::ParameterTreeParser::readJSON(json);
+    check_recursiveTreeCompare(ptree, ptree2);
+  }
+
+  {
+    std::stringstream json;
+    json << "{ \"n\": 42, \"x\": -1.5e3, \"flag\": true,\n"
+         << "  \"list\": [1, 2.5, \"three\"], \"u\": \"\\u00e4\\ud83d\\ude00\",\n"
+         << "  \"sub\": { \"key\": \"value\", \"a.b\": \"dotted\" } }";
+    Dune::ParameterTree ptree2;
+    ptree2["n"] = "1";
+    Dune::ParameterTreeParser::readJSON(json, ptree2, "json", false);
+    check_assert(ptree2.get<int>("n") == 1);
+    check_assert(ptree2.get<double>("x") == -1500.0);
+    check_assert(ptree2.get<bool>("flag"));
+    check_assert(ptree2.get<std::string>("list") == "1 2.5 three");
+    check_assert(ptree2.get<std::string>("u") == "\xc3\xa4\xf0\x9f\x98\x80");
+    check_assert(ptree2.get<std::string>("sub.key") == "value");
+    check_assert(ptree2.get<std::string>("sub.a.b") == "dotted");
+
+    std::stringstream invalid("{ \"a\": \"b\" ");
+    check_throw(Dune::ParameterTreeParser::readJSON(invalid), Dune::ParameterTreeParserError);
+  }
+}
+
 int main()
 {
   try {
@@ -323,6 +426,11 @@ int main()
     // check for specific bugs
     testFS1527();
     testFS1523();
+
+    testConversionCache();
+    testNumbers();
+
+    testSerialization();
   }
   catch (Dune::Exception & e)
   {
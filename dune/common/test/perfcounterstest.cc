@@ -0,0 +1,82 @@
+// -*- tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 2 -*-
+// vi: set et ts=4 sw=2 sts=2:
+// SPDX-FileCopyrightInfo: Copyright © DUNE Project contributors, see file LICENSE.md in module root
+// SPDX-License-Identifier: LicenseRef-GPL-2.0-only-with-DUNE-exception
+
+#include <iostream>
+#include <string>
+#include <thread>
+
+#include <dune/common/perfcounters.hh>
+#include <dune/common/profiler.hh>
+
+#include <dune/common/test/testsuite.hh>
+
+using Dune::PerfCounters;
+
+volatile double sink = 0.0;
+
+void work()
+{
+  for (int i = 0; i < 1000000; ++i)
+    sink = sink + 1.0;
+}
+
+int main()
+{
+  Dune::TestSuite suite;
+
+  // counters of the calling thread
+  {
+    PerfCounters counters;
+    std::cout << "hardware counters " << (counters.available() ? "available" : "not available") << std::endl;
+
+    PerfCounters::Values start = counters.read();
+    work();
+    PerfCounters::Values stop = counters.read();
+    for (std::size_t e = 0; e < PerfCounters::size; ++e)
+    {
+      auto event = PerfCounters::Event(e);
+      suite.check(stop[e] >= start[e]) << "counter of " << PerfCounters::name(event) << " decreased";
+      if (!counters.available(event))
+        suite.check(stop[e] == 0) << "unavailable counter of " << PerfCounters::name(event) << " is not zero";
+    }
+    if (counters.available(PerfCounters::instructions))
+      suite.check(stop[PerfCounters::instructions] - start[PerfCounters::instructions] >= 1000000)
+        << "too few instructions counted";
+  }
+
+  // counters in the profiler, also for threads registered later, not for exited threads
+  {
+    Dune::Profiler& profiler = Dune::Profiler::instance();
+    std::thread before([] { Dune::ProfileRegion region("before"); });
+    before.join();
+
+    const bool available = profiler.enableCounters();
+    {
+      Dune::ProfileRegion region("work");
+      work();
+    }
+    std::thread after([] { Dune::ProfileRegion region("after"); work(); });
+    after.join();
+    profiler.disableCounters();
+    {
+      Dune::ProfileRegion region("disabled");
+      work();
+    }
+
+    for (const auto& region : profiler.statistics())
+    {
+      const double instructions = region.events[PerfCounters::instructions].avg;
+      if (region.name == "work" || region.name == "after")
+        suite.check(!available || instructions >= 1000000) << "too few instructions counted in " << region.name;
+      else
+        suite.check(instructions == 0) << "instructions counted in " << region.name;
+      if (region.name == "before")
+        suite.check(region.count.avg == 1) << "results of an exited thread lost";
+    }
+    profiler.report(std::cout);
+  }
+
+  return suite.exit();
+}
@@ -0,0 +1,175 @@
+// -*- tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 2 -*-
+// vi: set et ts=4 sw=2 sts=2:
+// SPDX-FileCopyrightInfo: Copyright © DUNE Project contributors, see file LICENSE.md in module root
+// SPDX-License-Identifier: LicenseRef-GPL-2.0-only-with-DUNE-exception
+
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <dune/common/profiler.hh>
+#include <dune/common/parallel/mpihelper.hh>
+#include <dune/common/test/testsuite.hh>
+
+using Regions = std::vector<Dune::Profiler::RegionStatistics>;
+
+const Dune::Profiler::RegionStatistics* find(const Regions& regions, const std::string& path)
+{
+  for (const auto& region : regions)
+    if (region.path == path)
+      return &region;
+  return nullptr;
+}
+
+void compute()
+{
+  DUNE_PROFILE_FUNCTION();
+  for (int i = 0; i < 5; ++i)
+  {
+    DUNE_PROFILE_REGION("inner");
+    std::this_thread::sleep_for(std::chrono::milliseconds(1));
+  }
+}
+
+int main(int argc, char** argv)
+{
+  Dune::MPIHelper& mpihelper = Dune::MPIHelper::instance(argc, argv);
+  auto comm = mpihelper.getCommunication();
+  Dune::TestSuite suite;
+  Dune::Profiler& profiler = Dune::Profiler::instance();
+
+  // call tree of a single thread
+  {
+    for (int i = 0; i < 3; ++i)
+    {
+      DUNE_PROFILE_REGION("outer");
+      compute();
+    }
+    {
+      DUNE_PROFILE_REGION("inner");
+    }
+
+    Regions regions = profiler.statistics();
+    suite.require(regions.size() == 4) << "unexpected number of regions " << regions.size();
+    suite.check(regions[0].path == "outer" && regions[1].path == "outer/compute"
+                && regions[2].path == "outer/compute/inner" && regions[3].path == "inner")
+      << "regions not in depth-first order";
+    suite.check(regions[2].depth == 2 && regions[2].name == "inner") << "wrong name or depth";
+    suite.check(regions[0].count.avg == 3 && regions[2].count.avg == 15 && regions[3].count.avg == 1)
+      << "wrong number of calls";
+    suite.check(regions[2].inclusive.avg >= 0.015) << "inclusive time shorter than the sleep";
+    suite.check(regions[1].inclusive.avg >= regions[2].inclusive.avg) << "inclusive time smaller than of nested region";
+    suite.check(std::abs(regions[1].exclusive.avg - (regions[1].inclusive.avg - regions[2].inclusive.avg)) < 1e-9)
+      << "exclusive time is not inclusive time minus nested regions";
+  }
+
+  // threads are merged
+  {
+    std::vector<std::thread> threads;
+    for (int i = 0; i < 3; ++i)
+      threads.emplace_back([] { DUNE_PROFILE_REGION("worker"); compute(); });
+    for (auto& thread : threads)
+      thread.join();
+
+    Regions regions = profiler.statistics();
+    const auto* worker = find(regions, "worker");
+    suite.check(worker && worker->count.avg == 3) << "calls of the threads not merged";
+    const auto* inner = find(regions, "worker/compute/inner");
+    suite.check(inner && inner->count.avg == 15) << "nested calls of the threads not merged";
+  }
+
+  // statistics over the ranks
+  {
+    for (const char* var : {"OMPI_COMM_WORLD_SIZE", "PMI_SIZE"})
+      if (const char* size = std::getenv(var))
+        suite.check(comm.size() == std::atoi(size)) << "ranks of the launcher do not share a communicator";
+
+    for (int i = 0; i <= comm.rank(); ++i)
+    {
+      DUNE_PROFILE_REGION("varying");
+      if (comm.rank() % 2 == 0)
+      {
+        DUNE_PROFILE_REGION("even");
+      }
+      else
+      {
+        DUNE_PROFILE_REGION("odd");
+        DUNE_PROFILE_REGION("deep");
+      }
+    }
+    if (comm.rank() == comm.size() - 1)
+    {
+      DUNE_PROFILE_REGION("last rank");
+      std::this_thread::sleep_for(std::chrono::milliseconds(comm.size()));
+    }
+
+    Regions regions = profiler.statistics(comm);
+    const auto* varying = find(regions, "varying");
+    suite.require(varying) << "region missing on rank " << comm.rank();
+    suite.check(varying->ranks == comm.size()) << "wrong number of ranks";
+    suite.check(varying->count.min == 1 && varying->count.max == comm.size()
+                && varying->count.avg == 0.5 * (comm.size() + 1))
+      << "wrong statistics of calls on rank " << comm.rank();
+    const auto* last = find(regions, "last rank");
+    suite.check(last && last->ranks == 1 && last->count.avg == 1) << "region of a single rank missing on rank " << comm.rank();
+    suite.check(last > varying) << "regions of other ranks not merged in order of appearance";
+    suite.check(last && last->inclusive.min >= 0.001 * comm.size() && last->inclusive.min == last->inclusive.max)
+      << "time of a single rank not reduced over that rank only";
+
+    // ranks with different call paths obtain the same union of the regions
+    suite.check(comm.min(regions.size()) == comm.max(regions.size())) << "different regions on rank " << comm.rank();
+    const int evenRanks = (comm.size() + 1) / 2;
+    const auto* even = find(regions, "varying/even");
+    suite.check(even && even->ranks == evenRanks && even->count.min == 1 && even->count.max == 2*evenRanks - 1)
+      << "wrong statistics of a region of the even ranks on rank " << comm.rank();
+    const auto* odd = find(regions, "varying/odd");
+    const auto* deep = find(regions, "varying/odd/deep");
+    if (comm.size() > 1)
+    {
+      suite.check(odd && odd->ranks == comm.size() / 2 && odd->count.min == 2 && odd->count.max == 2*(comm.size()/2))
+        << "wrong statistics of a region of the odd ranks on rank " << comm.rank();
+      suite.check(deep && deep == odd + 1 && deep->depth == 2 && deep->ranks == odd->ranks)
+        << "nested region of the odd ranks not merged below its parent on rank " << comm.rank();
+    }
+    else
+      suite.check(!odd && !deep) << "region that was never entered";
+
+    std::ostringstream table;
+    profiler.report(table, comm);
+    suite.check((comm.rank() == 0) == (table.str().find("  compute") != std::string::npos)) << "table not printed on rank 0";
+  }
+
+  // export
+  {
+    profiler.reset();
+    profiler.enableTracing(2);
+    for (int i = 0; i < 3; ++i)
+    {
+      DUNE_PROFILE_REGION("traced \"region\"");
+    }
+    profiler.disableTracing();
+
+    Regions regions = profiler.statistics();
+    suite.check(find(regions, "outer")->count.avg == 0) << "results not reset";
+
+    std::ostringstream json;
+    Dune::Profiler::writeJSON(json, regions);
+    suite.check(json.str().find("\"path\": \"outer/compute/inner\"") != std::string::npos) << "region missing in JSON";
+    suite.check(json.str().find("\"name\": \"traced \\\"region\\\"\"") != std::string::npos) << "name not escaped in JSON";
+
+    std::ostringstream s;
+    profiler.writeChromeTrace(s, comm.rank());
+    const std::string trace = s.str();
+    std::size_t events = 0;
+    for (auto pos = trace.find("\"ph\": \"X\""); pos != std::string::npos; pos = trace.find("\"ph\": \"X\"", pos+1))
+      ++events;
+    suite.check(events == 2) << "wrong number of traced events " << events;
+    suite.check(trace.find("\"pid\": " + std::to_string(comm.rank())) != std::string::npos) << "wrong process id";
+  }
+
+  return suite.exit();
+}
@@ -6,6 +6,7 @@
 #include <dune/common/test/iteratortest.hh>
 #include <dune/common/poolallocator.hh>
 #include <iostream>
+#include <string>
 
 class DoubleWrapper
 {
@@ -363,6 +364,100 @@ int testPushPop(){
   return ret;
 }
 
+template<class List>
+int testSplice()
+{
+  int ret=0;
+  List alist, blist;
+
+  for(int i=0; i<100; i++)
+    alist.push_back(std::to_string(i));
+  for(int i=100; i<250; i++)
+    blist.push_back(std::to_string(i));
+  blist.pop_front();
+
+  alist.splice_back(blist);
+
+  if(!blist.empty() || blist.begin()!=blist.end()) {
+    std::cerr<<"Spliced list not empty! "<<__FILE__<<":"<<__LINE__<<std::endl;
+    ret++;
+  }
+
+  if(alist.size()!=249 || tail(alist)!="249") {
+    std::cerr<<"Splice failed! "<<__FILE__<<":"<<__LINE__<<std::endl;
+    ret++;
+  }
+
+  int i=0;
+  for(typename List::const_iterator iter=alist.begin(); iter!=alist.end(); ++iter, ++i)
+    if(*iter!=std::to_string(i<100 ? i : i+1)) {
+      std::cerr<<"Wrong element "<<*iter<<" after splice! "<<__FILE__<<":"<<__LINE__<<std::endl;
+      ret++;
+      break;
+    }
+
+  // both lists can still be used
+  blist.push_back("a");
+  alist.push_back("b");
+  alist.splice_back(blist);
+  List empty;
+  alist.splice_back(empty);
+  if(alist.size()!=251 || tail(alist)!="a") {
+    std::cerr<<"Splice after splice failed! "<<__FILE__<<":"<<__LINE__<<std::endl;
+    ret++;
+  }
+
+  // the removed elements of both lists are reused
+  List clist, dlist;
+  for(int i=0; i<10; i++) {
+    clist.push_back("c"+std::to_string(i));
+    dlist.push_back("d"+std::to_string(i));
+  }
+  for(int i=0; i<5; i++) {
+    clist.pop_front();
+    dlist.pop_front();
+  }
+  clist.splice_back(dlist);
+  for(int i=0; i<20; i++)
+    clist.push_front(std::to_string(i));
+  if(clist.size()!=30 || *clist.begin()!="19" || tail(clist)!="d9") {
+    std::cerr<<"Reuse after splice failed! "<<__FILE__<<":"<<__LINE__<<std::endl;
+    ret++;
+  }
+  return ret;
+}
+
+int testReuse()
+{
+  int ret=0;
+  Dune::SLList<std::string> alist;
+
+  for(int i=0; i<1000; i++)
+    alist.push_back(std::to_string(i));
+  const std::string* first=&*alist.begin();
+  alist.pop_front();
+  alist.push_front("new");
+
+  if(&*alist.begin()!=first) {
+    std::cerr<<"Memory of removed element not reused! "<<__FILE__<<":"<<__LINE__<<std::endl;
+    ret++;
+  }
+
+  Dune::SLList<std::string>::ModifyIterator iter=alist.beginModify();
+  for(int i=0; i<500; i++)
+    iter.remove();
+  for(int i=0; i<500; i++)
+    iter.insert(std::to_string(i));
+  alist.clear();
+  alist.push_back("after clear");
+
+  if(alist.size()!=1 || *alist.begin()!="after clear") {
+    std::cerr<<"List not usable after clear! "<<__FILE__<<":"<<__LINE__<<std::endl;
+    ret++;
+  }
+  return ret;
+}
+
 int main()
 {
   int ret=0;
@@ -431,6 +526,11 @@ int main()
   ret+=testDelete();
 
   ret+=testAssign();
+  std::cout<< "test splice"<<std::endl;
+  ret+=testSplice<Dune::SLList<std::string> >();
+  ret+=testSplice<Dune::SLList<std::string,Dune::PoolAllocator<std::string,8*1024-16> > >();
+  std::cout<< "test reuse"<<std::endl;
+  ret+=testReuse();
   list.clear();
   list1.clear();
   list2.clear();
@@ -0,0 +1,154 @@
+// -*- tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 2 -*-
+// vi: set et ts=4 sw=2 sts=2:
+// SPDX-FileCopyrightInfo: Copyright © DUNE Project contributors, see file LICENSE.md in module root
+// SPDX-License-Identifier: LicenseRef-GPL-2.0-only-with-DUNE-exception
+#include <list>
+#include <memory>
+#include <sstream>
+#include <string>
+#include <unordered_set>
+#include <vector>
+
+#include <dune/common/smallvector.hh>
+#include <dune/common/test/testsuite.hh>
+
+// counts the living objects to detect leaks and double destruction
+struct Counted
+{
+  static inline int alive = 0;
+
+  Counted(int v = 0) : value(v) { ++alive; }
+  Counted(const Counted& other) : value(other.value) { ++alive; }
+  Counted(Counted&& other) noexcept : value(other.value) { ++alive; }
+  Counted& operator= (const Counted&) = default;
+  Counted& operator= (Counted&&) = default;
+  ~Counted() { --alive; }
+
+  bool operator== (const Counted& other) const { return value == other.value; }
+
+  int value;
+};
+
+// a type with a heap pointer that is declared trivially relocatable
+struct Relocatable
+{
+  Relocatable(int v = 0) : value(std::make_unique<int>(v)) {}
+  Relocatable(const Relocatable& other) : value(std::make_unique<int>(*other.value)) {}
+  Relocatable(Relocatable&&) = default;
+  Relocatable& operator= (const Relocatable& other) { value = std::make_unique<int>(*other.value); return *this; }
+  Relocatable& operator= (Relocatable&&) = default;
+
+  std::unique_ptr<int> value;
+};
+
+template<>
+struct Dune::IsTriviallyRelocatable<Relocatable> : std::true_type {};
+
+template<class V>
+std::vector<int> toVector(const V& v)
+{
+  return std::vector<int>(v.begin(), v.end());
+}
+
+int main()
+{
+  Dune::TestSuite suite;
+
+  // inline storage and spilling to the heap
+  {
+    Dune::SmallVector<int, 4> v = {1, 2, 3};
+    suite.check(v.isInline() && v.capacity() == 4) << "small vector not stored inline";
+    v.push_back(4);
+    suite.check(v.isInline()) << "vector with n elements not stored inline";
+    v.push_back(5);
+    suite.check(!v.isInline() && v.capacity() >= 5) << "vector did not spill to the heap";
+    suite.check(toVector(v) == std::vector<int>{1, 2, 3, 4, 5}) << "wrong elements after spilling";
+    v.resize(2);
+    v.shrink_to_fit();
+    suite.check(v.isInline() && v.capacity() == 4) << "shrink_to_fit did not move the elements inline";
+    suite.check(toVector(v) == std::vector<int>{1, 2}) << "wrong elements after shrink_to_fit";
+    suite.check(v.at(1) == 2 && v.front() == 1 && v.back() == 2) << "wrong element access";
+    suite.checkThrow<std::out_of_range>([&]{ v.at(2); }) << "at() did not throw";
+  }
+
+  // insert and erase
+  {
+    Dune::SmallVector<int, 3> v = {1, 5};
+    v.insert(v.begin() + 1, 2);
+    v.insert(v.end() - 1, 2, 3);
+    int four[] = {4};
+    v.insert(v.begin() + 4, four, four + 1);
+    suite.check(toVector(v) == std::vector<int>{1, 2, 3, 3, 4, 5}) << "wrong elements after insert";
+    v.erase(v.begin() + 2);
+    v.erase(v.begin(), v.begin() + 1);
+    suite.check(toVector(v) == std::vector<int>{2, 3, 4, 5}) << "wrong elements after erase";
+    v.emplace(v.begin(), 1);
+    std::list<int> tail = {6, 7};
+    v.insert(v.end(), tail.begin(), tail.end());
+    suite.check(toVector(v) == std::vector<int>{1, 2, 3, 4, 5, 6, 7}) << "wrong elements after emplace";
+    v.pop_back();
+    v.assign(2, 9);
+    suite.check(toVector(v) == std::vector<int>{9, 9}) << "wrong elements after assign";
+  }
+
+  // arguments referring to elements of the full vector
+  {
+    Dune::SmallVector<std::string, 2> v = {"a string that is stored on the heap", "b"};
+    v.push_back(v[0]);
+    v.insert(v.begin(), v[2]);
+    v.resize(8, v[1]);
+    suite.check(v[0] == v[3] && v[2] == "b" && v[7] == v[0] && v.size() == 8)
+      << "wrong elements after inserting elements of the vector";
+  }
+
+  // non-trivial elements are constructed and destroyed exactly once
+  {
+    {
+      Dune::SmallVector<Counted, 2> v;
+      for (int i = 0; i < 10; ++i)
+        v.emplace_back(i);
+      v.insert(v.begin() + 3, Counted(42));
+      v.erase(v.begin(), v.begin() + 2);
+      Dune::SmallVector<Counted, 2> w = v;
+      Dune::SmallVector<Counted, 2> x = {Counted(1)};
+      swap(w, x);
+      suite.check(x == v && w.size() == 1 && w[0].value == 1) << "wrong elements after swap";
+      x = std::move(w);
+      suite.check(w.empty() && x.size() == 1) << "wrong sizes after move";
+      suite.check(Counted::alive == int(v.size() + x.size())) << "wrong number of living objects";
+    }
+    suite.check(Counted::alive == 0) << "leaked " << Counted::alive << " objects";
+  }
+
+  // move-only and trivially relocatable elements
+  {
+    Dune::SmallVector<Relocatable, 2> v;
+    for (int i = 0; i < 5; ++i)
+      v.emplace_back(i);
+    v.emplace(v.begin() + 2, 10);
+    v.erase(v.begin());
+    std::vector<int> values;
+    for (const auto& x : v)
+      values.push_back(*x.value);
+    suite.check(values == std::vector<int>{1, 10, 2, 3, 4}) << "wrong relocatable elements";
+
+    Dune::SmallVector<std::unique_ptr<int>, 2> u;
+    u.push_back(std::make_unique<int>(1));
+    auto w = std::move(u);
+    suite.check(w.size() == 1 && *w[0] == 1 && u.empty()) << "move of move-only elements failed";
+  }
+
+  // comparison, hashing and output
+  {
+    Dune::SmallVector<int, 2> a = {1, 2, 3};
+    Dune::SmallVector<int, 2> b = {1, 2};
+    suite.check(a != b && b < a && a == Dune::SmallVector<int, 2>(a.begin(), a.end())) << "wrong comparison";
+    std::unordered_set<Dune::SmallVector<int, 2>> set = {a, b, a};
+    suite.check(set.size() == 2) << "wrong hash";
+    std::ostringstream s;
+    s << b;
+    suite.check(s.str() == "1  2  ") << "wrong output";
+  }
+
+  return suite.exit();
+}
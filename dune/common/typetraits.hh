@@ -203,6 +203,27 @@ namespace Dune
 
 #endif // DOXYGEN
 
+  //! \brief Whether objects of this type can be relocated by copying their bytes
+  /**
+     Relocating an object means to move-construct a new object from it at
+     another address and to destroy the old one. For trivially relocatable
+     types this is equivalent to a `std::memcpy` of the object
+     representation, which containers like `SmallVector` use to move their
+     elements when growing, inserting or erasing.
+
+     By default is `true` for trivially copyable types (as per
+     `std::is_trivially_copyable`).
+
+     May be specialized to `true` for types that do not store pointers into
+     themselves, e.g. types that only manage memory on the heap. It must
+     not be specialized for types like `std::string` of libstdc++, which
+     point into their own small buffer.
+   */
+  template <typename T>
+  struct IsTriviallyRelocatable
+    : public std::integral_constant<bool, std::is_trivially_copyable<T>::value> {
+  };
+
   //! \brief Whether this type has a value of NaN.
   /**
    * Internally, this is just a forward to `std::is_floating_point<T>`.
@@ -14,6 +14,7 @@
 
 #include <dune/python/common/typeregistry.hh>
 #include <dune/python/common/densematrix.hh>
+#include <dune/python/pybind11/numpy.h>
 #include <dune/python/pybind11/pybind11.h>
 #include <dune/python/pybind11/operators.h>
 
@@ -26,6 +27,8 @@ namespace Dune
     template< class K >
     static void registerDynamicMatrix ( pybind11::handle scope )
     {
+      using pybind11::operator""_a;
+
       typedef Dune::DynamicMatrix< K > DM;
 
       auto cls = insertClass< DM >( scope, "DynamicMatrix",
@@ -50,6 +53,30 @@ namespace Dune
             return self;
           } ) );
 
+      cls.def( pybind11::init( [] ( pybind11::array_t< K > x ) {
+            if( x.ndim() != 2 )
+              throw pybind11::value_error( "Only two-dimensional arrays can be converted into DynamicMatrix." );
+            auto values = x.template unchecked< 2 >();
+            DM *self = new DM( values.shape( 0 ), values.shape( 1 ) );
+            for( pybind11::ssize_t i = 0; i < values.shape( 0 ); ++i )
+              for( pybind11::ssize_t j = 0; j < values.shape( 1 ); ++j )
+                (*self)[ i ][ j ] = values( i, j );
+            return self;
+          } ), "x"_a );
+
+      // the rows of a DynamicMatrix are stored separately, so NumPy obtains a
+      // copy (the rows themselves provide zero-copy buffers)
+      cls.def( "__array__", [] ( const DM &self, pybind11::object dtype, pybind11::object copy ) {
+            pybind11::array_t< K > array( { self.rows(), self.cols() } );
+            auto values = array.template mutable_unchecked< 2 >();
+            for( std::size_t i = 0; i < self.rows(); ++i )
+              for( std::size_t j = 0; j < self.cols(); ++j )
+                values( i, j ) = self[ i ][ j ];
+            if( !dtype.is_none() )
+              return pybind11::array( array.attr( "astype" )( dtype ) );
+            return pybind11::array( array );
+          }, pybind11::arg( "dtype" ) = pybind11::none(), pybind11::arg( "copy" ) = pybind11::none() );
+
       cls.def("__repr__",
           [] (const DM& m) {
             std::string repr = "Dune::DynamicMatrix:\n(";
@@ -14,6 +14,7 @@
 
 #include <dune/python/common/typeregistry.hh>
 #include <dune/python/common/densevector.hh>
+#include <dune/python/pybind11/numpy.h>
 #include <dune/python/pybind11/pybind11.h>
 #include <dune/python/pybind11/operators.h>
 
@@ -30,7 +31,7 @@ namespace Dune
 
       typedef Dune::DynamicVector< K > DV;
 
-      auto cls = insertClass< DV >( scope, "DynamicVector",
+      auto cls = insertClass< DV >( scope, "DynamicVector", pybind11::buffer_protocol(),
           GenerateTypeName("Dune::DynamicVector",MetaType<K>()),
           IncludeFiles{"dune/common/dynvector.hh"} ).first;
 
@@ -44,6 +45,29 @@ namespace Dune
             return self;
           } ), "x"_a );
 
+      cls.def( pybind11::init( [] ( pybind11::array_t< K > x ) {
+            if( x.ndim() != 1 )
+              throw pybind11::value_error( "Only one-dimensional arrays can be converted into DynamicVector." );
+            auto values = x.template unchecked< 1 >();
+            DV *self = new DV( values.shape( 0 ) );
+            for( pybind11::ssize_t i = 0; i < values.shape( 0 ); ++i )
+              (*self)[ i ] = values( i );
+            return self;
+          } ), "x"_a );
+
+      // NumPy arrays created from the buffer share the memory of the vector
+      // and keep it alive; they are invalidated by a resize of the vector
+      cls.def_buffer( [] ( DV &self ) -> pybind11::buffer_info {
+          return pybind11::buffer_info(
+              self.data(),                                        /* Pointer to buffer */
+              sizeof( K ),                                        /* Size of one scalar */
+              pybind11::format_descriptor< K >::format(),         /* Python struct-style format descriptor */
+              1,                                                  /* Number of dimensions */
+              { self.size() },                                    /* Buffer dimensions */
+              { sizeof( K ) }                                     /* Strides (in bytes) for each index */
+            );
+        } );
+
       cls.def("__repr__",
           [] (const DV &v) {
             std::string repr = "Dune::DynamicVector: (";
@@ -0,0 +1,288 @@
+// -*- tab-width: 2; indent-tabs-mode: nil; c-basic-offset: 2 -*-
+// vi: set et ts=4 sw=2 sts=2:
+// SPDX-FileCopyrightInfo: Copyright © DUNE Project contributors, see file LICENSE.md in module root
+// SPDX-License-Identifier: LicenseRef-GPL-2.0-only-with-DUNE-exception
+#ifndef DUNE_PYTHON_COMMON_NUMPYVIEW_HH
+#define DUNE_PYTHON_COMMON_NUMPYVIEW_HH
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <span>
+#include <string>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include <dune/common/classname.hh>
+#include <dune/common/fmatrix.hh>
+#include <dune/common/fvector.hh>
+#include <dune/common/std/extents.hh>
+#include <dune/common/std/layout_stride.hh>
+#include <dune/common/std/mdspan.hh>
+
+#include <dune/python/common/fmatrix.hh>
+#include <dune/python/common/fvector.hh>
+#include <dune/python/common/typeregistry.hh>
+#include <dune/python/pybind11/numpy.h>
+#include <dune/python/pybind11/pybind11.h>
+
+namespace Dune
+{
+
+  namespace Python
+  {
+
+    // mdspanView
+    // ----------
+
+    /**
+     * \brief Non-owning multi-dimensional view on the data of a NumPy array
+     *
+     * The view uses the strides of the array, so it can be created for any
+     * array with matching element type, including transposed or sliced arrays.
+     * Static extents of `Extents` must coincide with the shape of the array.
+     * For non-const `T` the array has to be writeable.
+     *
+     * The view does not keep the array alive, i.e., the array must outlive it.
+     */
+    template< class T, class Extents >
+    inline Std::mdspan< T, Extents, Std::layout_stride > mdspanView ( pybind11::array array )
+    {
+      using Value = std::remove_const_t< T >;
+      using Mapping = typename Std::layout_stride::template mapping< Extents >;
+
+      // compares the dtypes for equivalence, equal dtypes need not be the same object
+      if( !pybind11::isinstance< pybind11::array_t< Value > >( array ) )
+        throw pybind11::value_error( "Incompatible array dtype." );
+      if( std::size_t( array.ndim() ) != Extents::rank() )
+        throw pybind11::value_error( "Array has " + std::to_string( array.ndim() ) + " dimensions, expected " + std::to_string( Extents::rank() ) + "." );
+
+      std::array< typename Extents::index_type, Extents::rank() > shape, strides;
+      for( std::size_t r = 0; r < Extents::rank(); ++r )
+      {
+        if( Extents::static_extent( r ) != std::dynamic_extent && Extents::static_extent( r ) != std::size_t( array.shape( r ) ) )
+          throw pybind11::value_error( "Array shape does not match the static extents." );
+        if( array.strides( r ) < 0 || array.strides( r ) % pybind11::ssize_t( sizeof( Value ) ) != 0 )
+          throw pybind11::value_error( "Array strides must be non-negative multiples of the element size." );
+        shape[ r ] = array.shape( r );
+        strides[ r ] = array.strides( r ) / sizeof( Value );
+      }
+
+      T *data;
+      if constexpr (std::is_const_v< T >)
+        data = static_cast< T * >( array.data() );
+      else
+        data = static_cast< T * >( array.mutable_data() );
+      return Std::mdspan< T, Extents, Std::layout_stride >( data, Mapping( Extents( shape ), strides ) );
+    }
+
+    /** \brief Non-owning view with dynamic extents of the given rank, e.g. `mdspanView< double, 2 >( a )` */
+    template< class T, std::size_t rank >
+    inline auto mdspanView ( pybind11::array array )
+    {
+      return mdspanView< T, Std::dextents< std::size_t, rank > >( std::move( array ) );
+    }
+
+
+
+    // FieldVectorArray
+    // ----------------
+
+    /**
+     * \brief A `std::vector` of FieldVectors exported to Python as a class
+     *
+     * A plain `std::vector` is converted into a Python list by the pybind11
+     * STL casters, so a distinct type is used for collections that should be
+     * shared with NumPy.
+     */
+    template< class K, int n >
+    class FieldVectorArray
+      : public std::vector< FieldVector< K, n > >
+    {
+      typedef std::vector< FieldVector< K, n > > Base;
+
+    public:
+      using Base::Base;
+    };
+
+
+
+    // FieldMatrixArray
+    // ----------------
+
+    /** \brief A `std::vector` of FieldMatrices exported to Python as a class, see FieldVectorArray */
+    template< class K, int m, int n >
+    class FieldMatrixArray
+      : public std::vector< FieldMatrix< K, m, n > >
+    {
+      typedef std::vector< FieldMatrix< K, m, n > > Base;
+
+    public:
+      using Base::Base;
+    };
+
+
+
+    namespace detail
+    {
+
+      // registerFixedSizeArray
+      // ----------------------
+
+      /**
+       * \brief Register the common methods of FieldVectorArray and FieldMatrixArray
+       *
+       * `Block` is a fixed size block of `K` with the given `shape`, stored
+       * densely, so the array is a (N, shape...) NumPy array of `K`.
+       */
+      template< class Array, class K, std::size_t... shape, class... options >
+      inline void registerFixedSizeArray ( pybind11::class_< Array, options... > cls, std::index_sequence< shape... > )
+      {
+        using pybind11::operator""_a;
+        using Block = typename Array::value_type;
+        using Extents = Std::extents< std::size_t, std::dynamic_extent, shape... >;
+
+        static constexpr std::size_t blockSize = (shape * ...);
+        static_assert( sizeof( Block ) == blockSize * sizeof( K ), "Block must be densely stored." );
+
+        auto data = [] ( Array &self ) { return self.empty() ? nullptr : reinterpret_cast< K * >( self.data() ); };
+        auto bufferStrides = [] () {
+          std::vector< std::size_t > strides = { sizeof( Block ), shape... };
+          std::size_t stride = sizeof( K );
+          for( std::size_t r = strides.size()-1; r > 0; --r )
+            stride = std::exchange( strides[ r ], stride ) * stride;
+          return strides;
+        };
+
+        cls.def( pybind11::init( [] () { return new Array(); } ) );
+        cls.def( pybind11::init( [] ( std::size_t size ) { return new Array( size, Block( K( 0 ) ) ); } ), "size"_a );
+
+        // a single copy of the data, element-wise only for non-contiguous arrays
+        cls.def( pybind11::init( [] ( pybind11::array_t< K > x ) {
+            auto view = mdspanView< const K, Extents >( x );
+            Array *self = new Array( view.extent( 0 ) );
+            K *dst = self->empty() ? nullptr : reinterpret_cast< K * >( self->data() );
+            if( x.flags() & pybind11::array::c_style )
+              std::copy_n( x.data(), self->size() * blockSize, dst );
+            else
+            {
+              constexpr std::array< std::size_t, sizeof...( shape ) > extents = { shape... };
+              std::array< std::size_t, sizeof...( shape ) > idx;
+              for( std::size_t i = 0; i < view.extent( 0 ); ++i )
+                for( std::size_t k = 0; k < blockSize; ++k )
+                {
+                  // multi-index of the k-th entry of a block in row-major order
+                  std::size_t rem = k;
+                  for( std::size_t r = extents.size(); r-- > 0; rem /= extents[ r ] )
+                    idx[ r ] = rem % extents[ r ];
+                  dst[ i*blockSize + k ] = std::apply( [ & ] ( auto... j ) { return view( i, j... ); }, idx );
+                }
+            }
+            return self;
+          } ), "x"_a );
+
+        cls.def_buffer( [ data, bufferStrides ] ( Array &self ) -> pybind11::buffer_info {
+            return pybind11::buffer_info(
+                data( self ),                                       /* Pointer to buffer */
+                sizeof( K ),                                        /* Size of one scalar */
+                pybind11::format_descriptor< K >::format(),         /* Python struct-style format descriptor */
+                1 + sizeof...( shape ),                             /* Number of dimensions */
+                { self.size(), shape... },                          /* Buffer dimensions */
+                bufferStrides()                                     /* Strides (in bytes) for each index */
+              );
+          } );
+
+        cls.def( "__len__", [] ( const Array &self ) { return self.size(); } );
+        cls.def( "__getitem__", [] ( Array &self, std::size_t i ) -> Block & {
+            if( i >= self.size() )
+              throw pybind11::index_error();
+            return self[ i ];
+          }, pybind11::return_value_policy::reference_internal );
+        cls.def( "__setitem__", [] ( Array &self, std::size_t i, const Block &x ) {
+            if( i >= self.size() )
+              throw pybind11::index_error();
+            self[ i ] = x;
+          } );
+        cls.def( "append", [] ( Array &self, const Block &x ) { self.push_back( x ); }, "x"_a );
+        cls.def( "resize", [] ( Array &self, std::size_t size ) { self.resize( size, Block( K( 0 ) ) ); }, "size"_a );
+
+        // NumPy array sharing the memory, invalidated by append and resize
+        cls.def_property_readonly( "array", [ data, bufferStrides ] ( pybind11::object self ) {
+            Array &array = self.cast< Array & >();
+            return pybind11::array_t< K >( std::vector< std::size_t >{ array.size(), shape... }, bufferStrides(), data( array ), self );
+          } );
+      }
+
+    } // namespace detail
+
+
+
+    // registerFieldVectorArray
+    // ------------------------
+
+    /**
+     * \brief Register FieldVectorArray with the buffer protocol
+     *
+     * NumPy views the array as an N x n array without copying, e.g.,
+     * `numpy.asarray(points)`. The array can be constructed from any
+     * two-dimensional buffer of shape N x n with a single copy.
+     */
+    template< class K, int n, class... options >
+    inline void registerFieldVectorArray ( pybind11::handle scope, pybind11::class_< FieldVectorArray< K, n >, options... > cls )
+    {
+      registerFieldVector< K, n >( scope );
+      detail::registerFixedSizeArray< FieldVectorArray< K, n >, K >( cls, std::index_sequence< n >() );
+    }
+
+    template< class K, int n >
+    inline void registerFieldVectorArray ( pybind11::handle scope )
+    {
+      using Array = FieldVectorArray< K, n >;
+
+      auto entry = insertClass< Array >( scope, "FieldVectorArray_" + className< K >() + "_" + std::to_string( n ), pybind11::buffer_protocol(),
+          GenerateTypeName( "Dune::Python::FieldVectorArray", MetaType< K >(), n ),
+          IncludeFiles{ "dune/python/common/numpyview.hh" } );
+      if( !entry.second )
+        return;
+      registerFieldVectorArray( scope, entry.first );
+    }
+
+
+
+    // registerFieldMatrixArray
+    // ------------------------
+
+    /**
+     * \brief Register FieldMatrixArray with the buffer protocol
+     *
+     * NumPy views the array as an N x m x n array without copying. The array
+     * can be constructed from any three-dimensional buffer of shape N x m x n
+     * with a single copy.
+     */
+    template< class K, int m, int n, class... options >
+    inline void registerFieldMatrixArray ( pybind11::handle scope, pybind11::class_< FieldMatrixArray< K, m, n >, options... > cls )
+    {
+      registerFieldMatrix< K, m, n >( scope );
+      detail::registerFixedSizeArray< FieldMatrixArray< K, m, n >, K >( cls, std::index_sequence< m, n >() );
+    }
+
+    template< class K, int m, int n >
+    inline void registerFieldMatrixArray ( pybind11::handle scope )
+    {
+      using Array = FieldMatrixArray< K, m, n >;
+
+      auto entry = insertClass< Array >( scope, "FieldMatrixArray_" + className< K >() + "_" + std::to_string( m ) + "_" + std::to_string( n ), pybind11::buffer_protocol(),
+          GenerateTypeName( "Dune::Python::FieldMatrixArray", MetaType< K >(), m, n ),
+          IncludeFiles{ "dune/python/common/numpyview.hh" } );
+      if( !entry.second )
+        return;
+      registerFieldMatrixArray( scope, entry.first );
+    }
+
+  } // namespace Python
+
+} // namespace Dune
+
+#endif // #ifndef DUNE_PYTHON_COMMON_NUMPYVIEW_HH
@@ -52,23 +52,29 @@ namespace Dune
       {
         // BUG: Capturing the pybind11::object in a static variable leads to a
         //      memory fault in Python 3.6 upon module unloading.
-        //      As a simple fix, we reobtain the reference each time the type
-        //      registry is requested.
-#if 0
-        static pybind11::object instance;
-        if( !instance )
-          instance = pybind11::module::import( "dune.typeregistry" ).attr( "typeRegistry" );
-        return pybind11::cast< TypeRegistry & >( instance );
-#endif
-        return pybind11::cast< TypeRegistry & >( pybind11::module::import( "dune.typeregistry" ).attr( "typeRegistry" ) );
+        //      We only cache a plain pointer to the registry (owned by the
+        //      module dune.typeregistry) together with the pybind11 internals
+        //      it was obtained for. The internals change if the interpreter is
+        //      restarted, e.g., in embedded applications, and the registry is
+        //      then looked up again.
+        static const void *internals = nullptr;
+        static TypeRegistry *instance = nullptr;
+        const void *current = &pybind11::detail::get_internals();
+        if( !instance || (internals != current) )
+        {
+          instance = &pybind11::cast< TypeRegistry & >( pybind11::module::import( "dune.typeregistry" ).attr( "typeRegistry" ) );
+          internals = current;
+        }
+        return *instance;
       }
 
 
       template< class T >
       inline static auto findInTypeRegistry ()
       {
-        auto pos = typeRegistry().find( typeid(T) );
-        return std::make_pair( pos, pos == typeRegistry().end() );
+        TypeRegistry &registry = typeRegistry();
+        auto pos = registry.find( typeid(T) );
+        return std::make_pair( pos, pos == registry.end() );
       }
 
 
@@ -447,8 +453,9 @@ namespace Dune
 #endif
           return entry.first->second.includes;
         });
-        cls.def_property_readonly_static( "cppTypeName", [ entry ] ( pybind11::object ) { return entry.first->second.name; } );
-        cls.def_property_readonly_static( "cppIncludes", [ entry ] ( pybind11::object ) { return entry.first->second.includes; } );
+        // plain class attributes are considerably cheaper to create than properties
+        cls.attr( "cppTypeName" ) = entry.first->second.name;
+        cls.attr( "cppIncludes" ) = entry.first->second.includes;
 
         return std::make_pair( cls, true );
       }
@@ -82,8 +82,79 @@ def test_class_export():
     # the 'B' class still keeps the old vector 'x' alive
     assert run("run",StringIO(runCode),cls) == 10**2*10*3
 
+def test_fieldvectorarray():
+    """
+    Test bulk construction of FieldVector/FieldMatrix arrays from numpy.
+    """
+    from numpy import arange, asarray, array_equal
+    from dune.common import FieldVectorArray, FieldMatrixArray
+    x = arange(12.).reshape(4,3)
+    points = FieldVectorArray(x)
+    assert len(points) == 4
+    assert points[2][1] == 7.
+    y = asarray(points)
+    assert array_equal(x, y)
+    y[1,0] = -1.
+    assert points[1][0] == -1.
+    a = arange(16.).reshape(4,2,2)
+    assert array_equal(asarray(FieldMatrixArray(a)), a)
+
+def test_norms():
+    """
+    Test that all norms are registered on the class.
+    """
+    from dune.common import FieldVector
+    x = FieldVector([1., -2., 3.])
+    for norm in ['one_norm', 'one_norm_real', 'two_norm', 'infinity_norm', 'infinity_norm_real']:
+        assert norm in dir(type(x))
+    assert x.infinity_norm == 3.
+    assert x.one_norm == 6.
+    assert x.infinity_norm_real == 3.
+
+def test_cache():
+    """
+    Test that modules stored with custom CXXFLAGS are only found with the same flags.
+    """
+    import tempfile
+    from unittest import mock
+    from dune.generator.cache import ModuleCache, storeGenerated
+
+    with tempfile.TemporaryDirectory() as tmp:
+        cacheDir = os.path.join(tmp, 'cache')
+        def dunePy(name):
+            generated = os.path.join(tmp, name, 'python', 'dune', 'generated')
+            os.makedirs(os.path.join(generated, 'CMakeFiles', 'module.dir'))
+            for fileName in ['module.cc', 'header.hh']:
+                with open(os.path.join(generated, fileName), 'w') as f:
+                    f.write('// ' + fileName + '\n')
+            return os.path.join(tmp, name), generated
+
+        dunePyDir, generated = dunePy('compiled')
+        with open(os.path.join(generated, 'module.so'), 'w') as f:
+            f.write('compiled with custom flags')
+        with open(os.path.join(generated, 'CMakeFiles', 'module.dir', 'module.cc.o.d'), 'w') as f:
+            f.write('module.cc.o: module.cc header.hh\n')
+
+        env = {'DUNE_PY_CACHE': cacheDir, 'CXXFLAGS': '-O1 -g'}
+        with mock.patch.dict(os.environ, env), \
+             mock.patch('dune.common.module.getDunePyDir', return_value=dunePyDir):
+            assert storeGenerated([]) == 0
+            # same flags from the environment or set for the builder
+            dunePyDir, generated = dunePy('environment')
+            assert ModuleCache(dunePyDir).fetch('module')
+            with open(os.path.join(generated, 'module.so'), 'r') as f:
+                assert f.read() == 'compiled with custom flags'
+            assert ModuleCache(dunePy('builder')[0]).fetch('module', '-O1 -g')
+            assert not ModuleCache(dunePy('other')[0]).fetch('module', '-O3')
+        with mock.patch.dict(os.environ, {'DUNE_PY_CACHE': cacheDir}):
+            os.environ.pop('CXXFLAGS', None)
+            assert not ModuleCache(dunePy('default')[0]).fetch('module')
+
 if __name__ == "__main__":
     from dune.packagemetadata import getDunePyDir
     _ = getDunePyDir()
     test_class_export()
     test_numpyvector()
+    test_fieldvectorarray()
+    test_norms()
+    test_cache()
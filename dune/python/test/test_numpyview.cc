@@ -0,0 +1,122 @@
+// SPDX-FileCopyrightInfo: Copyright © DUNE Project contributors, see file LICENSE.md in module root
+// SPDX-License-Identifier: LicenseRef-GPL-2.0-only-with-DUNE-exception
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include <dune/common/dynvector.hh>
+#include <dune/common/fvector.hh>
+#include <dune/common/test/testsuite.hh>
+#include <dune/python/common/dynvector.hh>
+#include <dune/python/common/fvector.hh>
+#include <dune/python/common/numpyview.hh>
+#include <dune/python/pybind11/embed.h>
+
+int main()
+{
+#if (PY_MAJOR_VERSION >= 3) && (PY_MINOR_VERSION >= 11)
+  PyConfig config;
+  PyConfig_InitPythonConfig(&config);
+  PyConfig_SetString(&config, &config.program_name, PYTHON_INTERPRETER);
+  pybind11::scoped_interpreter guard{&config};
+#else
+  Py_SetProgramName(PYTHON_INTERPRETER);
+  pybind11::scoped_interpreter guard{};
+#endif
+
+  Dune::TestSuite suite;
+
+  pybind11::module dcommon = pybind11::module::import("dune.common");
+  pybind11::module numpy = pybind11::module::import("numpy");
+  Dune::Python::registerFieldVector<double,3>(dcommon);
+  Dune::Python::registerFieldVectorArray<double,3>(dcommon);
+
+  // NumPy array sharing the memory of a DynamicVector
+  {
+    pybind11::object vector = pybind11::cast(Dune::DynamicVector<double>(5, 1.0));
+    pybind11::array array = numpy.attr("asarray")(vector);
+    array.attr("__setitem__")(2, 4.0);
+    const auto& v = vector.cast<const Dune::DynamicVector<double>&>();
+    suite.check(array.data() == v.data(), "DynamicVector buffer shares memory");
+    suite.check(v[2] == 4.0, "write through NumPy view");
+    // the array keeps the vector alive
+    vector = pybind11::none();
+    suite.check(array.attr("sum")().cast<double>() == 8.0, "array outlives the Python vector handle");
+  }
+
+  // FieldVectorArray viewed as N x n array
+  {
+    using Points = Dune::Python::FieldVectorArray<double,3>;
+    pybind11::object points = pybind11::cast(Points(4, Dune::FieldVector<double,3>(0.0)));
+    pybind11::array array = numpy.attr("asarray")(points);
+    suite.check(array.ndim() == 2 && array.shape(0) == 4 && array.shape(1) == 3, "shape of FieldVector array");
+    array.attr("__setitem__")(pybind11::make_tuple(1, 2), 7.0);
+    suite.check(points.cast<const Points&>()[1][2] == 7.0, "write through FieldVector array view");
+
+    pybind11::object copy = dcommon.attr("FieldVectorArray_double_3")(numpy.attr("ones")(pybind11::make_tuple(6, 3)));
+    suite.check(copy.cast<const Points&>().size() == 6, "construct FieldVector array from NumPy");
+    suite.check(copy.cast<const Points&>()[5][1] == 1.0, "values of constructed FieldVector array");
+
+    pybind11::object strided = dcommon.attr("FieldVectorArray_double_3")(numpy.attr("arange")(18.0).attr("reshape")(3, 6).attr("__getitem__")(pybind11::make_tuple(pybind11::slice(0, 3, 1), pybind11::slice(0, 6, 2))));
+    suite.check(strided.cast<const Points&>()[2][1] == 14.0, "construct FieldVector array from strided NumPy array");
+  }
+
+  // FieldMatrixArray viewed as N x m x n array
+  {
+    using Matrices = Dune::Python::FieldMatrixArray<double,2,3>;
+    Dune::Python::registerFieldMatrixArray<double,2,3>(dcommon);
+    pybind11::object a = numpy.attr("arange")(24.0).attr("reshape")(4, 2, 3);
+    pybind11::object matrices = dcommon.attr("FieldMatrixArray_double_2_3")(a);
+    const auto& m = matrices.cast<const Matrices&>();
+    suite.check(m.size() == 4 && m[3][1][2] == 23.0, "construct FieldMatrix array from NumPy");
+
+    pybind11::array array = numpy.attr("asarray")(matrices);
+    suite.check(array.ndim() == 3 && array.shape(1) == 2 && array.shape(2) == 3, "shape of FieldMatrix array");
+    suite.check(numpy.attr("array_equal")(array, a).cast<bool>(), "values of FieldMatrix array view");
+    array.attr("__setitem__")(pybind11::make_tuple(2, 0, 1), -1.0);
+    suite.check(m[2][0][1] == -1.0, "write through FieldMatrix array view");
+  }
+
+  // mdspan views on NumPy arrays
+  {
+    auto a = numpy.attr("arange")(12.0).attr("reshape")(3, 4).cast<pybind11::array_t<double>>();
+    auto view = Dune::Python::mdspanView<double,2>(a);
+    suite.check(view.extent(0) == 3 && view.extent(1) == 4, "extents of mdspan view");
+    suite.check(view(2,1) == 9.0, "element access of mdspan view");
+
+    auto t = a.attr("T").cast<pybind11::array_t<double>>();
+    auto tview = Dune::Python::mdspanView<const double,2>(t);
+    suite.check(tview(1,2) == 9.0, "mdspan view on transposed array");
+
+    using Extents = Dune::Std::extents<std::size_t, std::dynamic_extent, 4>;
+    auto sview = Dune::Python::mdspanView<double,Extents>(a);
+    sview(0,0) = -1.0;
+    suite.check(a.at(0,0) == -1.0, "write through mdspan view");
+
+    bool thrown = false;
+    try {
+      Dune::Python::mdspanView<double,Dune::Std::extents<std::size_t,3,3>>(a);
+    } catch (const pybind11::value_error&) {
+      thrown = true;
+    }
+    suite.check(thrown, "mismatching static extents are rejected");
+
+    pybind11::object dtype = numpy.attr("dtype")("float64", pybind11::arg("copy") = true);
+    auto c = numpy.attr("zeros")(pybind11::make_tuple(2, 3), dtype).cast<pybind11::array>();
+    suite.check(!c.dtype().is(pybind11::dtype::of<double>()), "dtype of the array is a copy");
+    suite.check(Dune::Python::mdspanView<const double,2>(c).extent(1) == 3, "mdspan view on array with equal dtype");
+
+    for (const char* other : {">f8", "float32", "int64"})
+    {
+      thrown = false;
+      try {
+        Dune::Python::mdspanView<double,2>(numpy.attr("zeros")(pybind11::make_tuple(2, 3), other));
+      } catch (const pybind11::value_error&) {
+        thrown = true;
+      }
+      suite.check(thrown, std::string("array of dtype ") + other + " is rejected");
+    }
+  }
+
+  return suite.exit();
+}
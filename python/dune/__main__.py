@@ -4,7 +4,7 @@
 import sys
 from argparse import ArgumentParser
 from dune.commands import ( printinfo, configure, listgenerated,
-                            rmgenerated, makegenerated,
+                            rmgenerated, makegenerated, cachegenerated,
                             fixdunepy, listdunetype, checkbuilddirs
                           )
 
@@ -55,6 +55,11 @@ def run(arguments=None):
     parserMake.add_argument('modules', nargs='*',  default=[],
               help='Patterns of modules ("*.cc" and dune-py path is added to each argument) or "all"')
 
+    # cache
+    parserCache = subparsers.add_parser('cache', help='Store compiled modules in the module cache given by DUNE_PY_CACHE, set CXXFLAGS to the flags they were compiled with')
+    parserCache.add_argument('modules', nargs='*',  default=[],
+              help='Patterns of modules ("*.so" and dune-py path is added to each argument) or "all" (default)')
+
     # Fix dune-py
     parserFix = subparsers.add_parser('fix-dunepy',
               help='Find inconsistencies in dune-py and try to fix automatically. This will potentially delete all generated modules.')
@@ -98,6 +103,9 @@ def run(arguments=None):
                                 force=(args.force or args.bforce),
                                 verbose=args.verbose)
 
+    elif args.command == 'cache':
+        ret = cachegenerated(args.modules)
+
     elif args.command == 'fix-dunepy':
         ret = fixdunepy(args.force)
 
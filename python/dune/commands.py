@@ -59,6 +59,10 @@ def makegenerated(args=[], fileName=None, threads=4, force=False, verbose=False)
     makeGenerated(args, fileName, threads, force, verbose)
     return 0
 
+def cachegenerated(args=[]):
+    from dune.generator.cache import storeGenerated
+    return storeGenerated(args)
+
 def fixdunepy(force):
     from dune.common.module import getDunePyDir
     from dune.generator.remove import removeGenerated
@@ -101,6 +101,52 @@ def FieldVector(values):
         globals().update({fv: cls})
     return globals()[fv](values)
 
+def _loadArray(name, typeName):
+    from dune.generator.generator import SimpleGenerator
+    from dune.common.hashit import hashIt
+    try:
+        # try pre-compiled version from _common
+        return globals()[name]
+    except KeyError:
+        pass
+    className = name.split('_')[0]
+    generator = SimpleGenerator(className, "Dune::Python")
+    typeHash = className.lower() + "_" + hashIt(typeName)
+    cls = getattr(generator.load(["dune/python/common/numpyview.hh"], typeName, typeHash,
+                                 bufferProtocol=True), className)
+    globals().update({name: cls})
+    return cls
+
+
+def FieldVectorArray(values):
+    """Construct a contiguous array of FieldVectors from an (N,n) array
+
+    The values are copied once in C++. `numpy.asarray` on the result returns
+    an (N,n) array sharing its memory.
+    """
+    values = np.asarray(values, dtype=np.float64)
+    if values.ndim != 2:
+        raise ValueError("FieldVectorArray requires a two-dimensional array")
+    n = values.shape[1]
+    cls = _loadArray("FieldVectorArray_double_" + str(n),
+                     "Dune::Python::FieldVectorArray< double, " + str(n) + " >")
+    return cls(values)
+
+
+def FieldMatrixArray(values):
+    """Construct a contiguous array of FieldMatrices from an (N,m,n) array
+
+    The values are copied once in C++. `numpy.asarray` on the result returns
+    an (N,m,n) array sharing its memory.
+    """
+    values = np.asarray(values, dtype=np.float64)
+    if values.ndim != 3:
+        raise ValueError("FieldMatrixArray requires a three-dimensional array")
+    m, n = values.shape[1:]
+    cls = _loadArray("FieldMatrixArray_double_" + str(m) + "_" + str(n),
+                     "Dune::Python::FieldMatrixArray< double, " + str(m) + ", " + str(n) + " >")
+    return cls(values)
+
 # implementation needs to be completed similar to the FV above
 # def FieldMatrix(values):
 #     fm = "FieldMatrix_" + str(len(values)) + "_" + str(len(values[0]))
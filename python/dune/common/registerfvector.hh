@@ -8,6 +8,7 @@
 
 #include <dune/python/common/fmatrix.hh>
 #include <dune/python/common/fvector.hh>
+#include <dune/python/common/numpyview.hh>
 
 #include <dune/python/pybind11/pybind11.h>
 #include <dune/python/pybind11/stl.h>
@@ -20,6 +21,16 @@ void registerFieldVectorToModule( pybind11::module module )
   Dune::Python::registerFieldVector<double, a>(module);
   Dune::Python::registerFieldVector<double, a+1>(module);
   Dune::Python::registerFieldVector<double, a+2>(module);
+
+  if constexpr (a > 0)
+    Dune::Python::registerFieldVectorArray<double, a>(module);
+  Dune::Python::registerFieldVectorArray<double, a+1>(module);
+  Dune::Python::registerFieldVectorArray<double, a+2>(module);
+  if constexpr (s == 0)
+  {
+    Dune::Python::registerFieldMatrixArray<double, 2, 2>(module);
+    Dune::Python::registerFieldMatrixArray<double, 3, 3>(module);
+  }
 }
 #else
 ;
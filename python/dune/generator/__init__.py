@@ -64,6 +64,37 @@ def reset():
     unsetFlags()
     setDependencyCheck()
 
+class deferredBuild:
+    """Context manager collecting generated modules and building them in one batch
+
+    Inside the context `builder.load` returns placeholders for modules that
+    still need compiling. On leaving the context (or on first use of one of
+    the placeholders) all pending modules are generated, dune-py is
+    configured once and the modules are compiled in parallel:
+
+        with dune.generator.deferredBuild():
+            spaces = [lagrange(view, order=k) for k in range(1,5)]
+
+    The number of parallel jobs is taken from `DUNE_BUILD_JOBS`. With
+    `distribute=True` (or `DUNE_DISTRIBUTE_BUILD=1`) the compilation is
+    distributed across all MPI ranks. Must be used on all ranks.
+    """
+    def __init__(self, distribute=None):
+        self.distribute = distribute
+    def __enter__(self):
+        self.previous = builder.deferred
+        builder.deferred = True
+        return builder
+    def __exit__(self, exc_type, exc_value, traceback):
+        builder.deferred = self.previous
+        if exc_type is None and not builder.deferred:
+            builder.buildPending(self.distribute)
+        return False
+
+def buildPending(distribute=None):
+    """Build all modules collected inside a `deferredBuild` context"""
+    return builder.buildPending(distribute)
+
 def path(f):
     return os.path.dirname(os.path.realpath(f))+"/"
 
@@ -0,0 +1,84 @@
+# SPDX-FileCopyrightInfo: Copyright © DUNE Project contributors, see file LICENSE.md in module root
+# SPDX-License-Identifier: LicenseRef-GPL-2.0-only-with-DUNE-exception
+
+""" Startup time benchmark for the JIT compilation of dune-py modules
+
+    Generates a number of small, new modules and compiles them once one at a
+    time and once as a batch using `deferredBuild`. Run as
+
+        python -m dune.generator.buildbenchmark [-n modules] [-j jobs] [-u size] [--distribute]
+
+    The option `-u` combines up to `size` modules into one translation unit
+    in the batch build. Precompiled headers are used if dune-py was
+    configured with `DUNE_PY_PRECOMPILE_HEADERS=1`. The modules are removed
+    from dune-py afterwards.
+"""
+
+import os
+import random
+import time
+from argparse import ArgumentParser
+
+from dune.common import comm
+from dune.generator import builder, deferredBuild
+from dune.generator.remove import removeGenerated
+
+def _source(moduleName, k):
+    source  = '#include <config.h>\n'
+    source += '#include <dune/common/fvector.hh>\n'
+    source += '#include <dune/python/pybind11/pybind11.h>\n\n'
+    source += 'PYBIND11_MODULE( ' + moduleName + ', module )\n'
+    source += '{\n'
+    source += '  module.def( "run", [] () { return Dune::FieldVector<double,' + str(k) + '>(1.0).two_norm2(); } );\n'
+    source += '}\n'
+    return source
+
+def _modules(prefix, n):
+    return [(prefix + '_' + str(k), 'buildbenchmark' + str(k)) for k in range(1, n+1)]
+
+def run(n=8, jobs=None, distribute=None, unity=None):
+    if jobs is not None:
+        os.environ['DUNE_BUILD_JOBS'] = str(jobs)
+    if unity is not None:
+        os.environ['DUNE_PY_UNITY_BUILD'] = str(unity)
+    builder.initialize()
+    # unique module names, identical on all ranks
+    tag = float(random.randrange(2**31))
+    tag = '{:08x}'.format(int(comm.broadcast(tag, 0)))
+    sequentialPrefix = 'buildbenchmark_seq_' + tag
+    batchPrefix = 'buildbenchmark_batch_' + tag
+
+    try:
+        start = time.time()
+        for k, (moduleName, pythonName) in enumerate(_modules(sequentialPrefix, n), 1):
+            assert builder.load(moduleName, _source(moduleName, k), pythonName).run() == k
+        sequential = time.time() - start
+
+        start = time.time()
+        with deferredBuild(distribute):
+            modules = [builder.load(moduleName, _source(moduleName, k), pythonName)
+                       for k, (moduleName, pythonName) in enumerate(_modules(batchPrefix, n), 1)]
+        for k, module in enumerate(modules, 1):
+            assert module.run() == k
+        batch = time.time() - start
+    finally:
+        comm.barrier()
+        if comm.rank == 0:
+            removeGenerated([sequentialPrefix, batchPrefix])
+
+    if comm.rank == 0:
+        print(f"modules: {n}, jobs: {os.environ.get('DUNE_BUILD_JOBS', os.cpu_count())}, "
+              f"unity size: {os.environ.get('DUNE_PY_UNITY_BUILD', 1)}, ranks: {comm.size}")
+        print(f"one at a time: {sequential:8.2f}s ({sequential/n:6.2f}s per module)")
+        print(f"batch:         {batch:8.2f}s ({batch/n:6.2f}s per module, speedup {sequential/batch:.2f})")
+    return sequential, batch
+
+if __name__ == '__main__':
+    parser = ArgumentParser(description='Compare sequential and batch compilation of generated modules')
+    parser.add_argument('-n', dest='n', type=int, default=8, help='number of modules to generate')
+    parser.add_argument('-j', dest='jobs', type=int, default=None, help='number of parallel build jobs')
+    parser.add_argument('-u', dest='unity', type=int, default=None, help='number of modules per unity translation unit')
+    parser.add_argument('--distribute', dest='distribute', action='store_const', const=True, default=None,
+                        help='distribute compilation across MPI ranks')
+    args = parser.parse_args()
+    run(args.n, args.jobs, args.distribute, args.unity)
@@ -0,0 +1,259 @@
+# SPDX-FileCopyrightInfo: Copyright © DUNE Project contributors, see file LICENSE.md in module root
+# SPDX-License-Identifier: LicenseRef-GPL-2.0-only-with-DUNE-exception
+
+""" Content-addressed cache for compiled dune-py modules
+
+    Compiled modules are stored under a key computed from the module source,
+    the compiler command including all flags and the versions of the dune
+    packages dune-py depends on. Paths pointing into the dune-py directory are
+    removed before hashing so that the same entry can be used by all dune-py
+    directories sharing an installation, e.g. by different users or on
+    different compute nodes of a cluster.
+
+    The cache directories are given by the environment variable
+    `DUNE_PY_CACHE` (separated by `os.pathsep`). All directories are searched
+    for existing modules, newly compiled modules are stored in the first
+    writable directory unless `DUNE_PY_CACHE_READONLY` is set. A cache can be
+    populated ahead of time by running a script once with `DUNE_PY_CACHE`
+    set or with `python -m dune cache` for already compiled modules.
+
+    The dependency file written by the compiler is stored with each module,
+    together with a hash of the contents of all headers it lists. A module is
+    only taken from the cache if these headers are unchanged, and only when it
+    is built for the first time in a dune-py directory; later builds are left
+    to make, which uses the restored dependency file.
+"""
+
+import hashlib
+import importlib.metadata
+import json
+import logging
+import os
+import platform
+import shutil
+import sysconfig
+
+from dune.packagemetadata import getBuildMetaData
+
+logger = logging.getLogger(__name__)
+
+def getCacheDirs():
+    """Return the list of cache directories taken from `DUNE_PY_CACHE`"""
+    return [d for d in os.environ.get('DUNE_PY_CACHE', '').split(os.pathsep) if d]
+
+def _compilerFlags(cxxFlags):
+    """Flags the compiler launcher of dune-py uses in addition to the build script
+
+    `cxxFlags` are the flags set for the builder (`dune.generator.setFlags`),
+    which replace `CXXFLAGS` from the environment.
+    """
+    if cxxFlags is None:
+        cxxFlags = os.environ.get('CXXFLAGS', '')
+    return cxxFlags + '\0' + os.environ.get('EXTRA_CXXFLAGS', '')
+
+def _packageVersions():
+    """Versions of all dune modules dune-py depends on"""
+    metaData = getBuildMetaData()
+    versions = {}
+    for modules in metaData.combine_across_modules("DEPS") + list(metaData.keys()):
+        for m in modules.split(" "):
+            if not m or m in versions:
+                continue
+            try:
+                versions[m] = importlib.metadata.version(m)
+            except importlib.metadata.PackageNotFoundError:
+                versions[m] = ""
+    return versions
+
+class ModuleCache:
+    """Content-addressed store of compiled modules shared between dune-py directories"""
+
+    def __init__(self, dune_py_dir, dirs=None):
+        self.dune_py_dir = dune_py_dir
+        self.generated_dir = os.path.join(dune_py_dir, 'python', 'dune', 'generated')
+        self.dirs = getCacheDirs() if dirs is None else list(dirs)
+        self.readOnly = os.environ.get('DUNE_PY_CACHE_READONLY', 'FALSE').upper() in ('1', 'TRUE')
+        self._environment = None
+        self._buildScriptStat = None
+
+    def __bool__(self):
+        return len(self.dirs) > 0
+
+    def _environmentHash(self):
+        # the build script contains compiler, flags and link command and
+        # changes whenever dune-py is reconfigured
+        buildScript = os.path.join(self.generated_dir, 'buildScript.sh')
+        try:
+            stat = os.stat(buildScript)
+            stat = (stat.st_mtime_ns, stat.st_size)
+        except FileNotFoundError:
+            stat = None
+        if self._environment is None or stat != self._buildScriptStat:
+            env = hashlib.sha256()
+            if stat is not None:
+                with open(buildScript, 'r') as f:
+                    env.update(f.read().replace(self.dune_py_dir, '@DUNE_PY_DIR@').encode('utf-8'))
+            env.update(json.dumps(getBuildMetaData(), sort_keys=True).encode('utf-8'))
+            env.update(json.dumps(_packageVersions(), sort_keys=True).encode('utf-8'))
+            env.update(str(sysconfig.get_config_var('EXT_SUFFIX')).encode('utf-8'))
+            env.update(platform.machine().encode('utf-8'))
+            self._environment = env.hexdigest()
+            self._buildScriptStat = stat
+        return self._environment
+
+    def key(self, moduleName, cxxFlags=None):
+        """Key of a module computed from its generated source file and the build environment"""
+        with open(os.path.join(self.generated_dir, moduleName + '.cc'), 'rb') as f:
+            source = f.read()
+        key = hashlib.sha256(source)
+        key.update(self._environmentHash().encode('utf-8'))
+        key.update(_compilerFlags(cxxFlags).encode('utf-8'))
+        return key.hexdigest()
+
+    def _entry(self, cacheDir, key):
+        return os.path.join(cacheDir, key[:2], key + '.so')
+
+    def _objectFile(self, moduleName):
+        return os.path.join(self.generated_dir, 'CMakeFiles', moduleName + '.dir', moduleName + '.cc.o')
+
+    def _dependencyHash(self, depFile):
+        """Hash of the names and contents of all files listed in a dependency file, None if one is missing"""
+        # the first rule lists the dependencies of the object file
+        rule = depFile.replace('\\\n', ' ').split('\n', 1)[0]
+        _, _, deps = rule.partition(':')
+        depHash = hashlib.sha256()
+        for dep in deps.split():
+            try:
+                with open(os.path.join(self.generated_dir, dep), 'rb') as f:
+                    content = f.read()
+            except OSError:
+                return None
+            depHash.update(dep.replace(self.dune_py_dir, '@DUNE_PY_DIR@').encode('utf-8'))
+            depHash.update(hashlib.sha256(content).digest())
+        return depHash.hexdigest()
+
+    def fetch(self, moduleName, cxxFlags=None):
+        """Copy a cached module into dune-py, returns False if it is not cached
+
+        Only used for the first build of a module, i.e., if there is neither
+        an object file nor a dependency file yet.
+        """
+        if not self.dirs:
+            return False
+        objFile = self._objectFile(moduleName)
+        if os.path.exists(objFile) or os.path.exists(objFile + '.d'):
+            return False
+        key = self.key(moduleName, cxxFlags)
+        for cacheDir in self.dirs:
+            entry = self._entry(cacheDir, key)
+            try:
+                with open(os.path.splitext(entry)[0] + '.json', 'r') as f:
+                    meta = json.load(f)
+            except (OSError, ValueError):
+                continue
+            if not os.path.isfile(entry):
+                continue
+            depFile = meta['depfile'].replace('@DUNE_PY_DIR@', self.dune_py_dir)
+            if self._dependencyHash(depFile) != meta['dependencies']:
+                continue
+            # the object file is only a stamp, make compares its time with
+            # the dependencies and rebuilds the module once one of them changes
+            os.makedirs(os.path.dirname(objFile), exist_ok=True)
+            with open(objFile + '.d', 'w') as f:
+                f.write(depFile)
+            with open(objFile, 'w'):
+                pass
+            _atomicCopy(entry, os.path.join(self.generated_dir, moduleName + '.so'))
+            logger.debug(f"Loaded {moduleName} from cache {cacheDir}")
+            return True
+        return False
+
+    def store(self, moduleName, cxxFlags=None):
+        """Store a compiled module of dune-py, returns False if no writable cache exists"""
+        if not self.dirs or self.readOnly:
+            return False
+        soFile = os.path.join(self.generated_dir, moduleName + '.so')
+        if not os.path.isfile(soFile):
+            return False
+        try:
+            with open(self._objectFile(moduleName) + '.d', 'r') as f:
+                depFile = f.read()
+        except OSError:
+            return False
+        dependencies = self._dependencyHash(depFile)
+        if dependencies is None:
+            return False
+        meta = json.dumps({'depfile': depFile.replace(self.dune_py_dir, '@DUNE_PY_DIR@'),
+                           'dependencies': dependencies})
+        key = self.key(moduleName, cxxFlags)
+        for cacheDir in self.dirs:
+            entry = self._entry(cacheDir, key)
+            if os.path.isfile(entry):
+                return True
+            try:
+                os.makedirs(os.path.dirname(entry), exist_ok=True)
+                # the module is written last, fetch requires both files
+                _atomicWrite(meta, os.path.splitext(entry)[0] + '.json')
+                _atomicCopy(soFile, entry)
+            except OSError:
+                continue # not writable - try next directory
+            logger.debug(f"Stored {moduleName} in cache {cacheDir}")
+            return True
+        return False
+
+def _atomicCopy(source, target):
+    # copy to a temporary file first so that concurrent readers never see
+    # a partially written module
+    tmp = target + '.' + platform.node() + '.' + str(os.getpid()) + '.tmp'
+    try:
+        shutil.copyfile(source, tmp)
+        os.chmod(tmp, 0o755)
+        os.replace(tmp, target)
+    finally:
+        if os.path.exists(tmp):
+            os.remove(tmp)
+
+def _atomicWrite(text, target):
+    tmp = target + '.' + platform.node() + '.' + str(os.getpid()) + '.tmp'
+    try:
+        with open(tmp, 'w') as f:
+            f.write(text)
+        os.replace(tmp, target)
+    finally:
+        if os.path.exists(tmp):
+            os.remove(tmp)
+
+def storeGenerated(modules, cxxFlags=None):
+    """Store already compiled modules of dune-py in the cache (`python -m dune cache`)
+
+    The modules are stored under the flags the builder currently uses, i.e.,
+    `cxxFlags` if given and otherwise the flags set for the builder or
+    `CXXFLAGS` from the environment.
+    """
+    import glob
+    from dune.common.module import getDunePyDir
+    if cxxFlags is None:
+        from dune.generator import cmakebuilder
+        cxxFlags = cmakebuilder.cxxFlags
+    cache = ModuleCache(getDunePyDir())
+    if not cache:
+        print("No cache directory given - set DUNE_PY_CACHE")
+        return 1
+    if 'all' in modules or len(modules) == 0:
+        modules = ['']
+    bases = set()
+    for m in modules:
+        bases.update(os.path.splitext(os.path.basename(f))[0]
+                     for f in glob.glob(os.path.join(cache.generated_dir, m + '*.so')))
+    stored = 0
+    for base in sorted(bases):
+        if not os.path.isfile(os.path.join(cache.generated_dir, base + '.cc')):
+            continue
+        # only store modules that are up to date with their source
+        if os.path.getmtime(os.path.join(cache.generated_dir, base + '.so')) < \
+           os.path.getmtime(os.path.join(cache.generated_dir, base + '.cc')):
+            continue
+        if cache.store(base, cxxFlags):
+            stored += 1
+    print(f"Stored {stored} modules in {cache.dirs}")
+    return 0
@@ -1,15 +1,19 @@
 # SPDX-FileCopyrightInfo: Copyright © DUNE Project contributors, see file LICENSE.md in module root
 # SPDX-License-Identifier: LicenseRef-GPL-2.0-only-with-DUNE-exception
 
+import errno
 import importlib
 import logging
 import subprocess
 import os
 import sys
 import shlex
+import shutil
 import jinja2
 import json
 import copy
+from contextlib import ExitStack
+from concurrent.futures import ThreadPoolExecutor
 from pathlib import Path
 
 import dune
@@ -21,9 +25,11 @@ from dune.packagemetadata import (
 )
 
 from dune.common import comm
+from dune.common.hashit import hashIt
 from dune.common.locking import Lock, LOCK_EX, LOCK_SH
 from dune.common.utility import buffer_to_str, isString, reload_module
 
+from dune.generator.cache import ModuleCache
 from dune.generator.exceptions import CompileError
 from dune.generator.remove import removeGenerated
 
@@ -32,6 +38,10 @@ logging.basicConfig(format='%(levelname)s:%(message)s', level=logging.INFO)
 
 cxxFlags = None
 noDepCheck = False
+# precompile the common headers of all generated modules (requires a reconfiguration of dune-py)
+precompileHeaders = os.environ.get('DUNE_PY_PRECOMPILE_HEADERS', 'FALSE').upper() in ('1', 'TRUE')
+# distribute the compilation of deferred modules across all MPI ranks
+distributeBuild = os.environ.get('DUNE_DISTRIBUTE_BUILD', 'FALSE').upper() in ('1', 'TRUE')
 
 moduleLogFile = None
 def setModuleLog( fileName=None, procs=4 ):
@@ -77,6 +87,57 @@ def getDefaultBuildArgs():
         return None
 
 
+def getBuildJobs():
+    """Number of modules compiled in parallel when building deferred modules
+
+    Taken from the environment variable `DUNE_BUILD_JOBS`, defaults to the number of cores.
+    """
+    try:
+        return max(1, int(os.environ['DUNE_BUILD_JOBS']))
+    except (KeyError, ValueError):
+        return os.cpu_count() or 1
+
+
+def getUnitySize():
+    """Number of new modules combined into one translation unit when building deferred modules
+
+    Taken from the environment variable `DUNE_PY_UNITY_BUILD`, defaults to 1 (no unity builds).
+    """
+    try:
+        return max(1, int(os.environ['DUNE_PY_UNITY_BUILD']))
+    except (KeyError, ValueError):
+        return 1
+
+
+class DeferredModule:
+    """Placeholder returned by `Builder.load` while building is deferred
+
+    The first attribute access builds all pending modules (this is collective
+    if MPI is used) and forwards to the compiled module afterwards.
+    """
+    def __init__(self, builder, moduleName):
+        object.__setattr__(self, "_builder", builder)
+        object.__setattr__(self, "_moduleName", moduleName)
+        object.__setattr__(self, "_module", None)
+
+    def _resolve(self):
+        if self._module is None:
+            self._builder.buildPending()
+            object.__setattr__(self, "_module", importlib.import_module("dune.generated." + self._moduleName))
+        return self._module
+
+    def __getattr__(self, name):
+        return getattr(self._resolve(), name)
+
+    def __setattr__(self, name, value):
+        setattr(self._resolve(), name, value)
+
+    def __repr__(self):
+        if self._module is None:
+            return f"<deferred module 'dune.generated.{self._moduleName}'>"
+        return repr(self._module)
+
+
 class Builder:
 
     @staticmethod
@@ -124,6 +185,7 @@ class Builder:
             # modules moved from build to install or vice versa - or tag that some other way
             # For now we simply always force a rebuild of the dune-py
             # module which might lead to more work than required
+            # (with DUNE_PY_CACHE set unchanged modules are restored from the cache)
             force = True
         else:
             force = True
@@ -145,6 +207,7 @@ class Builder:
             context["install_prefix"] = metaData.unique_value_across_modules("INSTALL_PREFIX")
             context["cmake_flags"]    = getCMakeFlags().copy()
             context["dunepy_dir"]     = dunepy_dir
+            context["precompile_headers"] = precompileHeaders
 
             # to use the default launcher we move the CMAKE_CXX_FLAGS to DEFAULT_CXXFLAGS
             # to get the compile command without CXX_FLAGS we then remove them
@@ -210,8 +273,75 @@ class Builder:
                               infoTxt="Configuring dune-py with CMake",
                               active=True, # print details anyway
                               )
+            Builder.writeCompileScript(dunepy_dir)
         return force
 
+    # name of the script compiling and linking a module without CMake
+    compileScriptName = 'compileModule.sh'
+
+    @staticmethod
+    def writeCompileScript(dunepy_dir):
+        """Write a script building a generated module with a single compiler call
+
+        The compile and link command of the `extractCompiler` target of the
+        configured dune-py are merged into one command template, so that new
+        modules can be built without adding a target and reconfiguring dune-py.
+        If extracting the commands fails no script is written and all modules
+        are built through CMake.
+        """
+        generatedDir = os.path.join(dunepy_dir, 'python', 'dune', 'generated')
+        scriptName = os.path.join(generatedDir, Builder.compileScriptName)
+        try:
+            os.remove(scriptName)
+        except FileNotFoundError:
+            pass
+        try:
+            Builder.callCMake(["cmake", "--build", ".", "--target", "extractCompiler"],
+                              cwd=dunepy_dir,
+                              infoTxt="extract compiler command",
+                              )
+            with open(os.path.join(dunepy_dir, 'compile_commands.json')) as commandFile:
+                entry = next(c for c in json.load(commandFile) if c["file"].endswith("extractCompiler.cc"))
+            with open(os.path.join(generatedDir, 'CMakeFiles', 'extractCompiler.dir', 'link.txt')) as linkFile:
+                linkCmd = linkFile.read()
+        except (CompileError, OSError, KeyError, StopIteration) as e:
+            logger.debug("Extracting compiler command failed, new modules are configured with CMake: " + str(e))
+            return
+
+        compileCmd = entry["command"] if "command" in entry else shlex.join(entry["arguments"])
+        # the CXXFLAGS are added by the compiler launcher
+        cxxflags = getCMakeFlags().get("CMAKE_CXX_FLAGS", "").strip()
+        if cxxflags:
+            compileCmd = compileCmd.replace(" " + cxxflags + " ", " ", 1)
+
+        def strip(tokens, skip):
+            # remove output file and the extractCompiler input
+            args, it = [], iter(tokens)
+            for t in it:
+                if t == "-o":
+                    next(it, None)
+                elif not (t in skip or t.endswith(("extractCompiler.cc", "extractCompiler.cc.o"))):
+                    args.append(t)
+            return args
+        compileArgs = strip(shlex.split(compileCmd), ("-c",))
+        linkArgs = strip(shlex.split(linkCmd)[1:], ())
+
+        launcher = getCMakeFlags().get('CMAKE_CXX_COMPILER_LAUNCHER',
+                       os.path.join(dunepy_dir, "compiler_launcher.sh"))
+        with open(scriptName, "w") as script:
+            script.write("#!/bin/bash\n")
+            script.write("set -e\n")
+            script.write('if [ "$DUNE_CXX_COMPILER_LAUNCHER" == "" ]; then\n')
+            script.write(' DUNE_CXX_COMPILER_LAUNCHER=' + launcher + '\n')
+            script.write('fi\n')
+            script.write('mkdir -p CMakeFiles/$1.dir\n')
+            # compile and link in one call, the dependency file is used to
+            # check whether the module is up to date
+            script.write("$DUNE_CXX_COMPILER_LAUNCHER " + shlex.join(compileArgs) +
+                         " $1.cc -o $1.so -MD -MT $1.so -MF CMakeFiles/$1.dir/$1.so.d " +
+                         shlex.join(linkArgs) + "\n")
+            os.fsync(script) # make sure files are correctly synced before calling the script
+
     def __init__(self, force=False, saveOutput=False):
         self.force = force
         self.skipTargetAll = False
@@ -232,6 +362,9 @@ class Builder:
         self.generated_dir = os.path.join(self.dune_py_dir, 'python', 'dune', 'generated')
         self.initialized = False
         self.externalPythonModules = copy.deepcopy(getExternalPythonModules())
+        # modules collected by `load` while building is deferred
+        self.deferred = False
+        self.pending = {}
 
     def cacheExternalModules(self):
         """Store external modules in dune-py"""
@@ -317,13 +450,17 @@ class Builder:
 
         return stdout, stderr
 
-    def _compile(self, infoTxt, target='all', verbose=False):
+    def _compile(self, infoTxt, target='all', verbose=False, jobs=None):
         # if called for other builders don't do anything here
         assert isinstance(self, Builder)
 
+        # several targets can be given as a list and are built in one call
+        targets = [target] if isString(target) else list(target)
         cmake_command = getCMakeCommand()
         cmake_args = [cmake_command, "--build", self.dune_py_dir,
-                      "--target", target, "--parallel"]
+                      "--target"] + targets + ["--parallel"]
+        if jobs is not None:
+            cmake_args += [str(jobs)]
         make_args = []
         if self.build_args is not None:
             make_args += self.build_args
@@ -367,7 +504,7 @@ class Builder:
     def compile(self, infoTxt, target='all', verbose=False):
         return self._compile(infoTxt, target=target, verbose=verbose)
 
-    def _maybeConfigureWithCMake(self, moduleName, source, pythonName, extraCMake):
+    def _maybeConfigureWithCMake(self, moduleName, source, pythonName, extraCMake, configure=True):
         sourceFileName = os.path.join(self.generated_dir, moduleName + ".cc")
         line = "dune_add_pybind11_module(NAME " + moduleName + " EXCLUDE_FROM_ALL)"
         # first check if this line is already present in the CMakeLists file
@@ -389,7 +526,10 @@ class Builder:
                     if extraCMake is not None:
                         for x in extraCMake:
                             out.write(x.replace("TARGET",moduleName)+"\n")
-                # update build system
+                # update build system - when building a batch of modules
+                # this is done once by the caller after all modules were added
+                if not configure:
+                    return compilationInfoMessage
                 try:
                     Builder.callCMake(["cmake","."],
                                       cwd=self.dune_py_dir,
@@ -425,6 +565,12 @@ class Builder:
         if pythonName is None:
             pythonName = moduleName
 
+        # while building is deferred only collect the module, it is built
+        # together with all other pending modules on first use
+        if self.deferred and sys.modules.get("dune.generated." + moduleName) is None:
+            self.pending.setdefault(moduleName, (source, pythonName, extraCMake))
+            return DeferredModule(self, moduleName)
+
         # only try to build module on rank 0!, setModuleLog also calls build
         # which sets some barriers
         moduleFile = setModuleLog()
@@ -455,8 +601,143 @@ class Builder:
 
         return module
 
+    def buildPending(self, distribute=None):
+        """Build all modules collected by `load` while building was deferred
+
+        The modules are generated first and then compiled together using
+        `getBuildJobs()` parallel jobs. With `distribute=True` (default taken
+        from `DUNE_DISTRIBUTE_BUILD`) the modules are split between all MPI
+        ranks if the builder supports this. Must be called on all ranks.
+
+        Returns the list of loaded modules.
+        """
+        if not self.pending:
+            return []
+        self.initialize()
+        pending, self.pending = self.pending, {}
+        if distribute is None:
+            distribute = distributeBuild
+
+        moduleFile = setModuleLog()
+        todo = [(name,) + args for name, args in pending.items()
+                if sys.modules.get("dune.generated." + name) is None]
+        if distribute and self.distributedBuild:
+            todo = todo[comm.rank::comm.size]
+        elif comm.rank != 0:
+            todo = []
+        if comm.rank == 0 and moduleFile:
+            with open( moduleFile, 'a' ) as file:
+                file.write(''.join(name + '\n' for name in pending))
+        if todo:
+            self._buildModules(todo)
+
+        comm.barrier()
+
+        modules = []
+        for name, (_, pythonName, _) in pending.items():
+            logger.debug("Loading " + name)
+            module = importlib.import_module("dune.generated." + name)
+            if self.force:
+                logger.info("Reloading " + pythonName)
+                module = reload_module(module)
+            modules.append(module)
+        return modules
+
+    # the CMake based builder reconfigures dune-py and can only build on one rank
+    distributedBuild = False
+
+    def _buildModules(self, modules):
+        """Generate a batch of modules, configure CMake once and build all targets in one call"""
+        # modules not needing a CMake target are built directly and concurrently
+        direct = [m for m in modules if self._canBuildDirectly(m[0], m[3])]
+        modules = [m for m in modules if m not in direct]
+        if direct:
+            with ThreadPoolExecutor(max_workers=min(getBuildJobs(), len(direct))) as executor:
+                for _ in executor.map(lambda m: self._buildModuleDirectly(*m[:3]), direct):
+                    pass
+        if not modules:
+            return
+
+        cmakeLists = os.path.join(self.generated_dir, "CMakeLists.txt")
+        with Lock(os.path.join(self.dune_py_dir, '..', 'lock-module.lock'), flags=LOCK_EX):
+            with open(cmakeLists, 'r') as file:
+                oldTargets = file.read()
+            for moduleName, source, pythonName, extraCMake in modules:
+                with Lock(os.path.join(self.dune_py_dir, 'lock-'+moduleName+'.lock'), flags=LOCK_EX):
+                    self._maybeConfigureWithCMake(
+                        moduleName, source, pythonName, extraCMake, configure=False
+                    )
+            # only reconfigure if targets were added, changed sources are
+            # picked up by the build tool
+            with open(cmakeLists, 'r') as file:
+                newTargets = file.read()
+            if newTargets != oldTargets:
+                Builder.callCMake(["cmake","."],
+                                  cwd=self.dune_py_dir,
+                                  infoTxt="Configuring {} modules with CMake".format(len(modules)),
+                                  )
+
+        # build all targets with one parallel build tool invocation
+        targets = [m[0] for m in modules]
+        with Lock(os.path.join(self.dune_py_dir, '..', 'lock-module.lock'), flags=LOCK_SH):
+            self._compile(infoTxt="Compiling {} modules: {}".format(
+                              len(modules), ", ".join(m[2] for m in modules)),
+                          target=targets, jobs=getBuildJobs())
+
+    def _canBuildDirectly(self, moduleName, extraCMake):
+        # modules with extra CMake commands and modules that already have a
+        # CMake target are built through CMake
+        if extraCMake or not os.path.isfile(os.path.join(self.generated_dir, Builder.compileScriptName)):
+            return False
+        line = "dune_add_pybind11_module(NAME " + moduleName + " EXCLUDE_FROM_ALL)"
+        with open(os.path.join(self.generated_dir, "CMakeLists.txt"), 'r') as out:
+            return line not in out.read()
+
+    def _isUpToDate(self, moduleName):
+        # compare the module with the dependencies written by the compiler
+        soFileName = os.path.join(self.generated_dir, moduleName + ".so")
+        depFileName = os.path.join(self.generated_dir, "CMakeFiles", moduleName + ".dir", moduleName + ".so.d")
+        try:
+            soTime = os.path.getmtime(soFileName)
+            with open(depFileName, 'r') as depFile:
+                deps = depFile.read().replace("\\\n", " ").partition(":")[2].split()
+            return all(os.path.getmtime(os.path.join(self.generated_dir, d)) <= soTime for d in deps)
+        except OSError:
+            return False
+
+    def _buildModuleDirectly(self, moduleName, source, pythonName):
+        """Build a module with the compile script, i.e., without running CMake"""
+        with Lock(os.path.join(self.dune_py_dir, '..', 'lock-module.lock'), flags=LOCK_SH):
+            with Lock(os.path.join(self.dune_py_dir, 'lock-'+moduleName+'.lock'), flags=LOCK_EX):
+                sourceFileName = os.path.join(self.generated_dir, moduleName + ".cc")
+                if not os.path.isfile(sourceFileName):
+                    compilationMessage = f"Compiling {pythonName} (new)"
+                elif isString(source) and not source == open(sourceFileName, 'r').read():
+                    compilationMessage = f"Compiling {pythonName} (updated)"
+                elif noDepCheck or not self._isUpToDate(moduleName):
+                    compilationMessage = f"Compiling {pythonName} (rebuilding)"
+                    source = None
+                else:
+                    return
+                if source is not None:
+                    with open(sourceFileName, 'w') as out:
+                        out.write(str(source))
+
+                env = os.environ.copy()
+                if cxxFlags is not None:
+                    env['CXXFLAGS'] = cxxFlags
+                Builder.callCMake(["bash", Builder.compileScriptName, moduleName],
+                                  cwd=self.generated_dir,
+                                  infoTxt=compilationMessage,
+                                  logLevel=logging.INFO,
+                                  env=env,
+                                  )
+
     def _buildModule(self, moduleName, source, pythonName, extraCMake):
         logger.debug("Module {} not loaded".format(moduleName))
+        # new modules are compiled directly without reconfiguring dune-py
+        if self._canBuildDirectly(moduleName, extraCMake):
+            return self._buildModuleDirectly(moduleName, source, pythonName)
         # make sure nothing (compilation, generating and building) is taking place
         with Lock(os.path.join(self.dune_py_dir, '..', 'lock-module.lock'), flags=LOCK_EX):
             # module must be generated so lock the source file
@@ -592,6 +873,17 @@ class MakefileBuilder(Builder):
                 except CompileError:
                     deprecationMessage(dunepy_dir)
 
+                # the precompiled headers have to be built with the same flags
+                # as the modules, i.e., with the flags added by the launcher
+                if precompileHeaders:
+                    Builder.callCMake(["cmake"]+
+                                       ['--build','.','--target',"dunepy_pch"]+
+                                       ['--','-B'],
+                                       cwd=dunepy_dir,
+                                       infoTxt="Building precompiled headers",
+                                       active=True, # print details anyway
+                                     )
+
                 ########################################################################
                 #   Write buildScript.sh
                 ########################################################################
@@ -607,7 +899,9 @@ class MakefileBuilder(Builder):
                     buildScript.write("#!" + MakefileBuilder.bashCmd + "\n")
                     # write compiler commands
                     with open(commandSourceName) as commandFile:
-                        compilerCmd = json.load(commandFile)[0]["command"]
+                        # skip entries for precompiled headers
+                        compilerCmd = next(c for c in json.load(commandFile)
+                                           if c["file"].endswith("extractCompiler.cc"))["command"]
                     # replace target file
                     compilerCmd = compilerCmd.replace('extractCompiler', '$1')
                     # this line is extracted from build.make
@@ -682,6 +976,8 @@ class MakefileBuilder(Builder):
     def __init__(self, force=False, saveOutput=False):
         # call __init__ of base class
         super().__init__(force=force, saveOutput=saveOutput)
+        # shared cache of compiled modules (only used if DUNE_PY_CACHE is set)
+        self.cache = ModuleCache(self.dune_py_dir)
 
     # just added to check for old versions of dune-py - can be removed once
     # this check is not needed anymore
@@ -697,6 +993,96 @@ class MakefileBuilder(Builder):
     def compile(self, infoTxt, target='all', verbose=False):
         pass
 
+    # each module has its own makefile so modules can be built on different ranks
+    distributedBuild = True
+
+    def _buildModules(self, modules):
+        """Build a batch of modules with `getBuildJobs()` concurrent make calls"""
+        # new modules can be combined into unity translation units
+        unitySize = getUnitySize()
+        if unitySize > 1:
+            new = [m for m in modules
+                   if not os.path.isfile(os.path.join(self.generated_dir, m[0] + ".cc"))]
+            groups = [new[i:i+unitySize] for i in range(0, len(new), unitySize) if len(new[i:i+unitySize]) > 1]
+            if groups:
+                with ThreadPoolExecutor(max_workers=min(getBuildJobs(), len(groups))) as executor:
+                    built = [m for group in executor.map(self._buildUnity, groups) for m in group]
+                modules = [m for m in modules if m not in built]
+        if not modules:
+            return
+
+        def build(module):
+            self._buildModule(*module)
+        with ThreadPoolExecutor(max_workers=min(getBuildJobs(), len(modules))) as executor:
+            # using 'map' makes sure that compile errors are raised here
+            for _ in executor.map(build, modules):
+                pass
+
+    def _buildUnity(self, modules):
+        """Compile several new modules as one translation unit
+
+        The shared library is linked to the names of all modules. Returns the
+        list of modules built, which is empty if the combined compilation
+        failed (e.g. due to conflicting definitions) and the modules have to be
+        built separately.
+        """
+        unityName = "unity_" + hashIt([m[0] for m in modules])
+        unityBase = os.path.join(self.generated_dir, unityName)
+        unityDir = os.path.join(self.generated_dir, "CMakeFiles", unityName + ".dir")
+        with ExitStack() as locks:
+            locks.enter_context(Lock(os.path.join(self.dune_py_dir, '..', 'lock-module.lock'), flags=LOCK_SH))
+            for moduleName in sorted(m[0] for m in modules):
+                locks.enter_context(Lock(os.path.join(self.dune_py_dir, 'lock-'+moduleName+'.lock'), flags=LOCK_EX))
+
+            for moduleName, source, pythonName, _ in modules:
+                self._configureWithMake( moduleName, source, pythonName )
+            with open(unityBase + ".cc", "w") as unity:
+                unity.write("".join('#include "' + m[0] + '.cc"\n' for m in modules))
+            os.makedirs(unityDir, exist_ok=True)
+
+            makeEnv = os.environ.copy()
+            if cxxFlags is not None:
+                makeEnv['CXXFLAGS'] = cxxFlags
+            try:
+                Builder.callCMake([MakefileBuilder.bashCmd, "buildScript.sh", unityName],
+                                  cwd=self.generated_dir,
+                                  infoTxt="Compiling {} modules in one unit: {}".format(
+                                      len(modules), ", ".join(m[2] for m in modules)),
+                                  logLevel=logging.INFO,
+                                  env=makeEnv,
+                                  )
+                with open(os.path.join(unityDir, unityName + ".cc.o.d"), "r") as depFile:
+                    deps = depFile.read().replace("\\\n", " ").partition(":")[2].split()
+                deps = [d for d in deps if d != unityName + ".cc"]
+
+                soTime = os.path.getmtime(unityBase + ".so")
+                for moduleName, _, _, _ in modules:
+                    soFileName = os.path.join(self.generated_dir, moduleName + ".so")
+                    if os.path.exists(soFileName):
+                        os.remove(soFileName)
+                    try:
+                        os.link(unityBase + ".so", soFileName)
+                    except OSError:
+                        shutil.copyfile(unityBase + ".so", soFileName)
+                    # stamp object and dependency file so that make only
+                    # rebuilds the module separately once its dependencies change
+                    objFileName = os.path.join(self.generated_dir, "CMakeFiles", moduleName + ".dir", moduleName + ".cc.o")
+                    with open(objFileName + ".d", "w") as depFile:
+                        depFile.write(os.path.join("CMakeFiles", moduleName + ".dir", moduleName + ".cc.o") + ": " +
+                                      " \\\n  ".join(deps) + "\n")
+                    with open(objFileName, "w"):
+                        pass
+                    os.utime(objFileName, (soTime, soTime))
+            except (CompileError, OSError) as e:
+                logger.debug("Unity build failed, building modules separately: " + str(e))
+                return []
+            finally:
+                for f in (unityBase + ".cc", unityBase + ".so"):
+                    if os.path.exists(f):
+                        os.remove(f)
+                shutil.rmtree(unityDir, ignore_errors=True)
+        return modules
+
     # open and safely close source file and return content
     def _equalToExistingFile(self, source, sourceFileName ):
         with open(os.path.join(sourceFileName), 'r') as sFile:
@@ -787,11 +1173,18 @@ class MakefileBuilder(Builder):
                     # make sure directory entries are properly written to avoid raceconditions on network storage.
                     Builder.sync_dir(self.generated_dir)
 
+                # on the first build, a module with the same source, headers
+                # and build environment might have been compiled before,
+                # possibly by a different dune-py
+                if exit_code > 0 and not noDepCheck and self.cache.fetch( moduleName, cxxFlags ):
+                    exit_code = 0
+
                 if exit_code > 0 or noDepCheck:
                     # make sure directory entries are properly written to avoid raceconditions on network storage.
                     # Builder.sync_dir(self.generated_dir)
                     # call make to build shared library
                     self.makeModule( moduleName, makeFileName, compilationMessage, force=noDepCheck )
+                    self.cache.store( moduleName, cxxFlags )
 
     def _makeFileName( self, moduleName ):
         return os.path.join(self.generated_dir,"CMakeFiles",moduleName+'.dir',moduleName+'.make')
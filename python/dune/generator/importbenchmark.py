@@ -0,0 +1,95 @@
+# SPDX-FileCopyrightInfo: Copyright © DUNE Project contributors, see file LICENSE.md in module root
+# SPDX-License-Identifier: LicenseRef-GPL-2.0-only-with-DUNE-exception
+
+""" Import time benchmark for generated modules
+
+    Generates a number of modules, each exporting a number of new classes
+    through the type registry and registering the common FieldVector and
+    FieldMatrix types (which are then found in the registry). The modules are
+    compiled in one batch and imported in a fresh interpreter to measure the
+    import time. Run as
+
+        python -m dune.generator.importbenchmark [-n modules] [-c classes]
+
+    The modules are removed from dune-py afterwards.
+"""
+
+import random
+import subprocess
+import sys
+import time
+from argparse import ArgumentParser
+
+from dune.common import comm
+from dune.generator import builder, deferredBuild
+from dune.generator.remove import removeGenerated
+
+def _source(moduleName, classes):
+    source  = '#include <config.h>\n'
+    source += '#include <dune/python/common/fmatrix.hh>\n'
+    source += '#include <dune/python/common/fvector.hh>\n'
+    source += '#include <dune/python/common/typeregistry.hh>\n'
+    source += '#include <dune/python/pybind11/pybind11.h>\n\n'
+    for k in range(classes):
+        source += 'struct ' + moduleName + '_' + str(k) + ' { double value = ' + str(k) + '; };\n'
+    source += '\nPYBIND11_MODULE( ' + moduleName + ', module )\n'
+    source += '{\n'
+    source += '  pybind11::module common = pybind11::module::import( "dune.common" );\n'
+    for k in range(1, 4):
+        source += '  Dune::Python::registerFieldVector< double, ' + str(k) + ' >( common );\n'
+        source += '  Dune::Python::registerFieldMatrix< double, ' + str(k) + ', ' + str(k) + ' >( common );\n'
+    for k in range(classes):
+        name = moduleName + '_' + str(k)
+        source += '  {\n'
+        source += '    auto cls = Dune::Python::insertClass< ' + name + ' >( module, "Class' + str(k) + '",\n'
+        source += '        Dune::Python::GenerateTypeName( "' + name + '" ), Dune::Python::IncludeFiles{} ).first;\n'
+        source += '    cls.def( pybind11::init<>() );\n'
+        source += '    cls.def_readwrite( "value", &' + name + '::value );\n'
+        source += '  }\n'
+    source += '}\n'
+    return source
+
+_importScript = """
+import importlib, sys, time
+import dune.common
+start = time.time()
+for name in sys.argv[1:]:
+    importlib.import_module("dune.generated." + name)
+print(time.time() - start)
+"""
+
+def run(n=16, classes=32):
+    builder.initialize()
+    tag = float(random.randrange(2**31))
+    tag = '{:08x}'.format(int(comm.broadcast(tag, 0)))
+    prefix = 'importbenchmark_' + tag
+    moduleNames = [prefix + '_' + str(k) for k in range(n)]
+
+    try:
+        start = time.time()
+        with deferredBuild():
+            for moduleName in moduleNames:
+                builder.load(moduleName, _source(moduleName, classes), 'importbenchmark')
+        build = time.time() - start
+
+        if comm.rank == 0:
+            result = subprocess.run([sys.executable, '-c', _importScript] + moduleNames,
+                                    check=True, capture_output=True, text=True)
+            imported = float(result.stdout.split()[-1])
+    finally:
+        comm.barrier()
+        if comm.rank == 0:
+            removeGenerated([prefix])
+
+    if comm.rank == 0:
+        print(f"modules: {n}, classes per module: {classes}, build: {build:.2f}s")
+        print(f"import: {imported:8.4f}s ({1000*imported/n:8.2f}ms per module, "
+              f"{1e6*imported/(n*classes):8.2f}us per class)")
+        return imported
+
+if __name__ == '__main__':
+    parser = ArgumentParser(description='Measure the import time of generated modules')
+    parser.add_argument('-n', dest='n', type=int, default=16, help='number of modules to generate')
+    parser.add_argument('-c', dest='classes', type=int, default=32, help='number of classes per module')
+    args = parser.parse_args()
+    run(args.n, args.classes)